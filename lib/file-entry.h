@@ -16,7 +16,7 @@
 
 /*** structures declarations (and typedefs of structures)*****************************************/
 
-/* keys are set only during sorting */
+/* keys are created by sorting and kept until the entry is freed */
 typedef struct
 {
     // File name
@@ -13,6 +13,8 @@ typedef enum mc_search_cbret_t mc_search_cbret_t;
 
 typedef mc_search_cbret_t (*mc_search_fn) (const void *user_data, off_t char_offset,
                                            int *current_char);
+typedef mc_search_cbret_t (*mc_search_block_fn) (const void *user_data, off_t offset,
+                                                 const char **block, gsize *block_len);
 typedef mc_search_cbret_t (*mc_update_fn) (const void *user_data, off_t char_offset);
 
 #define MC_SEARCH__NUM_REPLACE_ARGS 64
@@ -84,6 +86,11 @@ typedef struct mc_search_struct
     // function, used for getting data. NULL if not used
     mc_search_fn search_fn;
 
+    /* function, used for getting contiguous blocks of data. NULL if not used.
+     * If set, it is preferred over search_fn. search_fn is still used where
+     * block_fn can't return data */
+    mc_search_block_fn block_fn;
+
     // function, used for updatin current search status. NULL if not used
     mc_update_fn update_fn;
 
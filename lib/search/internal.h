@@ -17,12 +17,15 @@ typedef enum
 
 /*** structures declarations (and typedefs of structures)*****************************************/
 
+typedef struct mc_search_literal_struct mc_search_literal_t;
+
 typedef struct mc_search_cond_struct
 {
     GString *str;
     GString *upper;
     GString *lower;
     GRegex *regex_handle;
+    mc_search_literal_t *literal;  // used instead of regex_handle for plain strings
     gchar *charset;
 } mc_search_cond_t;
 
@@ -47,6 +50,17 @@ gboolean mc_search__run_regex (mc_search_t *lc_mc_search, const void *user_data,
                                off_t end_search, gsize *found_len);
 GString *mc_search_regex_prepare_replace_str (mc_search_t *lc_mc_search, GString *replace_str);
 
+/* search/literal.c : */
+
+mc_search_literal_t *mc_search__literal_new (const char *charset, const mc_search_t *lc_mc_search,
+                                             const GString *str);
+void mc_search__literal_free (mc_search_literal_t *literal);
+gboolean mc_search__literal_find (const mc_search_literal_t *literal, const char *buf, gsize len,
+                                  gsize from, gsize *match_start, gsize *match_len);
+gboolean mc_search__is_literal (const mc_search_t *lc_mc_search);
+gboolean mc_search__run_literal (mc_search_t *lc_mc_search, const void *user_data,
+                                 off_t start_search, off_t end_search, gsize *found_len);
+
 /* search/normal.c : */
 
 void mc_search__cond_struct_new_init_normal (const char *charset, mc_search_t *lc_mc_search,
@@ -0,0 +1,722 @@
+/*
+   Search text engine.
+   Literal (fixed string) search
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Plain search strings don't need a regex engine. The pattern is kept as a sequence of byte
+ * pairs: at each position the text byte must be equal to one of two bytes (both are the same
+ * for case-sensitive search). Such pattern is searched using Boyer-Moore-Horspool algorithm;
+ * if no folding is required, candidate positions are found using memchr().
+ *
+ * Case-insensitive search of non-ASCII UTF-8 text can't be expressed as byte pairs because
+ * lower and upper case of the same character may have different length. In this case the text
+ * is decoded and compared character by character with the case-folded pattern.
+ */
+
+#include <config.h>
+
+#include <string.h>
+
+#include "lib/global.h"
+#include "lib/strutil.h"
+#include "lib/search.h"
+#include "lib/util.h"  // MC_PTR_FREE
+
+#include "internal.h"
+
+/*** global variables ****************************************************************************/
+
+/*** file scope macro definitions ****************************************************************/
+
+/* Longest UTF-8 character in bytes */
+#define UTF8_CHAR_LEN_MAX 4
+
+/* Characters above the first two planes have no case mappings */
+#define UNICHAR_CASED_MAX 0x1FFFF
+
+/*** file scope type declarations ****************************************************************/
+
+struct mc_search_literal_struct
+{
+    // pattern length in bytes
+    gsize len;
+    // at each position text byte must be equal to first[i] or second[i]
+    guchar *first;
+    guchar *second;
+    // TRUE if first and second differ at least at one position
+    gboolean folded;
+    // Horspool bad character shifts
+    gsize shift[256];
+
+    // case-insensitive search of non-ASCII UTF-8 text
+    gunichar *lower;
+    gunichar *upper;
+    gsize nchars;
+    // bytes that can start the match
+    gboolean lead[256];
+
+    // whole words search
+    gboolean whole_words;
+    // text is UTF-8: used to find word boundaries
+    gboolean is_utf8;
+};
+
+/*** forward declarations (file scope functions) *************************************************/
+
+/*** file scope variables ************************************************************************/
+
+/* --------------------------------------------------------------------------------------------- */
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+mc_search__literal_pairs_append (GByteArray *first, GByteArray *second, guchar c1, guchar c2)
+{
+    g_byte_array_append (first, &c1, 1);
+    g_byte_array_append (second, &c2, 1);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Build byte pairs for case-insensitive search in a non-UTF-8 charset.
+ * Mirrors mc_search__cond_struct_new_regex_accum_append(): letters are matched in upper
+ * and lower case byte by byte, other symbols are matched as is.
+ */
+
+static void
+mc_search__literal_pairs_ci (const char *charset, const GString *str, GByteArray *first,
+                             GByteArray *second)
+{
+    gsize loop = 0;
+
+    while (loop < str->len)
+    {
+        GString *one_char;
+        gboolean just_letters;
+
+        one_char = mc_search__get_one_symbol (charset, str->str + loop, MIN (str->len - loop, 6),
+                                              &just_letters);
+
+        if (one_char->len == 0)
+            loop++;
+        else
+        {
+            loop += one_char->len;
+
+            if (!just_letters)
+            {
+                g_byte_array_append (first, (const guint8 *) one_char->str, one_char->len);
+                g_byte_array_append (second, (const guint8 *) one_char->str, one_char->len);
+            }
+            else
+            {
+                GString *upp, *low;
+                gsize i;
+
+                upp = mc_search__toupper_case_str (charset, one_char);
+                low = mc_search__tolower_case_str (charset, one_char);
+
+                for (i = 0; i < upp->len; i++)
+                    mc_search__literal_pairs_append (
+                        first, second, (guchar) upp->str[i],
+                        (guchar) (i < low->len ? low->str[i] : upp->str[i]));
+
+                g_string_free (upp, TRUE);
+                g_string_free (low, TRUE);
+            }
+        }
+
+        g_string_free (one_char, TRUE);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+mc_search__literal_is_ascii (const GString *str)
+{
+    gsize i;
+
+    for (i = 0; i < str->len; i++)
+        if ((guchar) str->str[i] >= 0x80)
+            return FALSE;
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/**
+ * Check whether the text character matches the character of case-folded pattern at position i.
+ */
+
+static inline gboolean
+mc_search__literal_char_matches (const mc_search_literal_t *literal, gsize i, gunichar c)
+{
+    return c == literal->lower[i] || g_unichar_tolower (c) == literal->lower[i]
+        || g_unichar_toupper (c) == literal->upper[i];
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+mc_search__literal_add_lead (mc_search_literal_t *literal, gunichar c)
+{
+    gchar buf[6];
+
+    g_unichar_to_utf8 (c, buf);
+    literal->lead[(guchar) buf[0]] = TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+mc_search__literal_init_unicode (mc_search_literal_t *literal, const GString *str)
+{
+    const char *p;
+    gsize i;
+    gunichar c;
+
+    literal->nchars = g_utf8_strlen (str->str, str->len);
+    literal->lower = g_new (gunichar, literal->nchars);
+    literal->upper = g_new (gunichar, literal->nchars);
+
+    for (p = str->str, i = 0; i < literal->nchars; p = g_utf8_next_char (p), i++)
+    {
+        const gunichar c = g_utf8_get_char (p);
+
+        literal->lower[i] = g_unichar_tolower (c);
+        literal->upper[i] = g_unichar_toupper (c);
+    }
+
+    /* Collect the first bytes of all characters accepted at the first position by the same check
+     * as the compare loop does: e.g. KELVIN SIGN for 'k'. Characters without case mappings
+     * match themselves only. */
+    mc_search__literal_add_lead (literal, literal->lower[0]);
+    mc_search__literal_add_lead (literal, literal->upper[0]);
+
+    for (c = 0; c <= UNICHAR_CASED_MAX; c++)
+        if (mc_search__literal_char_matches (literal, 0, c))
+            mc_search__literal_add_lead (literal, c);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+mc_search__literal_init_shifts (mc_search_literal_t *literal)
+{
+    gsize i;
+
+    for (i = 0; i < G_N_ELEMENTS (literal->shift); i++)
+        literal->shift[i] = literal->len;
+
+    for (i = 0; i + 1 < literal->len; i++)
+    {
+        literal->shift[literal->first[i]] = literal->len - 1 - i;
+        literal->shift[literal->second[i]] = literal->len - 1 - i;
+
+        if (literal->first[i] != literal->second[i])
+            literal->folded = TRUE;
+    }
+
+    if (literal->first[i] != literal->second[i])
+        literal->folded = TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Check the character as "\p{L}\p{N}_" does in regex used for whole words search.
+ */
+
+static gboolean
+mc_search__literal_is_word_char (gunichar c)
+{
+    if (c == '_' || g_unichar_isalpha (c))
+        return TRUE;
+
+    switch (g_unichar_type (c))
+    {
+    case G_UNICODE_DECIMAL_NUMBER:
+    case G_UNICODE_LETTER_NUMBER:
+    case G_UNICODE_OTHER_NUMBER:
+        return TRUE;
+    default:
+        return FALSE;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+mc_search__literal_is_whole_word (const mc_search_literal_t *literal, const char *buf, gsize len,
+                                  gsize start, gsize end)
+{
+    gunichar c;
+
+    if (start != 0)
+    {
+        if (!literal->is_utf8)
+            c = (guchar) buf[start - 1];
+        else
+        {
+            const char *prev;
+
+            prev = g_utf8_find_prev_char (buf, buf + start);
+            c = prev == NULL ? (gunichar) (-1)
+                             : g_utf8_get_char_validated (prev, (buf + start) - prev);
+        }
+
+        if (c < (gunichar) (-2) && mc_search__literal_is_word_char (c))
+            return FALSE;
+    }
+
+    if (end < len)
+    {
+        if (!literal->is_utf8)
+            c = (guchar) buf[end];
+        else
+            c = g_utf8_get_char_validated (buf + end, len - end);
+
+        if (c < (gunichar) (-2) && mc_search__literal_is_word_char (c))
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static inline gboolean
+mc_search__literal_match_at (const mc_search_literal_t *literal, const guchar *text)
+{
+    gsize i;
+
+    if (!literal->folded)
+        return memcmp (text, literal->first, literal->len) == 0;
+
+    for (i = 0; i < literal->len; i++)
+        if (text[i] != literal->first[i] && text[i] != literal->second[i])
+            return FALSE;
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+mc_search__literal_find_bytes (const mc_search_literal_t *literal, const char *buf, gsize len,
+                               gsize from, gsize *match_start, gsize *match_len)
+{
+    const guchar *text = (const guchar *) buf;
+    const gsize last = literal->len - 1;
+    gsize pos = from;
+
+    if (literal->len > len)
+        return FALSE;
+
+    while (pos <= len - literal->len)
+    {
+        guchar c;
+
+        if (!literal->folded)
+        {
+            // let memchr() skip to the next candidate
+            const guchar *p;
+
+            p = memchr (text + pos + last, literal->first[last], len - pos - last);
+            if (p == NULL)
+                return FALSE;
+            pos = (gsize) (p - text) - last;
+            if (pos > len - literal->len)
+                return FALSE;
+        }
+
+        c = text[pos + last];
+
+        if ((c == literal->first[last] || c == literal->second[last])
+            && mc_search__literal_match_at (literal, text + pos)
+            && (!literal->whole_words
+                || mc_search__literal_is_whole_word (literal, buf, len, pos, pos + literal->len)))
+        {
+            *match_start = pos;
+            *match_len = literal->len;
+            return TRUE;
+        }
+
+        pos += literal->shift[c];
+    }
+
+    return FALSE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+mc_search__literal_find_unicode (const mc_search_literal_t *literal, const char *buf, gsize len,
+                                 gsize from, gsize *match_start, gsize *match_len)
+{
+    const char *end = buf + len;
+    const char *start;
+
+    for (start = buf + from; start < end; start++)
+    {
+        const char *p = start;
+        gsize i;
+
+        if (!literal->lead[(guchar) *start])
+            continue;
+
+        for (i = 0; i < literal->nchars && p < end; i++)
+        {
+            const gunichar c = g_utf8_get_char_validated (p, end - p);
+
+            if (c >= (gunichar) (-2) || !mc_search__literal_char_matches (literal, i, c))
+                break;
+
+            p = g_utf8_next_char (p);
+        }
+
+        if (i == literal->nchars
+            && (!literal->whole_words
+                || mc_search__literal_is_whole_word (literal, buf, len, start - buf, p - buf)))
+        {
+            *match_start = start - buf;
+            *match_len = p - start;
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get the longest possible match of literal pattern in bytes.
+ */
+
+static gsize
+mc_search__literal_get_max_len (const mc_search_literal_t *literal)
+{
+    return literal->nchars != 0 ? literal->nchars * UTF8_CHAR_LEN_MAX : literal->len;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Find the earliest match of all search conditions in the buffer.
+ *
+ * @param is_last if FALSE, more data follows the buffer: a match that ends closer than #context
+ *                bytes to the end of buffer is not reported because the next data can break
+ *                word boundary
+ *
+ * @return TRUE if match was found, FALSE otherwise
+ */
+
+static gboolean
+mc_search__literal_find_first (const mc_search_t *lc_mc_search, const char *buf, gsize len,
+                               gsize from, gsize context, gboolean is_last, gsize *match_start,
+                               gsize *match_len)
+{
+    gboolean found = FALSE;
+    gsize loop;
+
+    for (loop = 0; loop < lc_mc_search->prepared.conditions->len; loop++)
+    {
+        const mc_search_cond_t *mc_search_cond =
+            (const mc_search_cond_t *) g_ptr_array_index (lc_mc_search->prepared.conditions, loop);
+        gsize start, mlen;
+
+        if (mc_search__literal_find (mc_search_cond->literal, buf, len, from, &start, &mlen)
+            && (!found || start < *match_start))
+        {
+            *match_start = start;
+            *match_len = mlen;
+            found = TRUE;
+        }
+    }
+
+    return found && (is_last || *match_start + *match_len + context <= len);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Prepare literal search of the string.
+ *
+ * @param charset charset of #str
+ * @param lc_mc_search search object: case sensitivity and whole words flags are taken from it
+ * @param str string to search
+ *
+ * @return new literal pattern or NULL if string can't be searched without regex engine
+ */
+
+mc_search_literal_t *
+mc_search__literal_new (const char *charset, const mc_search_t *lc_mc_search, const GString *str)
+{
+    mc_search_literal_t *literal;
+    GByteArray *first, *second;
+    const gboolean is_utf8 = str_isutf8 (charset) && mc_global.utf8_display;
+
+    if (str->len == 0)
+        return NULL;
+
+    // GRegex checks pattern validity in UTF-8 mode, let it report the error
+    if (is_utf8 && !g_utf8_validate (str->str, str->len, NULL))
+        return NULL;
+
+    literal = g_new0 (mc_search_literal_t, 1);
+    literal->whole_words = lc_mc_search->whole_words && !lc_mc_search->is_entire_line;
+    literal->is_utf8 = is_utf8;
+
+    if (is_utf8 && !lc_mc_search->is_case_sensitive && !mc_search__literal_is_ascii (str))
+    {
+        mc_search__literal_init_unicode (literal, str);
+        return literal;
+    }
+
+    first = g_byte_array_sized_new (str->len);
+    second = g_byte_array_sized_new (str->len);
+
+    if (lc_mc_search->is_case_sensitive)
+    {
+        g_byte_array_append (first, (const guint8 *) str->str, str->len);
+        g_byte_array_append (second, (const guint8 *) str->str, str->len);
+    }
+    else if (is_utf8)
+    {
+        /* ASCII pattern: fold ASCII letters only.
+         * NOTE: PCRE also folds 'k' to KELVIN SIGN and 's' to LATIN SMALL LETTER LONG S. */
+        gsize i;
+
+        for (i = 0; i < str->len; i++)
+            mc_search__literal_pairs_append (first, second,
+                                             (guchar) g_ascii_tolower (str->str[i]),
+                                             (guchar) g_ascii_toupper (str->str[i]));
+    }
+    else
+        mc_search__literal_pairs_ci (charset, str, first, second);
+
+    literal->len = first->len;
+    literal->first = g_byte_array_free (first, FALSE);
+    literal->second = g_byte_array_free (second, FALSE);
+
+    if (literal->len == 0)
+    {
+        mc_search__literal_free (literal);
+        return NULL;
+    }
+
+    mc_search__literal_init_shifts (literal);
+
+    return literal;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+void
+mc_search__literal_free (mc_search_literal_t *literal)
+{
+    if (literal == NULL)
+        return;
+
+    g_free (literal->first);
+    g_free (literal->second);
+    g_free (literal->lower);
+    g_free (literal->upper);
+    g_free (literal);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Find the first occurrence of literal pattern in the buffer.
+ *
+ * @param literal pattern
+ * @param buf buffer to search in
+ * @param len length of #buf
+ * @param from offset in #buf to start search from. Bytes before it are used to check word
+ *             boundaries only
+ * @param match_start offset of found string in #buf
+ * @param match_len length of found string
+ *
+ * @return TRUE if pattern was found, FALSE otherwise
+ */
+
+gboolean
+mc_search__literal_find (const mc_search_literal_t *literal, const char *buf, gsize len,
+                         gsize from, gsize *match_start, gsize *match_len)
+{
+    if (literal->nchars != 0)
+        return mc_search__literal_find_unicode (literal, buf, len, from, match_start, match_len);
+
+    return mc_search__literal_find_bytes (literal, buf, len, from, match_start, match_len);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Check whether all search conditions are prepared as literal patterns.
+ */
+
+gboolean
+mc_search__is_literal (const mc_search_t *lc_mc_search)
+{
+    gsize loop;
+
+    for (loop = 0; loop < lc_mc_search->prepared.conditions->len; loop++)
+    {
+        const mc_search_cond_t *mc_search_cond =
+            (const mc_search_cond_t *) g_ptr_array_index (lc_mc_search->prepared.conditions, loop);
+
+        if (mc_search_cond->literal == NULL)
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Search literal patterns in data given by blocks (see mc_search_t::block_fn).
+ *
+ * Blocks are searched in place. To find matches that cross block boundaries, the tail of
+ * previous data is kept and searched together with the head of the next block.
+ */
+
+gboolean
+mc_search__run_literal (mc_search_t *lc_mc_search, const void *user_data, off_t start_search,
+                        off_t end_search, gsize *found_len)
+{
+    mc_search_cbret_t ret = MC_SEARCH_CB_OK;
+    GString *tail;
+    off_t tail_offset = start_search;  // offset of tail->str[0]
+    off_t current_pos = start_search;
+    gsize from = 0;  // offset in tail where search is continued
+    gsize max_len = 0;
+    gsize context;
+    gsize keep;
+    gsize loop;
+    gboolean found = FALSE;
+    off_t match_offset = 0;
+    gsize match_start, match_len = 0;
+
+    for (loop = 0; loop < lc_mc_search->prepared.conditions->len; loop++)
+    {
+        const mc_search_cond_t *mc_search_cond =
+            (const mc_search_cond_t *) g_ptr_array_index (lc_mc_search->prepared.conditions, loop);
+
+        max_len = MAX (max_len, mc_search__literal_get_max_len (mc_search_cond->literal));
+    }
+
+    // to check word boundary, one character before and after the match is required
+    context = lc_mc_search->whole_words ? UTF8_CHAR_LEN_MAX : 0;
+    keep = max_len + 2 * context;
+
+    tail = g_string_sized_new (2 * keep);
+
+    while (current_pos <= end_search)
+    {
+        const char *block;
+        gsize block_len, head_len;
+        gboolean is_last;
+
+        ret = lc_mc_search->block_fn (user_data, current_pos, &block, &block_len);
+        if (ret != MC_SEARCH_CB_OK || block_len == 0)
+            break;
+
+        block_len = MIN (block_len, (gsize) (end_search - current_pos + 1));
+        is_last = current_pos + (off_t) block_len > end_search;
+
+        // search at the junction of previous data and the block
+        head_len = MIN (block_len, keep);
+        g_string_append_len (tail, block, head_len);
+        if (mc_search__literal_find_first (lc_mc_search, tail->str, tail->len, from, context,
+                                           is_last && head_len == block_len, &match_start,
+                                           &match_len))
+        {
+            match_offset = tail_offset + (off_t) match_start;
+            found = TRUE;
+            break;
+        }
+
+        // search in the rest of the block
+        // bytes before #context offset were checked at the junction
+        if (block_len > keep
+            && mc_search__literal_find_first (lc_mc_search, block, block_len, context, context,
+                                              is_last, &match_start, &match_len))
+        {
+            match_offset = current_pos + (off_t) match_start;
+            found = TRUE;
+            break;
+        }
+
+        // keep the tail of data for the next block
+        if (block_len >= keep)
+        {
+            g_string_set_size (tail, 0);
+            g_string_append_len (tail, block + block_len - keep, keep);
+            tail_offset = current_pos + (off_t) (block_len - keep);
+        }
+        else if (tail->len > keep)
+        {
+            const gsize drop = tail->len - keep;
+
+            g_string_erase (tail, 0, drop);
+            tail_offset += (off_t) drop;
+        }
+
+        from = tail->len > max_len + context ? tail->len - max_len - context : 0;
+        current_pos += (off_t) block_len;
+
+        if (lc_mc_search->update_fn != NULL
+            && lc_mc_search->update_fn (user_data, current_pos) == MC_SEARCH_CB_ABORT)
+        {
+            ret = MC_SEARCH_CB_ABORT;
+            break;
+        }
+    }
+
+    // no more data: matches at the very end of data are complete now
+    if (!found && ret != MC_SEARCH_CB_ABORT && tail->len != 0
+        && mc_search__literal_find_first (lc_mc_search, tail->str, tail->len, from, context, TRUE,
+                                          &match_start, &match_len))
+    {
+        match_offset = tail_offset + (off_t) match_start;
+        found = TRUE;
+    }
+
+    g_string_free (tail, TRUE);
+
+    if (found)
+    {
+        if (found_len != NULL)
+            *found_len = match_len;
+        lc_mc_search->start_buffer = match_offset;
+        lc_mc_search->normal_offset = match_offset;
+        return TRUE;
+    }
+
+    MC_PTR_FREE (lc_mc_search->error_str);
+    lc_mc_search->error = ret == MC_SEARCH_CB_ABORT ? MC_SEARCH_E_ABORT : MC_SEARCH_E_NOTFOUND;
+
+    return FALSE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
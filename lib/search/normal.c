@@ -86,6 +86,13 @@ void
 mc_search__cond_struct_new_init_normal (const char *charset, mc_search_t *lc_mc_search,
                                         mc_search_cond_t *mc_search_cond)
 {
+    mc_search_cond->literal = mc_search__literal_new (charset, lc_mc_search, mc_search_cond->str);
+    if (mc_search_cond->literal != NULL)
+    {
+        lc_mc_search->is_utf8 = str_isutf8 (charset);
+        return;
+    }
+
     mc_search__normal_translate_to_regex (mc_search_cond->str);
     mc_search__cond_struct_new_init_regex (charset, lc_mc_search, mc_search_cond);
 }
@@ -96,6 +103,10 @@ gboolean
 mc_search__run_normal (mc_search_t *lc_mc_search, const void *user_data, off_t start_search,
                        off_t end_search, gsize *found_len)
 {
+    if (lc_mc_search->block_fn != NULL && mc_search__is_literal (lc_mc_search))
+        return mc_search__run_literal (lc_mc_search, user_data, start_search, end_search,
+                                       found_len);
+
     return mc_search__run_regex (lc_mc_search, user_data, start_search, end_search, found_len);
 }
 
@@ -322,9 +322,11 @@ mc_search__g_regex_match_full_safe (const GRegex *regex, const gchar *string, gs
 /* --------------------------------------------------------------------------------------------- */
 
 static mc_search__found_cond_t
-mc_search__regex_found_cond_one (mc_search_t *lc_mc_search, GRegex *regex, GString *search_str)
+mc_search__regex_found_cond_one (mc_search_t *lc_mc_search, GRegex *regex, GString *search_str,
+                                 gsize *start_pos, gsize *end_pos)
 {
     GError *mcerror = NULL;
+    gint start, end;
 
     if (!mc_search__g_regex_match_full_safe (regex, search_str->str, search_str->len, 0,
                                              G_REGEX_MATCH_NEWLINE_ANY,
@@ -345,13 +347,35 @@ mc_search__regex_found_cond_one (mc_search_t *lc_mc_search, GRegex *regex, GStri
     }
     lc_mc_search->num_results = g_match_info_get_match_count (lc_mc_search->regex_match_info);
 
+    g_match_info_fetch_pos (lc_mc_search->regex_match_info, 0, &start, &end);
+    *start_pos = (gsize) start;
+    *end_pos = (gsize) end;
+
+    return COND__FOUND_OK;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static mc_search__found_cond_t
+mc_search__literal_found_cond_one (mc_search_t *lc_mc_search, const mc_search_literal_t *literal,
+                                   const GString *search_str, gsize *start_pos, gsize *end_pos)
+{
+    gsize len;
+
+    if (!mc_search__literal_find (literal, search_str->str, search_str->len, 0, start_pos, &len))
+        return COND__NOT_FOUND;
+
+    lc_mc_search->num_results = 1;
+    *end_pos = *start_pos + len;
+
     return COND__FOUND_OK;
 }
 
 /* --------------------------------------------------------------------------------------------- */
 
 static mc_search__found_cond_t
-mc_search__regex_found_cond (mc_search_t *lc_mc_search, GString *search_str)
+mc_search__regex_found_cond (mc_search_t *lc_mc_search, GString *search_str, gsize *start_pos,
+                             gsize *end_pos)
 {
     gsize loop1;
 
@@ -363,11 +387,15 @@ mc_search__regex_found_cond (mc_search_t *lc_mc_search, GString *search_str)
         mc_search_cond =
             (mc_search_cond_t *) g_ptr_array_index (lc_mc_search->prepared.conditions, loop1);
 
-        if (!mc_search_cond->regex_handle)
+        if (mc_search_cond->literal != NULL)
+            ret = mc_search__literal_found_cond_one (lc_mc_search, mc_search_cond->literal,
+                                                     search_str, start_pos, end_pos);
+        else if (mc_search_cond->regex_handle != NULL)
+            ret = mc_search__regex_found_cond_one (lc_mc_search, mc_search_cond->regex_handle,
+                                                   search_str, start_pos, end_pos);
+        else
             continue;
 
-        ret = mc_search__regex_found_cond_one (lc_mc_search, mc_search_cond->regex_handle,
-                                               search_str);
         if (ret != COND__NOT_FOUND)
             return ret;
     }
@@ -831,6 +859,7 @@ mc_search__run_regex (mc_search_t *lc_mc_search, const void *user_data, off_t st
 {
     mc_search_cbret_t ret = MC_SEARCH_CB_NOTFOUND;
     off_t current_pos, virtual_pos;
+    gsize start_pos, end_pos;
 
     if (lc_mc_search->regex_buffer != NULL)
         g_string_set_size (lc_mc_search->regex_buffer, 0);
@@ -843,12 +872,49 @@ mc_search__run_regex (mc_search_t *lc_mc_search, const void *user_data, off_t st
         g_string_set_size (lc_mc_search->regex_buffer, 0);
         lc_mc_search->start_buffer = current_pos;
 
-        if (lc_mc_search->search_fn != NULL)
+        if (lc_mc_search->search_fn != NULL || lc_mc_search->block_fn != NULL)
         {
             while (TRUE)
             {
                 int current_chr = '\n';  // stop search symbol
 
+                if (lc_mc_search->block_fn != NULL)
+                {
+                    const char *block;
+                    gsize block_len;
+
+                    ret = lc_mc_search->block_fn (user_data, current_pos, &block, &block_len);
+
+                    if (ret == MC_SEARCH_CB_OK && block_len != 0)
+                    {
+                        const char *eol;
+
+                        block_len = MIN (block_len, (gsize) (end_search - virtual_pos + 1));
+                        eol = memchr (block, '\n', block_len);
+                        if (eol != NULL)
+                            block_len = (gsize) (eol - block) + 1;
+
+                        g_string_append_len (lc_mc_search->regex_buffer, block, block_len);
+                        current_pos += (off_t) block_len;
+                        virtual_pos += (off_t) block_len;
+
+                        if (eol != NULL || virtual_pos > end_search)
+                            break;
+
+                        continue;
+                    }
+
+                    if (ret == MC_SEARCH_CB_ABORT)
+                        break;
+
+                    // no contiguous data here: fall back to per-byte callback
+                    if (lc_mc_search->search_fn == NULL)
+                    {
+                        ret = MC_SEARCH_CB_NOTFOUND;
+                        break;
+                    }
+                }
+
                 ret = lc_mc_search->search_fn (user_data, current_pos, &current_chr);
 
                 if (ret == MC_SEARCH_CB_ABORT)
@@ -895,18 +961,14 @@ mc_search__run_regex (mc_search_t *lc_mc_search, const void *user_data, off_t st
             virtual_pos = current_pos;
         }
 
-        switch (mc_search__regex_found_cond (lc_mc_search, lc_mc_search->regex_buffer))
+        switch (mc_search__regex_found_cond (lc_mc_search, lc_mc_search->regex_buffer, &start_pos,
+                                             &end_pos))
         {
         case COND__FOUND_OK:
-        {
-            gint start_pos, end_pos;
-
-            g_match_info_fetch_pos (lc_mc_search->regex_match_info, 0, &start_pos, &end_pos);
             if (found_len != NULL)
                 *found_len = end_pos - start_pos;
             lc_mc_search->normal_offset = lc_mc_search->start_buffer + start_pos;
             return TRUE;
-        }
         case COND__NOT_ALL_FOUND:
             break;
         default:
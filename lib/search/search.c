@@ -109,6 +109,8 @@ mc_search__cond_struct_free (gpointer data)
     if (mc_search_cond->regex_handle != NULL)
         g_regex_unref (mc_search_cond->regex_handle);
 
+    mc_search__literal_free (mc_search_cond->literal);
+
     g_free (mc_search_cond);
 }
 
@@ -61,9 +61,9 @@ void tty_init_colors (gboolean disable, gboolean force, int color_map_size);
 void tty_colors_done (void);
 
 gboolean tty_use_colors (void);
-int tty_try_alloc_color_pair (const tty_color_pair_t *color, gboolean is_temp);
+MC_MOCKABLE int tty_try_alloc_color_pair (const tty_color_pair_t *color, gboolean is_temp);
 
-void tty_color_free_temp (void);
+MC_MOCKABLE void tty_color_free_temp (void);
 void tty_color_free_all (void);
 
 void tty_setcolor (int color);
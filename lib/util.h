@@ -236,7 +236,7 @@ int my_systemv_flags (int flags, const char *command, char *const argv[]);
 
 mc_pipe_t *mc_popen (const char *command, gboolean read_out, gboolean read_err, GError **error);
 void mc_pread (mc_pipe_t *p, GError **error);
-void mc_pclose (mc_pipe_t *p, GError **error);
+int mc_pclose (mc_pipe_t *p, GError **error);
 
 GString *mc_pstream_get_string (mc_pipe_stream_t *ps);
 
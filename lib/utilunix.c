@@ -732,18 +732,21 @@ mc_pstream_get_string (mc_pipe_stream_t *ps)
  *
  * @parameter p pipe descriptor
  * @parameter error contains pointer to object to handle error code and message
+ *
+ * @return status of child process as returned by waitpid() or -1 on error
  */
 
-void
+int
 mc_pclose (mc_pipe_t *p, GError **error)
 {
     int res;
+    int status = -1;
 
     if (p == NULL)
     {
         mc_replace_error (error, MC_PIPE_ERROR_READ, "%s",
                           _ ("Cannot close pipe descriptor (p == NULL)"));
-        return;
+        return -1;
     }
 
     if (p->out.fd >= 0)
@@ -753,17 +756,20 @@ mc_pclose (mc_pipe_t *p, GError **error)
 
     do
     {
-        int status;
-
         res = waitpid (p->child_pid, &status, 0);
     }
     while (res < 0 && errno == EINTR);
 
     if (res < 0)
+    {
         mc_replace_error (error, MC_PIPE_ERROR_READ, _ ("Unexpected error in waitpid():\n%s"),
                           unix_error_string (errno));
+        status = -1;
+    }
 
     g_free (p);
+
+    return status;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -88,6 +88,9 @@
     if (VFS_SUBCLASS (me)->x != NULL)                                                              \
     VFS_SUBCLASS (me)->x
 
+/* directories with so many entries get index of names */
+#define SUBDIR_INDEX_MIN 32
+
 /*** file scope type declarations ****************************************************************/
 
 struct dirhandle
@@ -104,6 +107,51 @@ struct dirhandle
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
 
+static void
+vfs_s_subdir_index_add (struct vfs_s_inode *dir, struct vfs_s_entry *ent)
+{
+    // keep the first entry: it is found by the linear search
+    if (g_hash_table_lookup (dir->subdir_index, ent->name) != NULL)
+        dir->subdir_index_dups++;
+    else
+        g_hash_table_insert (dir->subdir_index, ent->name, ent);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+vfs_s_subdir_index_free (struct vfs_s_inode *dir)
+{
+    if (dir->subdir_index != NULL)
+    {
+        g_hash_table_destroy (dir->subdir_index);
+        dir->subdir_index = NULL;
+        dir->subdir_index_dups = 0;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+vfs_s_subdir_index_remove (struct vfs_s_inode *dir, struct vfs_s_entry *ent)
+{
+    if (g_hash_table_lookup (dir->subdir_index, ent->name) != ent)
+    {
+        // entry is a duplicate
+        if (dir->subdir_index_dups != 0)
+            dir->subdir_index_dups--;
+    }
+    else if (dir->subdir_index_dups == 0)
+        g_hash_table_remove (dir->subdir_index, ent->name);
+    else
+    {
+        // another entry with the same name can follow: rebuild index on the next lookup
+        vfs_s_subdir_index_free (dir);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 /* We were asked to create entries automagically */
 
 static struct vfs_s_entry *
@@ -188,7 +236,7 @@ vfs_s_find_entry_tree (struct vfs_class *me, struct vfs_s_inode *root, const cha
 
     while (root != NULL)
     {
-        GList *iter;
+        char c;
 
         while (IS_PATH_SEP (*path)) /* Strip leading '/' */
             path++;
@@ -202,15 +250,10 @@ vfs_s_find_entry_tree (struct vfs_class *me, struct vfs_s_inode *root, const cha
         for (pseg = 0; path[pseg] != '\0' && !IS_PATH_SEP (path[pseg]); pseg++)
             ;
 
-        for (iter = g_queue_peek_head_link (root->subdir); iter != NULL; iter = g_list_next (iter))
-        {
-            ent = VFS_ENTRY (iter->data);
-            if (strlen (ent->name) == pseg && strncmp (ent->name, path, pseg) == 0)
-                // FOUND!
-                break;
-        }
-
-        ent = iter != NULL ? VFS_ENTRY (iter->data) : NULL;
+        c = path[pseg];
+        path[pseg] = '\0';
+        ent = vfs_s_find_child (root, path);
+        path[pseg] = c;
 
         if (ent == NULL && (flags & (FL_MKFILE | FL_MKDIR)) != 0)
             ent = vfs_s_automake (me, root, path, flags);
@@ -242,7 +285,6 @@ vfs_s_find_entry_linear (struct vfs_class *me, struct vfs_s_inode *root, const c
 {
     struct vfs_s_entry *ent = NULL;
     char *const path = g_strdup (a_path);
-    GList *iter;
 
     if (root->super->root != root)
         vfs_die ("We have to use _real_ root. Always. Sorry.");
@@ -265,8 +307,7 @@ vfs_s_find_entry_linear (struct vfs_class *me, struct vfs_s_inode *root, const c
         return ent;
     }
 
-    iter = g_queue_find_custom (root->subdir, path, (GCompareFunc) vfs_s_entry_compare);
-    ent = iter != NULL ? VFS_ENTRY (iter->data) : NULL;
+    ent = vfs_s_find_child (root, path);
 
     if (ent != NULL && !VFS_SUBCLASS (me)->dir_uptodate (me, ent->ino))
     {
@@ -292,8 +333,7 @@ vfs_s_find_entry_linear (struct vfs_class *me, struct vfs_s_inode *root, const c
 
         vfs_s_insert_entry (me, root, ent);
 
-        iter = g_queue_find_custom (root->subdir, path, (GCompareFunc) vfs_s_entry_compare);
-        ent = iter != NULL ? VFS_ENTRY (iter->data) : NULL;
+        ent = vfs_s_find_child (root, path);
     }
     if (ent == NULL)
         vfs_die ("find_linear: success but directory is not there\n");
@@ -475,6 +515,29 @@ vfs_s_readdir (void *data)
 
 /* --------------------------------------------------------------------------------------------- */
 
+static struct vfs_dirent *
+vfs_s_readdir_plus (void *data, struct stat *buf, struct stat *link_buf)
+{
+    struct dirhandle *info = (struct dirhandle *) data;
+    struct vfs_s_inode *ino;
+
+    (void) link_buf;
+
+    if (info->cur == NULL || info->cur->data == NULL)
+        return NULL;
+
+    // inode tree is already loaded: stat info is here for free
+    ino = VFS_ENTRY (info->cur->data)->ino;
+    if (ino != NULL)
+        *buf = ino->st;
+    else
+        memset (buf, 0, sizeof (*buf));
+
+    return vfs_s_readdir (data);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static int
 vfs_s_closedir (void *data)
 {
@@ -913,6 +976,9 @@ vfs_s_free_inode (struct vfs_class *me, struct vfs_s_inode *ino)
         return;
     }
 
+    // entries are removed one by one, index is not needed
+    vfs_s_subdir_index_free (ino);
+
     while (g_queue_get_length (ino->subdir) != 0)
     {
         struct vfs_s_entry *entry;
@@ -958,7 +1024,11 @@ void
 vfs_s_free_entry (struct vfs_class *me, struct vfs_s_entry *ent)
 {
     if (ent->dir != NULL)
+    {
+        if (ent->dir->subdir_index != NULL)
+            vfs_s_subdir_index_remove (ent->dir, ent);
         g_queue_remove (ent->dir->subdir, ent);
+    }
 
     MC_PTR_FREE (ent->name);
 
@@ -978,10 +1048,55 @@ vfs_s_insert_entry (struct vfs_class *me, struct vfs_s_inode *dir, struct vfs_s_
 {
     (void) me;
 
+    ent->ino->st.st_nlink++;
+    vfs_s_add_entry (dir, ent);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Append entry to directory. Unlike vfs_s_insert_entry(), link count of inode is not changed.
+ */
+
+void
+vfs_s_add_entry (struct vfs_s_inode *dir, struct vfs_s_entry *ent)
+{
     ent->dir = dir;
 
-    ent->ino->st.st_nlink++;
     g_queue_push_tail (dir->subdir, ent);
+    if (dir->subdir_index != NULL)
+        vfs_s_subdir_index_add (dir, ent);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Find entry of directory by name.
+ *
+ * Small directories are searched linearly. Large ones get index of names on the first lookup,
+ * then vfs_s_add_entry() and vfs_s_free_entry() keep it up to date.
+ *
+ * @return the first entry with this name or NULL if not found
+ */
+
+struct vfs_s_entry *
+vfs_s_find_child (struct vfs_s_inode *dir, const char *name)
+{
+    GList *iter;
+
+    if (dir->subdir_index == NULL && g_queue_get_length (dir->subdir) >= SUBDIR_INDEX_MIN)
+    {
+        dir->subdir_index = g_hash_table_new (g_str_hash, g_str_equal);
+        dir->subdir_index_dups = 0;
+
+        for (iter = g_queue_peek_head_link (dir->subdir); iter != NULL; iter = g_list_next (iter))
+            vfs_s_subdir_index_add (dir, VFS_ENTRY (iter->data));
+    }
+
+    if (dir->subdir_index != NULL)
+        return VFS_ENTRY (g_hash_table_lookup (dir->subdir_index, name));
+
+    iter = g_queue_find_custom (dir->subdir, name, (GCompareFunc) vfs_s_entry_compare);
+
+    return iter != NULL ? VFS_ENTRY (iter->data) : NULL;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -1547,6 +1662,10 @@ vfs_init_subclass (struct vfs_s_subclass *sub, const char *name, vfs_flags_t fla
     start = (char *) sub + sizeof (struct vfs_class);
     memset (start, 0, len);
 
+    // vfs_s_readdir_plus() understands handles of vfs_s_opendir() only: classes initialized
+    // by vfs_init_class() alone (localfs, sfs) use their own handles
+    vclass->readdir_plus = vfs_s_readdir_plus;
+
     if ((vclass->flags & VFSF_USETMP) != 0)
         sub->find_entry = vfs_s_find_entry_linear;
     else if ((vclass->flags & VFSF_REMOTE) != 0)
@@ -1709,6 +1828,9 @@ vfs_s_normalize_filename_leading_spaces (struct vfs_s_inode *root_inode, size_t
 {
     GList *iter;
 
+    // names are changed, index is rebuilt on the next lookup
+    vfs_s_subdir_index_free (root_inode);
+
     for (iter = g_queue_peek_head_link (root_inode->subdir); iter != NULL;
          iter = g_list_next (iter))
     {
@@ -249,6 +249,54 @@ failed:
     return (-1);
 }
 
+/* --------------------------------------------------------------------------------------------- */
+
+static struct vfs_dirent *
+mc_readdir_internal (DIR *dirp, struct stat *buf, struct stat *link_buf)
+{
+    int handle;
+    struct vfs_class *vfs;
+    void *fsinfo = NULL;
+    struct vfs_dirent *entry = NULL;
+    vfs_path_element_t *vfs_path_element;
+
+    if (dirp == NULL)
+    {
+        errno = EFAULT;
+        return NULL;
+    }
+
+    handle = *(int *) dirp;
+
+    vfs = vfs_class_find_by_handle (handle, &fsinfo);
+    if (vfs == NULL || fsinfo == NULL)
+        return NULL;
+
+    vfs_path_element = (vfs_path_element_t *) fsinfo;
+    if (buf != NULL && link_buf != NULL)
+        memset (link_buf, 0, sizeof (*link_buf));
+
+    if (buf != NULL && vfs->readdir_plus != NULL)
+        entry = vfs->readdir_plus (vfs_path_element->dir.info, buf, link_buf);
+    else if (vfs->readdir != NULL)
+    {
+        entry = vfs->readdir (vfs_path_element->dir.info);
+        if (entry != NULL && buf != NULL)
+            memset (buf, 0, sizeof (*buf));
+    }
+
+    if (entry != NULL)
+    {
+        g_string_set_size (vfs_str_buffer, 0);
+        str_vfs_convert_from (vfs_path_element->dir.converter, entry->d_name, vfs_str_buffer);
+        vfs_dirent_assign (mc_readdir_result, vfs_str_buffer->str, entry->d_ino, entry->d_type);
+        vfs_dirent_free (entry);
+    }
+    else
+        errno = vfs->readdir ? vfs_ferrno (vfs) : ENOTSUP;
+    return (entry != NULL) ? mc_readdir_result : NULL;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /*** public functions ****************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -516,39 +564,25 @@ mc_opendir (const vfs_path_t *vpath)
 struct vfs_dirent *
 mc_readdir (DIR *dirp)
 {
-    int handle;
-    struct vfs_class *vfs;
-    void *fsinfo = NULL;
-    struct vfs_dirent *entry = NULL;
-    vfs_path_element_t *vfs_path_element;
-
-    if (dirp == NULL)
-    {
-        errno = EFAULT;
-        return NULL;
-    }
-
-    handle = *(int *) dirp;
-
-    vfs = vfs_class_find_by_handle (handle, &fsinfo);
-    if (vfs == NULL || fsinfo == NULL)
-        return NULL;
+    return mc_readdir_internal (dirp, NULL, NULL);
+}
 
-    vfs_path_element = (vfs_path_element_t *) fsinfo;
-    if (vfs->readdir != NULL)
-    {
-        entry = vfs->readdir (vfs_path_element->dir.info);
-        if (entry == NULL)
-            return NULL;
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Read directory entry and get lstat() information about it in one go if VFS class can do it.
+ *
+ * @param dirp     directory handle
+ * @param buf      buffer for lstat() information. If VFS class cannot provide it,
+ *                 buf->st_mode is set to 0 and caller should use mc_lstat()
+ * @param link_buf buffer for stat() information of symlink target (may be NULL).
+ *                 If it is not available, link_buf->st_mode is set to 0
+ * @return directory entry or NULL if there are no more entries
+ */
 
-        g_string_set_size (vfs_str_buffer, 0);
-        str_vfs_convert_from (vfs_path_element->dir.converter, entry->d_name, vfs_str_buffer);
-        vfs_dirent_assign (mc_readdir_result, vfs_str_buffer->str, entry->d_ino, entry->d_type);
-        vfs_dirent_free (entry);
-    }
-    if (entry == NULL)
-        errno = vfs->readdir ? vfs_ferrno (vfs) : ENOTSUP;
-    return (entry != NULL) ? mc_readdir_result : NULL;
+struct vfs_dirent *
+mc_readdir_plus (DIR *dirp, struct stat *buf, struct stat *link_buf)
+{
+    return mc_readdir_internal (dirp, buf, link_buf);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -57,6 +57,13 @@
 #include <unistd.h>  // reflink()
 #endif
 
+#ifdef HAVE_COPY_FILE_RANGE
+#include <unistd.h>  // copy_file_range()
+#endif
+#ifdef HAVE_SYS_SENDFILE_H
+#include <sys/sendfile.h>  // sendfile()
+#endif
+
 #include "lib/global.h"
 #include "lib/strutil.h"
 #include "lib/util.h"
@@ -793,6 +800,70 @@ vfs_clone_file (int dest_vfs_fd, int src_vfs_fd)
 #endif
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Copy data between local files in kernel without passing it through user space.
+ * Data is copied from the current offset of source file to the current offset of
+ * destination file, both offsets are advanced by the number of copied bytes.
+ *
+ * @param dest_vfs_fd mc VFS file handler of destination
+ * @param src_vfs_fd mc VFS file handler of source
+ * @param count maximum number of bytes to copy
+ *
+ * @return number of copied bytes, 0 at the end of source file or -1 on error.
+ *         errno is ENOTSUP if any of files is not local or kernel copy is not supported.
+ */
+
+ssize_t
+vfs_copy_file_range (int dest_vfs_fd, int src_vfs_fd, size_t count)
+{
+#if defined(HAVE_COPY_FILE_RANGE) || (defined(HAVE_SENDFILE) && defined(HAVE_SYS_SENDFILE_H))
+    void *dest_fd = NULL;
+    void *src_fd = NULL;
+    struct vfs_class *dest_class;
+    struct vfs_class *src_class;
+    ssize_t result = -1;
+
+    dest_class = vfs_class_find_by_handle (dest_vfs_fd, &dest_fd);
+    src_class = vfs_class_find_by_handle (src_vfs_fd, &src_fd);
+    if (dest_class == NULL || (dest_class->flags & VFSF_LOCAL) == 0 || dest_fd == NULL
+        || src_class == NULL || (src_class->flags & VFSF_LOCAL) == 0 || src_fd == NULL)
+    {
+        errno = ENOTSUP;
+        return (-1);
+    }
+
+#ifdef HAVE_COPY_FILE_RANGE
+    do
+        result = copy_file_range (*(int *) src_fd, NULL, *(int *) dest_fd, NULL, count, 0);
+    while (result == -1 && errno == EINTR);
+
+    // Linux < 5.3 and some file systems don't copy across file systems
+    if (result != -1 || (errno != EXDEV && errno != ENOSYS && errno != EINVAL && errno != ENOTSUP
+                         && errno != EOPNOTSUPP))
+        return result;
+#endif
+
+#if defined(HAVE_SENDFILE) && defined(HAVE_SYS_SENDFILE_H)
+    do
+        result = sendfile (*(int *) dest_fd, *(int *) src_fd, NULL, count);
+    while (result == -1 && errno == EINTR);
+
+    if (result == -1 && (errno == ENOSYS || errno == EINVAL))
+        errno = ENOTSUP;
+#endif
+
+    return result;
+
+#else
+    (void) dest_vfs_fd;
+    (void) src_vfs_fd;
+    (void) count;
+    errno = ENOTSUP;
+    return (-1);
+#endif
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 int
@@ -166,6 +166,12 @@ typedef struct vfs_class
 
     void *(*opendir) (const vfs_path_t *vpath);
     struct vfs_dirent *(*readdir) (void *vfs_info);
+    /**
+     * Optional: like readdir(), but also fill buf with lstat() information of the entry
+     * and, if the entry is a symlink and link_buf is not NULL, link_buf with stat()
+     * information of its target. st_mode is 0 if the information is not available.
+     */
+    struct vfs_dirent *(*readdir_plus) (void *vfs_info, struct stat *buf, struct stat *link_buf);
     int (*closedir) (void *vfs_info);
 
     int (*stat) (const vfs_path_t *vpath, struct stat *buf);
@@ -303,6 +309,7 @@ char *vfs_get_cwd (void);
 int vfs_preallocate (int dest_desc, off_t src_fsize, off_t dest_fsize);
 
 int vfs_clone_file (int dest_vfs_fd, int src_vfs_fd);
+ssize_t vfs_copy_file_range (int dest_vfs_fd, int src_vfs_fd, size_t count);
 int vfs_clone_file_by_path (const vfs_path_t *dest_vpath, const vfs_path_t *src_vpath,
                             gboolean preserve_uidgid);
 
@@ -317,6 +324,7 @@ int mc_close (int handle);
 off_t mc_lseek (int fd, off_t offset, int whence);
 DIR *mc_opendir (const vfs_path_t *vpath);
 struct vfs_dirent *mc_readdir (DIR *dirp);
+struct vfs_dirent *mc_readdir_plus (DIR *dirp, struct stat *buf, struct stat *link_buf);
 int mc_closedir (DIR *dir);
 MC_MOCKABLE int mc_stat (const vfs_path_t *vpath, struct stat *buf);
 int mc_mknod (const vfs_path_t *vpath, mode_t mode, dev_t dev);
@@ -95,6 +95,8 @@ struct vfs_s_inode
                                    use only for directories because they
                                    cannot be hardlinked */
     GQueue *subdir;             // If this is a directory, its entry. List of vfs_s_entry
+    GHashTable *subdir_index;   // Name -> first vfs_s_entry with this name, for large directories
+    guint subdir_index_dups;    // Number of entries with the same name as an earlier one
     struct stat st;             // Parameters of this inode
     char *linkname;             // Symlink's contents
     char *localname;            // Filename of local file, if we have one
@@ -166,6 +168,8 @@ struct vfs_s_entry *vfs_s_new_entry (struct vfs_class *me, const char *name,
                                      struct vfs_s_inode *inode);
 void vfs_s_free_entry (struct vfs_class *me, struct vfs_s_entry *ent);
 void vfs_s_insert_entry (struct vfs_class *me, struct vfs_s_inode *dir, struct vfs_s_entry *ent);
+void vfs_s_add_entry (struct vfs_s_inode *dir, struct vfs_s_entry *ent);
+struct vfs_s_entry *vfs_s_find_child (struct vfs_s_inode *dir, const char *name);
 int vfs_s_entry_compare (const void *a, const void *b);
 struct stat *vfs_s_default_stat (struct vfs_class *me, mode_t mode);
 
@@ -14,6 +14,7 @@ m4_include([m4.include/vfs/mc-vfs-ftp.m4])
 m4_include([m4.include/vfs/mc-vfs-sftp.m4])
 m4_include([m4.include/vfs/mc-vfs-shell.m4])
 m4_include([m4.include/vfs/mc-vfs-tarfs.m4])
+m4_include([m4.include/vfs/mc-vfs-zipfs.m4])
 m4_include([m4.include/vfs/mc-vfs-cpiofs.m4])
 
 dnl mc_VFS_CHECKS
@@ -72,6 +73,7 @@ AC_DEFUN([mc_VFS_CHECKS],
     mc_VFS_SFS
     mc_VFS_SFTP
     mc_VFS_TARFS
+    mc_VFS_ZIPFS
 
     AM_CONDITIONAL(ENABLE_VFS, [test x"$enable_vfs" = x"yes"])
 
@@ -0,0 +1,22 @@
+dnl ZIP filesystem support
+AC_DEFUN([mc_VFS_ZIPFS],
+[
+    AC_ARG_ENABLE([vfs-zip],
+                  AS_HELP_STRING([--enable-vfs-zip], [Support for zip filesystem [auto]]))
+    if test "$enable_vfs" != "no" -a x"$enable_vfs_zip" != x"no"; then
+        PKG_CHECK_MODULES(ZLIB, [zlib >= 1.2.8], [found_zlib=yes], [:])
+        if test x"$found_zlib" = "xyes"; then
+            mc_VFS_ADDNAME([zip])
+            AC_DEFINE([ENABLE_VFS_ZIP], [1], [Support for zip filesystem])
+            MCLIBS="$MCLIBS $ZLIB_LIBS"
+            enable_vfs_zip="yes"
+        else
+            if test x"$enable_vfs_zip" = x"yes"; then
+                dnl user explicitly requested feature
+                AC_MSG_ERROR([zlib >= 1.2.8 library not found])
+            fi
+            enable_vfs_zip="no"
+        fi
+    fi
+    AM_CONDITIONAL([ENABLE_VFS_ZIP], [test "$enable_vfs" = "yes" -a x"$enable_vfs_zip" = x"yes"])
+])
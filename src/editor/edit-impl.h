@@ -42,7 +42,7 @@
 #define EDIT_BOTTOM_EXTREME         0
 
 /* Initial size of the undo stack, in bytes */
-#define START_STACK_SIZE 32
+#define START_STACK_SIZE 256
 
 /* Some codes that may be pushed onto or returned from the undo stack */
 #define CURS_LEFT       601
@@ -148,6 +148,7 @@ int edit_backspace (WEdit *edit, gboolean byte_delete);
 void edit_insert (WEdit *edit, int c);
 void edit_insert_over (WEdit *edit);
 void edit_cursor_move (WEdit *edit, off_t increment);
+unsigned long edit_undo_max_size (const WEdit *edit);
 void edit_push_undo_action (WEdit *edit, long c);
 void edit_push_redo_action (WEdit *edit, long c);
 void edit_push_key_press (WEdit *edit);
@@ -213,6 +214,7 @@ void edit_set_filename (WEdit *edit, const vfs_path_t *name_vpath);
 MC_MOCKABLE void edit_load_syntax (WEdit *edit, GPtrArray *pnames, const char *type);
 void edit_free_syntax_rules (WEdit *edit);
 MC_MOCKABLE int edit_get_syntax_color (WEdit *edit, off_t byte_index);
+void edit_syntax_invalidate (WEdit *edit, off_t offset);
 void edit_syntax_dialog (WEdit *edit);
 
 void book_mark_insert (WEdit *edit, long line, int c);
@@ -65,9 +65,9 @@
 #include "edit-impl.h"
 #include "editwidget.h"
 #include "editsearch.h"
-#include "editcomplete.h"  // edit_complete_word_cmd()
+#include "editcomplete.h"  // edit_complete_word_cmd(), edit_complete_index_change()
 #include "editmacros.h"
-#include "etags.h"  // edit_get_match_keyword_cmd()
+#include "etags.h"  // edit_get_match_keyword_cmd(), etags_cache_free()
 #ifdef HAVE_ASPELL
 #include "spell.h"
 #endif
@@ -535,34 +535,7 @@ edit_purge_widget (WEdit *edit)
 static long
 edit_pop_undo_action (WEdit *edit)
 {
-    long c;
-    unsigned long sp = edit->undo_stack_pointer;
-
-    if (sp == edit->undo_stack_bottom)
-        return STACK_BOTTOM;
-
-    sp = (sp - 1) & edit->undo_stack_size_mask;
-    c = edit->undo_stack[sp];
-    if (c >= 0)
-    {
-        //      edit->undo_stack[sp] = '@';
-        edit->undo_stack_pointer = (edit->undo_stack_pointer - 1) & edit->undo_stack_size_mask;
-        return c;
-    }
-
-    if (sp == edit->undo_stack_bottom)
-        return STACK_BOTTOM;
-
-    c = edit->undo_stack[(sp - 1) & edit->undo_stack_size_mask];
-    if (edit->undo_stack[sp] == -2)
-    {
-        //      edit->undo_stack[sp] = '@';
-        edit->undo_stack_pointer = sp;
-    }
-    else
-        edit->undo_stack[sp]++;
-
-    return c;
+    return edit_undo_stack_pop (&edit->undo_stack);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -570,30 +543,7 @@ edit_pop_undo_action (WEdit *edit)
 static long
 edit_pop_redo_action (WEdit *edit)
 {
-    long c;
-    unsigned long sp = edit->redo_stack_pointer;
-
-    if (sp == edit->redo_stack_bottom)
-        return STACK_BOTTOM;
-
-    sp = (sp - 1) & edit->redo_stack_size_mask;
-    c = edit->redo_stack[sp];
-    if (c >= 0)
-    {
-        edit->redo_stack_pointer = (edit->redo_stack_pointer - 1) & edit->redo_stack_size_mask;
-        return c;
-    }
-
-    if (sp == edit->redo_stack_bottom)
-        return STACK_BOTTOM;
-
-    c = edit->redo_stack[(sp - 1) & edit->redo_stack_size_mask];
-    if (edit->redo_stack[sp] == -2)
-        edit->redo_stack_pointer = sp;
-    else
-        edit->redo_stack[sp]++;
-
-    return c;
+    return edit_undo_stack_pop (&edit->redo_stack);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -601,22 +551,7 @@ edit_pop_redo_action (WEdit *edit)
 static long
 get_prev_undo_action (WEdit *edit)
 {
-    long c;
-    unsigned long sp = edit->undo_stack_pointer;
-
-    if (sp == edit->undo_stack_bottom)
-        return STACK_BOTTOM;
-
-    sp = (sp - 1) & edit->undo_stack_size_mask;
-    c = edit->undo_stack[sp];
-    if (c >= 0)
-        return c;
-
-    if (sp == edit->undo_stack_bottom)
-        return STACK_BOTTOM;
-
-    c = edit->undo_stack[(sp - 1) & edit->undo_stack_size_mask];
-    return c;
+    return edit_undo_stack_get_top (&edit->undo_stack);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -2145,6 +2080,7 @@ edit_init (WEdit *edit, const WRect *r, const edit_arg_t *arg)
     edit->over_col = 0;
     edit->bracket = -1;
     edit->last_bracket = -1;
+    edit->syntax_changed = -1;
     edit->force |= REDRAW_PAGE;
 
     // set file name before load file
@@ -2159,13 +2095,8 @@ edit_init (WEdit *edit, const WRect *r, const edit_arg_t *arg)
         line = 0;
     }
 
-    edit->undo_stack_size = START_STACK_SIZE;
-    edit->undo_stack_size_mask = START_STACK_SIZE - 1;
-    edit->undo_stack = g_malloc0 ((edit->undo_stack_size + 10) * sizeof (long));
-
-    edit->redo_stack_size = START_STACK_SIZE;
-    edit->redo_stack_size_mask = START_STACK_SIZE - 1;
-    edit->redo_stack = g_malloc0 ((edit->redo_stack_size + 10) * sizeof (long));
+    edit_undo_stack_init (&edit->undo_stack);
+    edit_undo_stack_init (&edit->redo_stack);
 
     edit->utf8 = FALSE;
     edit->converter = str_cnv_from_term;
@@ -2227,11 +2158,12 @@ edit_clean (WEdit *edit)
 
     edit_free_syntax_rules (edit);
     book_mark_flush (edit, -1);
+    edit_complete_index_free (edit);
 
     edit_buffer_clean (&edit->buffer);
 
-    g_free (edit->undo_stack);
-    g_free (edit->redo_stack);
+    edit_undo_stack_clean (&edit->undo_stack);
+    edit_undo_stack_clean (&edit->redo_stack);
     vfs_path_free (edit->filename_vpath, TRUE);
     vfs_path_free (edit->dir_vpath, TRUE);
     edit_search_deinit (edit);
@@ -2304,30 +2236,30 @@ edit_set_codeset (WEdit *edit)
         edit->utf8 = str_isutf8 (cp_id);
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get memory limit of undo and redo stacks. The limit is large enough to undo the
+ * change of the whole file without multiplying memory use.
+ */
+
+unsigned long
+edit_undo_max_size (const WEdit *edit)
+{
+    const unsigned long size = (unsigned long) max_undo * sizeof (long);
+
+    return MAX (size, (unsigned long) edit->buffer.size);
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 /**
  * Recording stack for undo:
- * The following is an implementation of a compressed stack. Identical
- * pushes are recorded by a negative prefix indicating the number of times the
- * same char was pushed. This saves space for repeated curs-left or curs-right
- * delete etc.
- *
- * eg:
+ * Actions are kept in a compact stack (see editundo.c). Identical
+ * pushes are recorded once with the number of times the same action was
+ * pushed. This saves space for repeated curs-left or curs-right, inserted
+ * text etc. Deleted text takes about one byte per byte.
  *
- * pushed:       stored:
- *
- * a
- * b             a
- * b            -3
- * b             b
- * c  -->       -4
- * c             c
- * c             d
- * c
- * d
- *
- * If the stack long int is 0-255 it represents a normal insert (from a backspace),
+ * If the action code is 0-255 it represents a normal insert (from a backspace),
  * 256-512 is an insert ahead (from a delete), If it is between 600 and 700 it is one
  * of the cursor functions define'd in edit-impl.h. 1000 through 700'000'000 is to
  * set edit->mark1 position. 700'000'000 through 1400'000'000 is to set edit->mark2
@@ -2353,28 +2285,6 @@ edit_set_codeset (WEdit *edit)
 void
 edit_push_undo_action (WEdit *edit, long c)
 {
-    unsigned long sp = edit->undo_stack_pointer;
-    unsigned long spm1;
-
-    // first enlarge the stack if necessary
-    if (sp > edit->undo_stack_size - 10)
-    {  // say
-        if (max_undo < 256)
-            max_undo = 256;
-        if (edit->undo_stack_size < (unsigned long) max_undo)
-        {
-            long *t;
-
-            t = g_realloc (edit->undo_stack, (edit->undo_stack_size * 2 + 10) * sizeof (long));
-            if (t != NULL)
-            {
-                edit->undo_stack = t;
-                edit->undo_stack_size <<= 1;
-                edit->undo_stack_size_mask = edit->undo_stack_size - 1;
-            }
-        }
-    }
-    spm1 = (edit->undo_stack_pointer - 1) & edit->undo_stack_size_mask;
     if (edit->undo_stack_disable)
     {
         edit_push_redo_action (edit, KEY_PRESS);
@@ -2383,60 +2293,9 @@ edit_push_undo_action (WEdit *edit, long c)
     }
 
     if (edit->redo_stack_reset)
-        edit->redo_stack_bottom = edit->redo_stack_pointer = 0;
-
-    if (edit->undo_stack_bottom != sp && spm1 != edit->undo_stack_bottom
-        && ((sp - 2) & edit->undo_stack_size_mask) != edit->undo_stack_bottom)
-    {
-        long d;
+        edit_undo_stack_clear (&edit->redo_stack);
 
-        if (edit->undo_stack[spm1] < 0)
-        {
-            d = edit->undo_stack[(sp - 2) & edit->undo_stack_size_mask];
-            if (d == c && edit->undo_stack[spm1] > -1000000000)
-            {
-                if (c < KEY_PRESS)  // --> no need to push multiple do-nothings
-                    edit->undo_stack[spm1]--;
-                return;
-            }
-        }
-        else
-        {
-            d = edit->undo_stack[spm1];
-            if (d == c)
-            {
-                if (c >= KEY_PRESS)
-                    return;  // --> no need to push multiple do-nothings
-                edit->undo_stack[sp] = -2;
-                goto check_bottom;
-            }
-        }
-    }
-    edit->undo_stack[sp] = c;
-
-check_bottom:
-    edit->undo_stack_pointer = (edit->undo_stack_pointer + 1) & edit->undo_stack_size_mask;
-
-    /* if the sp wraps round and catches the undo_stack_bottom then erase
-     * the first set of actions on the stack to make space - by moving
-     * undo_stack_bottom forward one "key press" */
-    c = (edit->undo_stack_pointer + 2) & edit->undo_stack_size_mask;
-    if ((unsigned long) c == edit->undo_stack_bottom
-        || (((unsigned long) c + 1) & edit->undo_stack_size_mask) == edit->undo_stack_bottom)
-        do
-        {
-            edit->undo_stack_bottom = (edit->undo_stack_bottom + 1) & edit->undo_stack_size_mask;
-        }
-        while (edit->undo_stack[edit->undo_stack_bottom] < KEY_PRESS
-               && edit->undo_stack_bottom != edit->undo_stack_pointer);
-
-    // If a single key produced enough pushes to wrap all the way round then we would notice that
-    // the [undo_stack_bottom] does not contain KEY_PRESS. The stack is then initialised:
-    if (edit->undo_stack_pointer != edit->undo_stack_bottom
-        && edit->undo_stack[edit->undo_stack_bottom] < KEY_PRESS)
-    {
-        edit->undo_stack_bottom = edit->undo_stack_pointer = 0;
-    }
+    edit_undo_stack_push (&edit->undo_stack, c, edit_undo_max_size (edit));
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -2444,82 +2303,7 @@ check_bottom:
 void
 edit_push_redo_action (WEdit *edit, long c)
 {
-    unsigned long sp = edit->redo_stack_pointer;
-    unsigned long spm1;
-    // first enlarge the stack if necessary
-    if (sp > edit->redo_stack_size - 10)
-    {  // say
-        if (max_undo < 256)
-            max_undo = 256;
-        if (edit->redo_stack_size < (unsigned long) max_undo)
-        {
-            long *t;
-
-            t = g_realloc (edit->redo_stack, (edit->redo_stack_size * 2 + 10) * sizeof (long));
-            if (t != NULL)
-            {
-                edit->redo_stack = t;
-                edit->redo_stack_size <<= 1;
-                edit->redo_stack_size_mask = edit->redo_stack_size - 1;
-            }
-        }
-    }
-    spm1 = (edit->redo_stack_pointer - 1) & edit->redo_stack_size_mask;
-
-    if (edit->redo_stack_bottom != sp && spm1 != edit->redo_stack_bottom
-        && ((sp - 2) & edit->redo_stack_size_mask) != edit->redo_stack_bottom)
-    {
-        long d;
-
-        if (edit->redo_stack[spm1] < 0)
-        {
-            d = edit->redo_stack[(sp - 2) & edit->redo_stack_size_mask];
-            if (d == c && edit->redo_stack[spm1] > -1000000000)
-            {
-                if (c < KEY_PRESS)  // --> no need to push multiple do-nothings
-                    edit->redo_stack[spm1]--;
-                return;
-            }
-        }
-        else
-        {
-            d = edit->redo_stack[spm1];
-            if (d == c)
-            {
-                if (c >= KEY_PRESS)
-                    return;  // --> no need to push multiple do-nothings
-                edit->redo_stack[sp] = -2;
-                goto redo_check_bottom;
-            }
-        }
-    }
-    edit->redo_stack[sp] = c;
-
-redo_check_bottom:
-    edit->redo_stack_pointer = (edit->redo_stack_pointer + 1) & edit->redo_stack_size_mask;
-
-    /* if the sp wraps round and catches the redo_stack_bottom then erase
-     * the first set of actions on the stack to make space - by moving
-     * redo_stack_bottom forward one "key press" */
-    c = (edit->redo_stack_pointer + 2) & edit->redo_stack_size_mask;
-    if ((unsigned long) c == edit->redo_stack_bottom
-        || (((unsigned long) c + 1) & edit->redo_stack_size_mask) == edit->redo_stack_bottom)
-        do
-        {
-            edit->redo_stack_bottom = (edit->redo_stack_bottom + 1) & edit->redo_stack_size_mask;
-        }
-        while (edit->redo_stack[edit->redo_stack_bottom] < KEY_PRESS
-               && edit->redo_stack_bottom != edit->redo_stack_pointer);
-
-    /*
-     * If a single key produced enough pushes to wrap all the way round then
-     * we would notice that the [redo_stack_bottom] does not contain KEY_PRESS.
-     * The stack is then initialised:
-     */
-
-    if (edit->redo_stack_pointer != edit->redo_stack_bottom
-        && edit->redo_stack[edit->redo_stack_bottom] < KEY_PRESS)
-        edit->redo_stack_bottom = edit->redo_stack_pointer = 0;
+    edit_undo_stack_push (&edit->redo_stack, c, edit_undo_max_size (edit));
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -2560,7 +2344,8 @@ edit_insert (WEdit *edit, int c)
     // update markers
     edit->mark1 += (edit->mark1 > edit->buffer.curs1) ? 1 : 0;
     edit->mark2 += (edit->mark2 > edit->buffer.curs1) ? 1 : 0;
-    edit->last_get_rule += (edit->last_get_rule > edit->buffer.curs1) ? 1 : 0;
+    edit_syntax_invalidate (edit, edit->buffer.curs1);
+    edit_complete_index_change (edit, edit->buffer.curs1, 1);
 
     edit_buffer_insert (&edit->buffer, c);
 }
@@ -2592,7 +2377,8 @@ edit_insert_ahead (WEdit *edit, int c)
 
     edit->mark1 += (edit->mark1 >= edit->buffer.curs1) ? 1 : 0;
     edit->mark2 += (edit->mark2 >= edit->buffer.curs1) ? 1 : 0;
-    edit->last_get_rule += (edit->last_get_rule >= edit->buffer.curs1) ? 1 : 0;
+    edit_syntax_invalidate (edit, edit->buffer.curs1);
+    edit_complete_index_change (edit, edit->buffer.curs1, 1);
 
     edit_buffer_insert_ahead (&edit->buffer, c);
 }
@@ -2642,8 +2428,8 @@ edit_delete (WEdit *edit, gboolean byte_delete)
         }
         if (edit->mark2 > edit->buffer.curs1)
             edit->mark2--;
-        if (edit->last_get_rule > edit->buffer.curs1)
-            edit->last_get_rule--;
+        edit_syntax_invalidate (edit, edit->buffer.curs1);
+        edit_complete_index_change (edit, edit->buffer.curs1, -1);
 
         p = edit_buffer_delete (&edit->buffer);
 
@@ -2698,8 +2484,8 @@ edit_backspace (WEdit *edit, gboolean byte_delete)
         }
         if (edit->mark2 >= edit->buffer.curs1)
             edit->mark2--;
-        if (edit->last_get_rule >= edit->buffer.curs1)
-            edit->last_get_rule--;
+        edit_syntax_invalidate (edit, edit->buffer.curs1 - 1);
+        edit_complete_index_change (edit, edit->buffer.curs1 - 1, -1);
 
         p = edit_buffer_backspace (&edit->buffer);
 
@@ -4104,6 +3890,8 @@ edit_stack_free (void)
 {
     for (edit_stack_iterator = 0; edit_stack_iterator < MAX_HISTORY_MOVETO; edit_stack_iterator++)
         vfs_path_free (edit_history_moveto[edit_stack_iterator].file_vpath, TRUE);
+
+    etags_cache_free ();
 }
 
 /* --------------------------------------------------------------------------------------------- */
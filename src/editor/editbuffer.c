@@ -71,6 +71,12 @@
  *
  *
  * This is called a "gap buffer".
+ *
+ * For each buffer, the number of newlines in it and all previous buffers of the same array
+ * is kept in b1_lines and b2_lines. Only the last buffers of b1 and b2 are changed while editing,
+ * so the index is updated in constant time. Line numbers are converted to offsets and back
+ * by binary search in the index and scanning of one buffer, regardless of file size.
+ *
  * See also:
  * https://en.wikipedia.org/wiki/Gap_buffer
  * https://stackoverflow.com/questions/4199694/data-structure-for-text-editor
@@ -96,6 +102,12 @@
 /* Buffer mask (used to find cursor position relative to the buffer) */
 #define M_EDIT_BUF_SIZE (EDIT_BUF_SIZE - 1)
 
+/* Moving by fewer lines is done by scanning, by more lines -- using the line index */
+#define EDIT_BUF_SCAN_LINES 32
+
+/* Number of newlines in the buffers from first one up to the specified one */
+#define edit_buffer_lines_upto(lines, i) ((i) < 0 ? 0 : g_array_index ((lines), long, (i)))
+
 /*** file scope type declarations ****************************************************************/
 
 /*** forward declarations (file scope functions) *************************************************/
@@ -134,6 +146,189 @@ edit_buffer_get_byte_ptr (const edit_buffer_t *buf, off_t byte_index)
     return (char *) b + (byte_index & M_EDIT_BUF_SIZE);
 }
 
+/* --------------------------------------------------------------------------------------------- */
+
+static long
+edit_buffer_count_newlines (const char *p, off_t len)
+{
+    const char *end = p + len;
+    long lines = 0;
+
+    // memchr() is vectorized by libc
+    while (p < end && (p = memchr (p, '\n', end - p)) != NULL)
+    {
+        lines++;
+        p++;
+    }
+
+    return lines;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get pointer to the contiguous block of bytes ending at specified index.
+ *
+ * @param buf pointer to editor buffer
+ * @param byte_index index of the last byte of block, must be in range [0, file size)
+ * @param len length of returned block
+ *
+ * @return pointer to the first byte of block
+ */
+
+static const char *
+edit_buffer_get_block_backward (const edit_buffer_t *buf, off_t byte_index, off_t *len)
+{
+    if (byte_index >= buf->curs1)
+    {
+        const off_t p = buf->curs1 + buf->curs2 - byte_index - 1;
+
+        // bytes before byte_index are at the beginning of the b2 page
+        *len = MIN (M_EDIT_BUF_SIZE - (p & M_EDIT_BUF_SIZE), buf->curs2 - 1 - p) + 1;
+    }
+    else
+        *len = (byte_index & M_EDIT_BUF_SIZE) + 1;
+
+    return edit_buffer_get_byte_ptr (buf, byte_index) - *len + 1;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Add the line count of new last buffer to the index.
+ */
+
+static inline void
+edit_buffer_lines_add (GArray *lines, long n)
+{
+    n += edit_buffer_lines_upto (lines, (long) lines->len - 1);
+    g_array_append_val (lines, n);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Change the line count of the last buffer in the index.
+ */
+
+static inline void
+edit_buffer_lines_change (GArray *lines, long delta)
+{
+    g_array_index (lines, long, lines->len - 1) += delta;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Find the first buffer containing the n-th newline of the array.
+ */
+
+static long
+edit_buffer_lines_find (const GArray *lines, long n)
+{
+    long lo = 0;
+    long hi = (long) lines->len - 1;
+
+    while (lo < hi)
+    {
+        const long mid = lo + (hi - lo) / 2;
+
+        if (g_array_index (lines, long, mid) < n)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static inline long
+edit_buffer_lines_total (const edit_buffer_t *buf)
+{
+    return edit_buffer_lines_upto (buf->b1_lines, (long) buf->b1->len - 1)
+        + edit_buffer_lines_upto (buf->b2_lines, (long) buf->b2->len - 1);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Count newlines before specified offset using line index.
+ *
+ * @param buf editor buffer
+ * @param offset byte offset in range [0, file size]
+ *
+ * @return number of newlines in range [0, offset)
+ */
+
+static long
+edit_buffer_lines_before (const edit_buffer_t *buf, off_t offset)
+{
+    off_t i;
+    long lines_b1, lines_after;
+
+    if (offset <= buf->curs1)
+    {
+        i = offset >> S_EDIT_BUF_SIZE;
+        lines_b1 = edit_buffer_lines_upto (buf->b1_lines, i - 1);
+        if ((offset & M_EDIT_BUF_SIZE) != 0)
+            lines_b1 += edit_buffer_count_newlines (g_ptr_array_index (buf->b1, i),
+                                                    offset & M_EDIT_BUF_SIZE);
+        return lines_b1;
+    }
+
+    // count newlines in b2 from the end of file up to offset
+    offset = buf->curs1 + buf->curs2 - offset;
+    i = offset >> S_EDIT_BUF_SIZE;
+    lines_after = edit_buffer_lines_upto (buf->b2_lines, i - 1);
+    if ((offset & M_EDIT_BUF_SIZE) != 0)
+        lines_after += edit_buffer_count_newlines ((char *) g_ptr_array_index (buf->b2, i)
+                                                       + EDIT_BUF_SIZE - (offset & M_EDIT_BUF_SIZE),
+                                                   offset & M_EDIT_BUF_SIZE);
+
+    return edit_buffer_lines_total (buf) - lines_after;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Find the n-th newline using line index.
+ *
+ * @param buf editor buffer
+ * @param n newline number, 1 for the first one; must not exceed number of newlines in the buffer
+ *
+ * @return offset of newline
+ */
+
+static off_t
+edit_buffer_find_newline (const edit_buffer_t *buf, long n)
+{
+    const long lines_b1 = edit_buffer_lines_upto (buf->b1_lines, (long) buf->b1->len - 1);
+    long i;
+    const char *b;
+    off_t j;
+
+    if (n <= lines_b1)
+    {
+        i = edit_buffer_lines_find (buf->b1_lines, n);
+        n -= edit_buffer_lines_upto (buf->b1_lines, i - 1);
+        b = (const char *) g_ptr_array_index (buf->b1, i);
+
+        for (j = 0;; j++)
+        {
+            j = (const char *) memchr (b + j, '\n', EDIT_BUF_SIZE - j) - b;
+            if (--n == 0)
+                return ((off_t) i << S_EDIT_BUF_SIZE) + j;
+        }
+    }
+
+    // count newlines in b2 from the end of file
+    n = edit_buffer_lines_total (buf) - n + 1;
+    i = edit_buffer_lines_find (buf->b2_lines, n);
+    n -= edit_buffer_lines_upto (buf->b2_lines, i - 1);
+    b = (const char *) g_ptr_array_index (buf->b2, i);
+
+    for (j = EDIT_BUF_SIZE - 1;; j--)
+        if (b[j] == '\n' && --n == 0)
+            return buf->curs1 + buf->curs2 - 1 - ((off_t) i << S_EDIT_BUF_SIZE)
+                - (EDIT_BUF_SIZE - 1 - j);
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /*** public functions ****************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -148,6 +343,8 @@ edit_buffer_init (edit_buffer_t *buf, off_t size)
 {
     buf->b1 = g_ptr_array_new_full (32, g_free);
     buf->b2 = g_ptr_array_new_full (32, g_free);
+    buf->b1_lines = g_array_sized_new (FALSE, FALSE, sizeof (long), 32);
+    buf->b2_lines = g_array_sized_new (FALSE, FALSE, sizeof (long), 32);
 
     buf->curs1 = 0;
     buf->curs2 = 0;
@@ -171,6 +368,12 @@ edit_buffer_clean (edit_buffer_t *buf)
 
     if (buf->b2 != NULL)
         g_ptr_array_free (buf->b2, TRUE);
+
+    if (buf->b1_lines != NULL)
+        g_array_free (buf->b1_lines, TRUE);
+
+    if (buf->b2_lines != NULL)
+        g_array_free (buf->b2_lines, TRUE);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -193,6 +396,41 @@ edit_buffer_get_byte (const edit_buffer_t *buf, off_t byte_index)
     return (p != NULL) ? *(unsigned char *) p : '\n';
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get pointer to the contiguous block of bytes starting at specified index.
+ *
+ * @param buf pointer to editor buffer
+ * @param byte_index byte index
+ * @param len length of returned block
+ *
+ * @return NULL if byte_index is negative or not less than file size; pointer to the block
+ *         otherwise. The block is valid until the buffer is modified.
+ */
+
+const char *
+edit_buffer_get_block (const edit_buffer_t *buf, off_t byte_index, gsize *len)
+{
+    const char *p;
+
+    p = edit_buffer_get_byte_ptr (buf, byte_index);
+    if (p == NULL)
+        return NULL;
+
+    if (byte_index >= buf->curs1)
+    {
+        const off_t b2_index = buf->curs1 + buf->curs2 - byte_index - 1;
+
+        // b2 pages are filled from the end, but bytes in each page are in direct order
+        *len = (gsize) (b2_index & M_EDIT_BUF_SIZE) + 1;
+    }
+    else
+        *len = (gsize) MIN (EDIT_BUF_SIZE - (byte_index & M_EDIT_BUF_SIZE),
+                            buf->curs1 - byte_index);
+
+    return p;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 /**
@@ -328,9 +566,19 @@ edit_buffer_count_lines (const edit_buffer_t *buf, off_t first, off_t last)
     first = MAX (first, 0);
     last = MIN (last, buf->size);
 
+    if (last - first > EDIT_BUF_SIZE)
+        return edit_buffer_lines_before (buf, last) - edit_buffer_lines_before (buf, first);
+
     while (first < last)
-        if (edit_buffer_get_byte (buf, first++) == '\n')
-            lines++;
+    {
+        const char *b;
+        gsize len;
+
+        b = edit_buffer_get_block (buf, first, &len);
+        len = MIN (len, (gsize) (last - first));
+        lines += edit_buffer_count_newlines (b, (off_t) len);
+        first += (off_t) len;
+    }
 
     return lines;
 }
@@ -351,10 +599,25 @@ edit_buffer_get_bol (const edit_buffer_t *buf, off_t current)
     if (current <= 0)
         return 0;
 
-    for (; edit_buffer_get_byte (buf, current - 1) != '\n'; current--)
-        ;
+    // edit_buffer_get_byte() returns '\n' beyond the end of file
+    if (current > buf->size)
+        return current;
 
-    return current;
+    while (current > 0)
+    {
+        const char *b;
+        off_t len, i;
+
+        b = edit_buffer_get_block_backward (buf, current - 1, &len);
+
+        for (i = len; i > 0; i--)
+            if (b[i - 1] == '\n')
+                return current - len + i;
+
+        current -= len;
+    }
+
+    return 0;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -373,10 +636,24 @@ edit_buffer_get_eol (const edit_buffer_t *buf, off_t current)
     if (current >= buf->size)
         return buf->size;
 
-    for (; edit_buffer_get_byte (buf, current) != '\n'; current++)
-        ;
+    // edit_buffer_get_byte() returns '\n' before the beginning of file
+    if (current < 0)
+        return current;
 
-    return current;
+    while (current < buf->size)
+    {
+        const char *b, *eol;
+        gsize len;
+
+        b = edit_buffer_get_block (buf, current, &len);
+        eol = memchr (b, '\n', len);
+        if (eol != NULL)
+            return current + (eol - b);
+
+        current += (off_t) len;
+    }
+
+    return buf->size;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -495,12 +772,18 @@ edit_buffer_insert (edit_buffer_t *buf, int c)
 
     // add a new buffer if we've reached the end of the last one
     if (i == 0)
+    {
         g_ptr_array_add (buf->b1, g_malloc0 (EDIT_BUF_SIZE));
+        edit_buffer_lines_add (buf->b1_lines, 0);
+    }
 
     // perform the insertion
     b = g_ptr_array_index (buf->b1, buf->curs1 >> S_EDIT_BUF_SIZE);
     *((unsigned char *) b + i) = (unsigned char) c;
 
+    if (c == '\n')
+        edit_buffer_lines_change (buf->b1_lines, 1);
+
     // update cursor position
     buf->curs1++;
 
@@ -527,12 +810,18 @@ edit_buffer_insert_ahead (edit_buffer_t *buf, int c)
 
     // add a new buffer if we've reached the end of the last one
     if (i == 0)
+    {
         g_ptr_array_add (buf->b2, g_malloc0 (EDIT_BUF_SIZE));
+        edit_buffer_lines_add (buf->b2_lines, 0);
+    }
 
     // perform the insertion
     b = g_ptr_array_index (buf->b2, buf->curs2 >> S_EDIT_BUF_SIZE);
     *((unsigned char *) b + EDIT_BUF_SIZE - 1 - i) = (unsigned char) c;
 
+    if (c == '\n')
+        edit_buffer_lines_change (buf->b2_lines, 1);
+
     // update cursor position
     buf->curs2++;
 
@@ -563,6 +852,9 @@ edit_buffer_delete (edit_buffer_t *buf)
     i = prev & M_EDIT_BUF_SIZE;
     c = *((unsigned char *) b + EDIT_BUF_SIZE - 1 - i);
 
+    if (c == '\n')
+        edit_buffer_lines_change (buf->b2_lines, -1);
+
     if (i == 0)
     {
         guint j;
@@ -570,6 +862,7 @@ edit_buffer_delete (edit_buffer_t *buf)
         j = buf->b2->len - 1;
         b = g_ptr_array_index (buf->b2, j);
         g_ptr_array_remove_index (buf->b2, j);
+        g_array_remove_index (buf->b2_lines, j);
     }
 
     buf->curs2 = prev;
@@ -603,6 +896,9 @@ edit_buffer_backspace (edit_buffer_t *buf)
     i = prev & M_EDIT_BUF_SIZE;
     c = *((unsigned char *) b + i);
 
+    if (c == '\n')
+        edit_buffer_lines_change (buf->b1_lines, -1);
+
     if (i == 0)
     {
         guint j;
@@ -610,6 +906,7 @@ edit_buffer_backspace (edit_buffer_t *buf)
         j = buf->b1->len - 1;
         b = g_ptr_array_index (buf->b1, j);
         g_ptr_array_remove_index (buf->b1, j);
+        g_array_remove_index (buf->b1_lines, j);
     }
 
     buf->curs1 = prev;
@@ -642,6 +939,14 @@ edit_buffer_get_forward_offset (const edit_buffer_t *buf, off_t current, long li
 
     lines = MAX (lines, 0);
 
+    if (lines > EDIT_BUF_SCAN_LINES && current >= 0 && current <= buf->size)
+    {
+        const long line = edit_buffer_lines_before (buf, current);
+        const long target = MIN (line + lines, edit_buffer_lines_total (buf));
+
+        return target == line ? current : edit_buffer_find_newline (buf, target) + 1;
+    }
+
     while (lines-- != 0)
     {
         long next;
@@ -670,6 +975,14 @@ off_t
 edit_buffer_get_backward_offset (const edit_buffer_t *buf, off_t current, long lines)
 {
     lines = MAX (lines, 0);
+
+    if (lines > EDIT_BUF_SCAN_LINES && current >= 0 && current <= buf->size)
+    {
+        const long target = edit_buffer_lines_before (buf, current) - lines;
+
+        return target <= 0 ? 0 : edit_buffer_find_newline (buf, target) + 1;
+    }
+
     current = edit_buffer_get_bol (buf, current);
 
     while (lines-- != 0 && current != 0)
@@ -694,7 +1007,8 @@ edit_buffer_read_file (edit_buffer_t *buf, int fd, off_t size,
                        edit_buffer_read_file_status_msg_t *sm, gboolean *aborted)
 {
     off_t ret = 0;
-    off_t i, j;
+    off_t i;
+    long n;
     off_t data_size;
     void *b;
     status_msg_t *s = STATUS_MSG (sm);
@@ -716,9 +1030,9 @@ edit_buffer_read_file (edit_buffer_t *buf, int fd, off_t size,
         ret = mc_read (fd, b, data_size);
 
         // count lines
-        for (j = 0; j < ret; j++)
-            if (*((char *) b + j) == '\n')
-                buf->lines++;
+        n = edit_buffer_count_newlines (b, MAX (ret, 0));
+        g_array_append_val (buf->b2_lines, n);
+        buf->lines += n;
 
         if (ret < 0 || ret != data_size)
             return ret;
@@ -737,9 +1051,9 @@ edit_buffer_read_file (edit_buffer_t *buf, int fd, off_t size,
             ret += sz;
 
         // count lines
-        for (j = 0; j < sz; j++)
-            if (*((char *) b + j) == '\n')
-                buf->lines++;
+        n = edit_buffer_count_newlines (b, MAX (sz, 0));
+        g_array_append_val (buf->b2_lines, n);
+        buf->lines += n;
 
         if (s != NULL && s->update != NULL)
         {
@@ -775,6 +1089,11 @@ edit_buffer_read_file (edit_buffer_t *buf, int fd, off_t size,
         *b1 = *b2;
         *b2 = b;
 
+        n = g_array_index (buf->b2_lines, long, i);
+        g_array_index (buf->b2_lines, long, i) =
+            g_array_index (buf->b2_lines, long, buf->b2->len - 1 - i);
+        g_array_index (buf->b2_lines, long, buf->b2->len - 1 - i) = n;
+
         if (s != NULL && s->update != NULL)
         {
             update_cnt = (update_cnt + 1) & 0xf;
@@ -790,6 +1109,10 @@ edit_buffer_read_file (edit_buffer_t *buf, int fd, off_t size,
         }
     }
 
+    // make the line index cumulative
+    for (i = 1; i < (off_t) buf->b2_lines->len; i++)
+        g_array_index (buf->b2_lines, long, i) += g_array_index (buf->b2_lines, long, i - 1);
+
     return ret;
 }
 
@@ -13,13 +13,15 @@
 
 typedef struct edit_buffer_struct
 {
-    off_t curs1;     // position of the cursor from the beginning of the file.
-    off_t curs2;     // position from the end of the file
-    GPtrArray *b1;   // all data up to curs1
-    GPtrArray *b2;   // all data from end of file down to curs2
-    off_t size;      // file size
-    long lines;      // total lines in the file
-    long curs_line;  // line number of the cursor.
+    off_t curs1;       // position of the cursor from the beginning of the file.
+    off_t curs2;       // position from the end of the file
+    GPtrArray *b1;     // all data up to curs1
+    GPtrArray *b2;     // all data from end of file down to curs2
+    GArray *b1_lines;  // number of newlines in b1 buffers from first one up to each one
+    GArray *b2_lines;  // number of newlines in b2 buffers from first one up to each one
+    off_t size;        // file size
+    long lines;        // total lines in the file
+    long curs_line;    // line number of the cursor.
 } edit_buffer_t;
 
 typedef struct edit_buffer_read_file_status_msg_struct
@@ -39,6 +41,7 @@ void edit_buffer_init (edit_buffer_t *buf, off_t size);
 void edit_buffer_clean (edit_buffer_t *buf);
 
 int edit_buffer_get_byte (const edit_buffer_t *buf, off_t byte_index);
+const char *edit_buffer_get_block (const edit_buffer_t *buf, off_t byte_index, gsize *len);
 int edit_buffer_get_utf (const edit_buffer_t *buf, off_t byte_index, int *char_length);
 int edit_buffer_get_prev_utf (const edit_buffer_t *buf, off_t byte_index, int *char_length);
 long edit_buffer_count_lines (const edit_buffer_t *buf, off_t first, off_t last);
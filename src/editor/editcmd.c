@@ -507,7 +507,7 @@ edit_block_delete (WEdit *edit, off_t start_mark, off_t end_mark)
         edit_mark_cmd (edit, FALSE);
 
     // Warning message with a query to continue or cancel the operation
-    if ((end_mark - start_mark) > max_undo / 2
+    if ((unsigned long) (end_mark - start_mark) > edit_undo_max_size (edit) / 2
         && edit_query_dialog2 (_ ("Warning"),
                                ("Block is large, you may not be able to undo this action"),
                                _ ("C&ontinue"), _ ("&Cancel"))
@@ -25,21 +25,16 @@
 
 #include <config.h>
 
-#include <ctype.h>  // isspace()
 #include <string.h>
 
 #include "lib/global.h"
-#include "lib/search.h"
 #include "lib/strutil.h"
 #include "lib/charsets.h"  // str_convert_to_input()
 #include "lib/tty/tty.h"   // LINES, COLS
 #include "lib/widget.h"
 
-#include "src/setup.h"  // verbose
-
 #include "editwidget.h"
 #include "edit-impl.h"
-#include "editsearch.h"
 
 #include "editcomplete.h"
 
@@ -47,8 +42,42 @@
 
 /*** file scope macro definitions ****************************************************************/
 
+/* longer words are not indexed */
+#define WORD_MAX_LEN 256
+
+/* characters which break words besides whitespaces */
+#define WORD_BREAKS  ".=+[](),;:\"'-?/|\\{}*&^%$#@!"
+
 /*** file scope type declarations ****************************************************************/
 
+typedef struct
+{
+    char *word;
+    unsigned int count;  // number of occurrences in the buffer
+} edit_complete_word_t;
+
+typedef void (*edit_complete_word_fn) (const char *word, gpointer data);
+
+/* completions of one buffer ranked by the distance from the cursor */
+typedef struct
+{
+    GHashTable *words;  // candidate words, value is TRUE when the word is met in the buffer
+    GPtrArray *met;     // candidate words in order they are met
+} edit_complete_rank_t;
+
+/*
+ * Index keeps all words of the buffer sorted to find completions by prefix quickly. It is updated
+ * before every change of the buffer: words around the changed byte are removed from the index,
+ * and the changed range is remembered. Typing and pasting extend that range, so its words are
+ * indexed again only when the cursor moves to another place or completion is requested.
+ */
+struct edit_complete_index_t
+{
+    GSequence *words;   // edit_complete_word_t sorted by word
+    off_t dirty_start;  // words touching [dirty_start, dirty_end] are not in the index
+    off_t dirty_end;    // dirty_end < dirty_start if all words are indexed
+};
+
 /*** forward declarations (file scope functions) *************************************************/
 
 /*** file scope variables ************************************************************************/
@@ -57,41 +86,340 @@
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
 
+static inline gboolean
+edit_complete_is_break (int c)
+{
+    return c == '\0' || g_ascii_isspace (c) || strchr (WORD_BREAKS, c) != NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static inline gboolean
+edit_complete_is_word_char (int c)
+{
+    return g_ascii_isalnum (c) || c == '_';
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static int
+edit_complete_word_cmp (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+    (void) user_data;
+
+    return strcmp (((const edit_complete_word_t *) a)->word,
+                   ((const edit_complete_word_t *) b)->word);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+edit_complete_word_free (gpointer data)
+{
+    edit_complete_word_t *w = (edit_complete_word_t *) data;
+
+    g_free (w->word);
+    g_free (w);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+edit_complete_index_word (GSequence *words, const char *word, gboolean add)
+{
+    edit_complete_word_t key;
+    GSequenceIter *i;
+
+    key.word = (char *) word;
+    i = g_sequence_lookup (words, &key, edit_complete_word_cmp, NULL);
+
+    if (add)
+    {
+        if (i != NULL)
+            ((edit_complete_word_t *) g_sequence_get (i))->count++;
+        else
+        {
+            edit_complete_word_t *w;
+
+            w = g_new (edit_complete_word_t, 1);
+            w->word = g_strdup (word);
+            w->count = 1;
+            g_sequence_insert_sorted (words, w, edit_complete_word_cmp, NULL);
+        }
+    }
+    else if (i != NULL && --((edit_complete_word_t *) g_sequence_get (i))->count == 0)
+        g_sequence_remove (i);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+edit_complete_index_add (const char *word, gpointer data)
+{
+    edit_complete_index_word ((GSequence *) data, word, TRUE);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+edit_complete_index_remove (const char *word, gpointer data)
+{
+    edit_complete_index_word ((GSequence *) data, word, FALSE);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Enumerate words of token: sequence of characters between breaks.
+ *
+ * Word is a tail of token that starts at the beginning of token or at the word boundary, like
+ * regular expression "(^|\s+|\b)prefix[^breaks]+" matches it.
+ */
+
+static void
+edit_complete_token_words (const char *token, size_t len, gboolean after_space,
+                           edit_complete_word_fn fn, gpointer data)
+{
+    size_t i;
+
+    for (i = 0; i < len; i++)
+    {
+        gboolean word_start;
+
+        if (i == 0)
+            word_start = after_space || edit_complete_is_word_char (token[0]);
+        else
+            word_start =
+                edit_complete_is_word_char (token[i - 1]) != edit_complete_is_word_char (token[i]);
+
+        if (word_start)
+            fn (token + i, data);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Find token around the byte. Scan stops after WORD_MAX_LEN bytes in each direction.
+ *
+ * @param buf editor buffer
+ * @param offset offset of byte which is not a break
+ * @param start pointer to store the token start
+ * @param end pointer to store the token end (next byte after the token) or the position where
+ *            the scan stopped
+ *
+ * @return TRUE if token is not longer than WORD_MAX_LEN
+ */
+
+static gboolean
+edit_complete_get_token (const edit_buffer_t *buf, off_t offset, off_t *start, off_t *end)
+{
+    off_t s, e;
+
+    for (s = offset; s > 0 && offset - s <= WORD_MAX_LEN; s--)
+        if (edit_complete_is_break (edit_buffer_get_byte (buf, s - 1)))
+            break;
+
+    for (e = offset + 1; e < buf->size && e - offset <= WORD_MAX_LEN; e++)
+        if (edit_complete_is_break (edit_buffer_get_byte (buf, e)))
+            break;
+
+    *start = s;
+    *end = e;
+
+    return e - s <= WORD_MAX_LEN;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Copy token found by edit_complete_get_token() and enumerate its words.
+ */
+
+static void
+edit_complete_read_token (const edit_buffer_t *buf, off_t start, off_t end,
+                          edit_complete_word_fn fn, gpointer data)
+{
+    char token[WORD_MAX_LEN + 1];
+    gboolean after_space;
+    off_t i;
+
+    for (i = start; i < end; i++)
+        token[i - start] = (char) edit_buffer_get_byte (buf, i);
+    token[end - start] = '\0';
+
+    after_space = start == 0 || g_ascii_isspace (edit_buffer_get_byte (buf, start - 1));
+
+    edit_complete_token_words (token, (size_t) (end - start), after_space, fn, data);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Add or remove words of tokens touching the range of bytes. Tokens touching the dirty range are
+ * skipped: they are not in the index.
+ */
+
+static void
+edit_complete_index_range (WEdit *edit, off_t from, off_t to, gboolean add)
+{
+    const edit_buffer_t *buf = &edit->buffer;
+    edit_complete_index_t *idx = edit->completion_index;
+    off_t offset;
+
+    from = MAX (from, 0);
+    to = MIN (to, buf->size - 1);
+
+    for (offset = from; offset <= to;)
+    {
+        off_t start, end;
+
+        if (edit_complete_is_break (edit_buffer_get_byte (buf, offset)))
+        {
+            offset++;
+            continue;
+        }
+
+        if (edit_complete_get_token (buf, offset, &start, &end)
+            && (start > idx->dirty_end || end <= idx->dirty_start))
+            edit_complete_read_token (buf, start, end,
+                                      add ? edit_complete_index_add : edit_complete_index_remove,
+                                      idx->words);
+
+        offset = end;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Index words of the dirty range */
+
+static void
+edit_complete_index_flush (WEdit *edit)
+{
+    edit_complete_index_t *idx = edit->completion_index;
+    off_t from, to;
+
+    if (idx->dirty_end < idx->dirty_start)
+        return;
+
+    from = idx->dirty_start;
+    to = idx->dirty_end;
+    idx->dirty_start = 0;
+    idx->dirty_end = -1;
+
+    edit_complete_index_range (edit, from, to, TRUE);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Get up-to-date index of words. Index is created on demand */
+
+static GSequence *
+edit_complete_get_words (WEdit *edit)
+{
+    if (edit->completion_index == NULL)
+    {
+        edit->completion_index = g_new (edit_complete_index_t, 1);
+        edit->completion_index->words = g_sequence_new (edit_complete_word_free);
+        // index entire buffer
+        edit->completion_index->dirty_start = 0;
+        edit->completion_index->dirty_end = edit->buffer.size - 1;
+    }
+
+    edit_complete_index_flush (edit);
+
+    return edit->completion_index->words;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+edit_complete_rank_word (const char *word, gpointer data)
+{
+    edit_complete_rank_t *rank = (edit_complete_rank_t *) data;
+    gpointer key, met;
+
+    if (g_hash_table_lookup_extended (rank->words, word, &key, &met) && met == NULL)
+    {
+        g_hash_table_insert (rank->words, key, GINT_TO_POINTER (TRUE));
+        g_ptr_array_add (rank->met, key);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Rank candidate words by their nearest occurrence to the cursor. Tokens are scanned from the
+ * cursor in both directions, nearest token first, until all candidates are met.
+ *
+ * @param buf editor buffer
+ * @param rank candidate words
+ * @param cursor offset of the cursor
+ * @param last_byte scan stops before this offset
+ */
+
+static void
+edit_complete_rank_words (const edit_buffer_t *buf, edit_complete_rank_t *rank, off_t cursor,
+                          off_t last_byte)
+{
+    off_t back = cursor - 1;
+    off_t forward = cursor;
+
+    last_byte = MIN (last_byte, buf->size);
+
+    while (rank->met->len < g_hash_table_size (rank->words) && (back >= 0 || forward < last_byte))
+    {
+        gboolean backward;
+        off_t offset, start, end;
+
+        backward = back >= 0 && (forward >= last_byte || cursor - back <= forward - cursor);
+        offset = backward ? back : forward;
+
+        if (edit_complete_is_break (edit_buffer_get_byte (buf, offset)))
+        {
+            start = offset;
+            end = offset + 1;
+        }
+        else if (edit_complete_get_token (buf, offset, &start, &end))
+            edit_complete_read_token (buf, start, end, edit_complete_rank_word, rank);
+
+        if (backward)
+            back = start - 1;
+        else
+            forward = end;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 /**
  * Get current word under cursor
  *
- * @param esm status message window
- * @param srch mc_search object
+ * @param edit editor object
  * @param word_start start word position
+ * @param word_len length of word before cursor
  *
- * @return newly allocated string or NULL if no any words under cursor
+ * @return newly allocated string or NULL if word doesn't continue after the cursor
  */
 
 static GString *
-edit_collect_completions_get_current_word (edit_search_status_msg_t *esm, mc_search_t *srch,
-                                           off_t word_start)
+edit_collect_completions_get_current_word (const WEdit *edit, off_t word_start, gsize word_len)
 {
-    WEdit *edit = esm->edit;
-    gsize len = 0;
     GString *temp = NULL;
+    off_t i;
 
-    if (mc_search_run (srch, (void *) esm, word_start, edit->buffer.size, &len))
+    for (i = word_start; i < edit->buffer.size; i++)
     {
-        off_t i;
+        int chr;
 
-        for (i = 0; i < (off_t) len; i++)
-        {
-            int chr;
+        chr = edit_buffer_get_byte (&edit->buffer, i);
+        if (edit_complete_is_break (chr))
+            break;
 
-            chr = edit_buffer_get_byte (&edit->buffer, word_start + i);
-            if (!isspace (chr))
-            {
-                if (temp == NULL)
-                    temp = g_string_sized_new (len);
+        if (temp == NULL)
+            temp = g_string_sized_new (16);
 
-                g_string_append_c (temp, chr);
-            }
-        }
+        g_string_append_c (temp, chr);
+    }
+
+    if (temp != NULL && temp->len <= word_len)
+    {
+        g_string_free (temp, TRUE);
+        temp = NULL;
     }
 
     return temp;
@@ -100,112 +428,86 @@ edit_collect_completions_get_current_word (edit_search_status_msg_t *esm, mc_sea
 /* --------------------------------------------------------------------------------------------- */
 /**
  * collect the possible completions from one buffer
+ *
+ * Completions are words of the index which start with prefix and occur before last_byte.
+ * They are added nearest to the cursor first.
  */
 
 static void
-edit_collect_completion_from_one_buffer (gboolean active_buffer, GQueue **compl, mc_search_t *srch,
-                                         edit_search_status_msg_t *esm, off_t word_start,
-                                         gsize word_len, off_t last_byte, GString *current_word,
+edit_collect_completion_from_one_buffer (WEdit *edit, GQueue **compl, GHashTable *added,
+                                         const char *prefix, gsize word_len, off_t word_start,
+                                         off_t last_byte, const GString *current_word,
                                          int *max_width)
 {
-    GString *temp = NULL;
-    gsize len = 0;
-    off_t start = -1;
+    GSequence *words;
+    GSequenceIter *i;
+    edit_complete_word_t key;
+    edit_complete_rank_t rank;
+    guint j;
 
-    while (mc_search_run (srch, (void *) esm, start + 1, last_byte, &len))
-    {
-        gsize i;
-        int width;
+    words = edit_complete_get_words (edit);
 
-        if (temp == NULL)
-            temp = g_string_sized_new (8);
-        else
-            g_string_set_size (temp, 0);
+    // words are owned by the index
+    rank.words = g_hash_table_new (g_str_hash, g_str_equal);
 
-        start = srch->normal_offset;
+    key.word = (char *) prefix;
 
-        // add matched completion if not yet added
-        for (i = 0; i < len; i++)
-        {
-            int ch;
+    for (i = g_sequence_search (words, &key, edit_complete_word_cmp, NULL);
+         !g_sequence_iter_is_end (i); i = g_sequence_iter_next (i))
+    {
+        const edit_complete_word_t *w = (const edit_complete_word_t *) g_sequence_get (i);
 
-            ch = edit_buffer_get_byte (&esm->edit->buffer, start + i);
-            if (isspace (ch))
-                continue;
+        if (strncmp (w->word, prefix, word_len) != 0)
+            break;
 
-            // skip current word
-            if (start + (off_t) i == word_start)
-                break;
+        // skip prefix itself, current word and already added completions
+        if (w->word[word_len] != '\0'
+            && (current_word == NULL || strcmp (w->word, current_word->str) != 0)
+            && g_hash_table_lookup (added, w->word) == NULL)
+            g_hash_table_insert (rank.words, w->word, NULL);
+    }
 
-            g_string_append_c (temp, ch);
-        }
+    if (g_hash_table_size (rank.words) == 0)
+    {
+        g_hash_table_destroy (rank.words);
+        return;
+    }
 
-        if (temp->len == 0)
-            continue;
+    rank.met = g_ptr_array_new ();
+    edit_complete_rank_words (&edit->buffer, &rank, word_start, last_byte);
 
-        if (current_word != NULL && g_string_equal (current_word, temp))
-            continue;
+    for (j = 0; j < rank.met->len; j++)
+    {
+        char *word = (char *) g_ptr_array_index (rank.met, j);
+        GString *temp, *recoded;
+        int width;
 
-        if (*compl == NULL)
-            *compl = g_queue_new ();
-        else
-        {
-            GList *l;
-
-            for (l = g_queue_peek_head_link (*compl); l != NULL; l = g_list_next (l))
-            {
-                GString *s = (GString *) l->data;
-
-                // skip if already added
-                if (strncmp (s->str + word_len, temp->str + word_len, MAX (len, s->len) - word_len)
-                    == 0)
-                    break;
-            }
-
-            if (l != NULL)
-            {
-                /* resort completion in main buffer only:
-                 * these completions must be at the top of list in the completion dialog */
-                if (!active_buffer && l != g_queue_peek_tail_link (*compl))
-                {
-                    // move to the end
-                    g_queue_unlink (*compl, l);
-                    g_queue_push_tail_link (*compl, l);
-                }
+        g_hash_table_insert (added, word, word);
 
-                continue;
-            }
-        }
+        temp = g_string_new (word);
 
+        recoded = str_nconvert_to_display (temp->str, temp->len);
+        if (recoded != NULL)
         {
-            GString *recoded;
+            if (recoded->len != 0)
+                mc_g_string_copy (temp, recoded);
 
-            recoded = str_nconvert_to_display (temp->str, temp->len);
-            if (recoded != NULL)
-            {
-                if (recoded->len != 0)
-                    mc_g_string_copy (temp, recoded);
-
-                g_string_free (recoded, TRUE);
-            }
+            g_string_free (recoded, TRUE);
         }
 
-        if (active_buffer)
-            g_queue_push_tail (*compl, temp);
-        else
-            g_queue_push_head (*compl, temp);
+        if (*compl == NULL)
+            *compl = g_queue_new ();
 
-        start += len;
+        // completions are shown from tail to head
+        g_queue_push_head (*compl, temp);
 
         // note the maximal length needed for the completion dialog
         width = str_term_width1 (temp->str);
         *max_width = MAX (*max_width, width);
-
-        temp = NULL;
     }
 
-    if (temp != NULL)
-        g_string_free (temp, TRUE);
+    g_ptr_array_free (rank.met, TRUE);
+    g_hash_table_destroy (rank.words);
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -214,44 +516,33 @@ edit_collect_completion_from_one_buffer (gboolean active_buffer, GQueue **compl,
  */
 
 static GQueue *
-edit_collect_completions (WEdit *edit, off_t word_start, gsize word_len, const char *match_expr,
-                          int *max_width)
+edit_collect_completions (WEdit *edit, off_t word_start, gsize word_len, int *max_width)
 {
     GQueue *compl = NULL;
-    mc_search_t *srch;
-    off_t last_byte;
+    GHashTable *added;
+    GString *prefix;
     GString *current_word;
     gboolean entire_file, all_files;
-    edit_search_status_msg_t esm;
-
-    srch = mc_search_new (match_expr, cp_source);
-    if (srch == NULL)
-        return NULL;
-
-    entire_file = mc_config_get_bool (mc_global.main_config, CONFIG_APP_SECTION,
-                                      "editor_wordcompletion_collect_entire_file", FALSE);
-
-    last_byte = entire_file ? edit->buffer.size : word_start;
-
-    srch->search_type = MC_SEARCH_T_REGEX;
-    srch->is_case_sensitive = TRUE;
-    srch->search_fn = edit_search_cmd_callback;
-    srch->update_fn = edit_search_update_callback;
+    gsize i;
 
-    esm.first = TRUE;
-    esm.edit = edit;
-    esm.offset = entire_file ? 0 : word_start;
+    prefix = g_string_sized_new (word_len);
+    for (i = 0; i < word_len; i++)
+        g_string_append_c (prefix, edit_buffer_get_byte (&edit->buffer, word_start + i));
 
-    status_msg_init (STATUS_MSG (&esm), _ ("Collect completions"), 1.0, simple_status_msg_init_cb,
-                     edit_search_status_update_cb, NULL);
+    current_word = edit_collect_completions_get_current_word (edit, word_start, word_len);
 
-    current_word = edit_collect_completions_get_current_word (&esm, srch, word_start);
+    // words are owned by indexes of buffers
+    added = g_hash_table_new (g_str_hash, g_str_equal);
 
     *max_width = 0;
 
+    entire_file = mc_config_get_bool (mc_global.main_config, CONFIG_APP_SECTION,
+                                      "editor_wordcompletion_collect_entire_file", FALSE);
+
     // collect completions from current buffer at first
-    edit_collect_completion_from_one_buffer (TRUE, &compl, srch, &esm, word_start, word_len,
-                                             last_byte, current_word, max_width);
+    edit_collect_completion_from_one_buffer (edit, &compl, added, prefix->str, word_len, word_start,
+                                             entire_file ? edit->buffer.size : word_start,
+                                             current_word, max_width);
 
     // collect completions from other buffers
     all_files = mc_config_get_bool (mc_global.main_config, CONFIG_APP_SECTION,
@@ -259,13 +550,8 @@ edit_collect_completions (WEdit *edit, off_t word_start, gsize word_len, const c
     if (all_files)
     {
         const WGroup *owner = CONST_GROUP (CONST_WIDGET (edit)->owner);
-        gboolean saved_verbose;
         GList *w;
 
-        // don't show incorrect percentage in edit_search_status_update_cb()
-        saved_verbose = verbose;
-        verbose = FALSE;
-
         for (w = owner->widgets; w != NULL; w = g_list_next (w))
         {
             Widget *ww = WIDGET (w->data);
@@ -280,20 +566,13 @@ edit_collect_completions (WEdit *edit, off_t word_start, gsize word_len, const c
                 continue;
 
             // search in entire file
-            word_start = 0;
-            last_byte = e->buffer.size;
-            esm.edit = e;
-            esm.offset = 0;
-
-            edit_collect_completion_from_one_buffer (FALSE, &compl, srch, &esm, word_start,
-                                                     word_len, last_byte, current_word, max_width);
+            edit_collect_completion_from_one_buffer (e, &compl, added, prefix->str, word_len, 0,
+                                                     e->buffer.size, current_word, max_width);
         }
-
-        verbose = saved_verbose;
     }
 
-    status_msg_deinit (STATUS_MSG (&esm));
-    mc_search_free (srch);
+    g_hash_table_destroy (added);
+    g_string_free (prefix, TRUE);
     if (current_word != NULL)
         g_string_free (current_word, TRUE);
 
@@ -404,8 +683,7 @@ edit_completion_dialog_show (const WEdit *edit, GQueue *compl, int max_width)
 /* --------------------------------------------------------------------------------------------- */
 
 /**
- * Complete current word using regular expression search
- * backwards beginning at the current cursor position.
+ * Complete current word using words of all buffers.
  */
 
 void
@@ -413,8 +691,6 @@ edit_complete_word_cmd (WEdit *edit)
 {
     off_t word_start = 0;
     gsize word_len = 0;
-    GString *match_expr;
-    gsize i;
     GQueue *compl;  // completions: list of GString*
     int max_width;
 
@@ -422,19 +698,8 @@ edit_complete_word_cmd (WEdit *edit)
     if (!edit_buffer_find_word_start (&edit->buffer, &word_start, &word_len))
         return;
 
-    // prepare match expression
-    // match_expr = g_strdup_printf ("\\b%.*s[a-zA-Z_0-9]+", word_len, bufpos);
-    match_expr = g_string_new ("(^|\\s+|\\b)");
-    for (i = 0; i < word_len; i++)
-        g_string_append_c (match_expr, edit_buffer_get_byte (&edit->buffer, word_start + i));
-    g_string_append (
-        match_expr,
-        "[^\\s\\.=\\+\\[\\]\\(\\)\\,\\;\\:\\\"\\'\\-\\?\\/\\|\\\\\\{\\}\\*\\&\\^\\%%\\$#@\\!]+");
-
     // collect possible completions
-    compl = edit_collect_completions (edit, word_start, word_len, match_expr->str, &max_width);
-
-    g_string_free (match_expr, TRUE);
+    compl = edit_collect_completions (edit, word_start, word_len, &max_width);
 
     if (compl == NULL)
         return;
@@ -467,3 +732,59 @@ edit_complete_word_cmd (WEdit *edit)
 }
 
 /* --------------------------------------------------------------------------------------------- */
+/**
+ * Update index of words before the buffer is changed.
+ *
+ * @param edit editor object
+ * @param offset offset of inserted or deleted byte
+ * @param delta 1 if byte is inserted, -1 if byte is deleted
+ */
+
+void
+edit_complete_index_change (WEdit *edit, off_t offset, int delta)
+{
+    edit_complete_index_t *idx = edit->completion_index;
+    off_t from, to;
+
+    if (idx == NULL)
+        return;
+
+    // bytes whose tokens can be changed
+    from = offset - 1;
+    to = delta > 0 ? offset : offset + 1;
+
+    // index previous changes if they are far from this one
+    if (idx->dirty_end >= idx->dirty_start
+        && (from > idx->dirty_end + 1 || to < idx->dirty_start - 1))
+        edit_complete_index_flush (edit);
+
+    edit_complete_index_range (edit, from, to, FALSE);
+
+    if (idx->dirty_end < idx->dirty_start)
+    {
+        idx->dirty_start = from;
+        idx->dirty_end = to;
+    }
+    else
+    {
+        idx->dirty_start = MIN (idx->dirty_start, from);
+        idx->dirty_end = MAX (idx->dirty_end, to);
+    }
+
+    idx->dirty_end += delta;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+void
+edit_complete_index_free (WEdit *edit)
+{
+    if (edit->completion_index != NULL)
+    {
+        g_sequence_free (edit->completion_index->words);
+        g_free (edit->completion_index);
+        edit->completion_index = NULL;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
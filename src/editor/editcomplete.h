@@ -16,6 +16,9 @@ MC_MOCKABLE char *edit_completion_dialog_show (const WEdit *edit, GQueue * compl
 
 void edit_complete_word_cmd (WEdit *edit);
 
+void edit_complete_index_change (WEdit *edit, off_t offset, int delta);
+void edit_complete_index_free (WEdit *edit);
+
 /*** inline functions ****************************************************************************/
 
 #endif
@@ -568,6 +568,7 @@ edit_search_init (WEdit *edit, const char *str)
     edit->search->is_case_sensitive = edit_search_options.case_sens;
     edit->search->whole_words = edit_search_options.whole_words;
     edit->search->search_fn = edit_search_cmd_callback;
+    edit->search->block_fn = edit_search_block_callback;
     edit->search->update_fn = edit_search_update_callback;
 
     edit->search_line_type = mc_search_get_line_type (edit->search);
@@ -600,6 +601,19 @@ edit_search_cmd_callback (const void *user_data, off_t char_offset, int *current
 
 /* --------------------------------------------------------------------------------------------- */
 
+mc_search_cbret_t
+edit_search_block_callback (const void *user_data, off_t offset, const char **block,
+                            gsize *block_len)
+{
+    WEdit *edit = ((const edit_search_status_msg_t *) user_data)->edit;
+
+    *block = edit_buffer_get_block (&edit->buffer, offset, block_len);
+
+    return (*block != NULL) ? MC_SEARCH_CB_OK : MC_SEARCH_CB_NOTFOUND;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 mc_search_cbret_t
 edit_search_update_callback (const void *user_data, off_t char_offset)
 {
@@ -41,6 +41,8 @@ void edit_search_deinit (WEdit *edit);
 
 mc_search_cbret_t edit_search_cmd_callback (const void *user_data, off_t char_offset,
                                             int *current_char);
+mc_search_cbret_t edit_search_block_callback (const void *user_data, off_t offset,
+                                              const char **block, gsize *block_len);
 MC_MOCKABLE mc_search_cbret_t edit_search_update_callback (const void *user_data,
                                                            off_t char_offset);
 int edit_search_status_update_cb (status_msg_t *sm);
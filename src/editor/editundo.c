@@ -0,0 +1,398 @@
+/*
+   Editor undo and redo stacks.
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** \file
+ *  \brief Source: editor undo and redo stacks.
+ *
+ *  Stack keeps actions (see edit_push_undo_action()) in a ring of bytes. Every action is
+ *  stored as variable-length number: 7 bits per byte, high bit is set in all bytes except
+ *  the last one. So the stack can be read in both directions: from the top when actions
+ *  are popped and from the bottom when the oldest key presses are dropped.
+ *
+ *  Codes are renumbered to make frequent ones short: bytes deleted with edit_delete(), which
+ *  make the bulk of block deletions and replacements, take one byte if they are ASCII.
+ *  Runs of the same action (inserted text, cursor movements) are stored as the action
+ *  followed by 0 and the repeat count.
+ *
+ *  Non-empty stack always starts with a key press.
+ */
+
+#include <config.h>
+
+#include <string.h>
+
+#include "lib/global.h"
+#include "lib/util.h"  // MC_PTR_FREE()
+
+#include "edit-impl.h"
+#include "editundo.h"
+
+/*** global variables ****************************************************************************/
+
+/*** file scope macro definitions ****************************************************************/
+
+/* maximal size of encoded number */
+#define UNDO_NUMBER_MAX_LEN ((sizeof (unsigned long) * 8 + 6) / 7)
+
+/* maximal size of pushed record: action, repeat marker and repeat count */
+#define UNDO_RECORD_MAX_LEN (2 * UNDO_NUMBER_MAX_LEN + 1)
+
+/* maximal repeat count of action */
+#define UNDO_REPEAT_MAX     1000000000
+
+/*** file scope type declarations ****************************************************************/
+
+/*** forward declarations (file scope functions) *************************************************/
+
+/*** file scope variables ************************************************************************/
+
+/* --------------------------------------------------------------------------------------------- */
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+/* Renumber action codes: 0 is repeat marker, then bytes deleted forward, plain key press,
+   bytes deleted backward and the rest in the original order. */
+
+static unsigned long
+undo_code_encode (long c)
+{
+    if (c >= 256 && c < 512)
+        return (unsigned long) (c - 256 + 1);
+    if (c == KEY_PRESS)
+        return 257;
+    if (c >= 0 && c < 256)
+        return (unsigned long) (c + 258);
+    if (c < KEY_PRESS)
+        return (unsigned long) (c + 2);
+    return (unsigned long) (c + 1);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static long
+undo_code_decode (unsigned long e)
+{
+    if (e <= 256)
+        return (long) e - 1 + 256;
+    if (e == 257)
+        return KEY_PRESS;
+    if (e <= 513)
+        return (long) e - 258;
+    if (e <= (unsigned long) KEY_PRESS + 1)
+        return (long) e - 2;
+    return (long) e - 1;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static inline unsigned long
+undo_stack_used (const edit_undo_stack_t *s)
+{
+    return (s->pointer - s->bottom) & s->size_mask;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+undo_stack_put (edit_undo_stack_t *s, unsigned long v)
+{
+    do
+    {
+        unsigned char b = v & 0x7f;
+
+        v >>= 7;
+        if (v != 0)
+            b |= 0x80;
+        s->data[s->pointer] = b;
+        s->pointer = (s->pointer + 1) & s->size_mask;
+    }
+    while (v != 0);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Read number at position and move the position to the next one */
+
+static unsigned long
+undo_stack_get (const edit_undo_stack_t *s, unsigned long *p)
+{
+    unsigned long v = 0;
+    int shift = 0;
+    unsigned char b;
+
+    do
+    {
+        b = s->data[*p];
+        *p = (*p + 1) & s->size_mask;
+        v |= (unsigned long) (b & 0x7f) << shift;
+        shift += 7;
+    }
+    while ((b & 0x80) != 0);
+
+    return v;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Find start of number which ends before the position */
+
+static unsigned long
+undo_stack_get_start (const edit_undo_stack_t *s, unsigned long p)
+{
+    p = (p - 1) & s->size_mask;
+
+    // all bytes of number except the last one have high bit set
+    while (p != s->bottom && (s->data[(p - 1) & s->size_mask] & 0x80) != 0)
+        p = (p - 1) & s->size_mask;
+
+    return p;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Read the top record.
+ *
+ * @param s stack, must not be empty
+ * @param start pointer to store the start of the record
+ * @param end pointer to store the end of the action code (start of repeat marker if any)
+ * @param count pointer to store the repeat count
+ *
+ * @return action code
+ */
+
+static long
+undo_stack_get_top_record (const edit_undo_stack_t *s, unsigned long *start, unsigned long *end,
+                           unsigned long *count)
+{
+    unsigned long p, v;
+
+    p = undo_stack_get_start (s, s->pointer);
+    *start = p;
+    v = undo_stack_get (s, &p);
+    *end = s->pointer;
+    *count = 1;
+
+    // 0 is the only number encoded with a single zero byte
+    if (*start != s->bottom && s->data[(*start - 1) & s->size_mask] == 0)
+    {
+        *count = v;
+        *end = (*start - 1) & s->size_mask;
+        p = undo_stack_get_start (s, *end);
+        *start = p;
+        v = undo_stack_get (s, &p);
+    }
+
+    return undo_code_decode (v);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Drop the oldest key press with all its actions */
+
+static void
+undo_stack_drop_bottom (edit_undo_stack_t *s)
+{
+    unsigned long p = s->bottom;
+
+    while (TRUE)
+    {
+        unsigned long q, v;
+
+        // skip action with its repeat count
+        if (undo_stack_get (s, &p) == 0)
+            (void) undo_stack_get (s, &p);
+
+        if (p == s->pointer)
+        {
+            // one key press fills the whole stack: it cannot be undone
+            edit_undo_stack_clear (s);
+            return;
+        }
+
+        q = p;
+        v = undo_stack_get (s, &q);
+        if (v != 0 && undo_code_decode (v) >= KEY_PRESS)
+            break;
+    }
+
+    s->bottom = p;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+undo_stack_grow (edit_undo_stack_t *s)
+{
+    s->data = g_realloc (s->data, s->size * 2);
+
+    // unwrap the ring
+    if (s->pointer < s->bottom)
+    {
+        memcpy (s->data + s->size, s->data, s->pointer);
+        s->pointer += s->size;
+    }
+
+    s->size *= 2;
+    s->size_mask = s->size - 1;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Make space for a record: enlarge the stack up to the limit, then drop the oldest actions */
+
+static void
+undo_stack_reserve (edit_undo_stack_t *s, unsigned long max_size)
+{
+    while (s->size - 1 - undo_stack_used (s) < UNDO_RECORD_MAX_LEN)
+    {
+        if (s->size < max_size || s->size <= 2 * UNDO_RECORD_MAX_LEN)
+            undo_stack_grow (s);
+        else
+            undo_stack_drop_bottom (s);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+void
+edit_undo_stack_init (edit_undo_stack_t *s)
+{
+    s->size = START_STACK_SIZE;
+    s->size_mask = s->size - 1;
+    s->data = g_malloc (s->size);
+    s->pointer = 0;
+    s->bottom = 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+void
+edit_undo_stack_clean (edit_undo_stack_t *s)
+{
+    MC_PTR_FREE (s->data);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+void
+edit_undo_stack_clear (edit_undo_stack_t *s)
+{
+    s->pointer = 0;
+    s->bottom = 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Push action onto the stack.
+ *
+ * @param s stack
+ * @param c action code
+ * @param max_size size of memory the stack can grow to. If the stack is full, the oldest
+ *                 key presses are dropped.
+ */
+
+void
+edit_undo_stack_push (edit_undo_stack_t *s, long c, unsigned long max_size)
+{
+    undo_stack_reserve (s, max_size);
+
+    if (s->pointer == s->bottom)
+    {
+        // actions without key press cannot be undone
+        if (c >= KEY_PRESS)
+            undo_stack_put (s, undo_code_encode (c));
+        return;
+    }
+
+    {
+        unsigned long start, end, count;
+
+        if (undo_stack_get_top_record (s, &start, &end, &count) == c)
+        {
+            // no need to push multiple do-nothings
+            if (c >= KEY_PRESS)
+                return;
+
+            if (count < UNDO_REPEAT_MAX)
+            {
+                s->pointer = end;
+                undo_stack_put (s, 0);
+                undo_stack_put (s, count + 1);
+                return;
+            }
+        }
+    }
+
+    undo_stack_put (s, undo_code_encode (c));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Pop action from the stack.
+ *
+ * @return action code or STACK_BOTTOM if the stack is empty
+ */
+
+long
+edit_undo_stack_pop (edit_undo_stack_t *s)
+{
+    unsigned long start, end, count;
+    long c;
+
+    if (s->pointer == s->bottom)
+        return STACK_BOTTOM;
+
+    c = undo_stack_get_top_record (s, &start, &end, &count);
+
+    if (count == 1)
+        s->pointer = start;
+    else
+    {
+        s->pointer = end;
+        // new count is not longer than old one
+        if (count > 2)
+        {
+            undo_stack_put (s, 0);
+            undo_stack_put (s, count - 1);
+        }
+    }
+
+    return c;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get action from the top of the stack without popping it.
+ *
+ * @return action code or STACK_BOTTOM if the stack is empty
+ */
+
+long
+edit_undo_stack_get_top (const edit_undo_stack_t *s)
+{
+    unsigned long start, end, count;
+
+    if (s->pointer == s->bottom)
+        return STACK_BOTTOM;
+
+    return undo_stack_get_top_record (s, &start, &end, &count);
+}
+
+/* --------------------------------------------------------------------------------------------- */
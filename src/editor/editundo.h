@@ -0,0 +1,37 @@
+/** \file
+ *  \brief Header: compact undo and redo stacks for WEdit
+ */
+
+#ifndef MC__EDIT_UNDO_H
+#define MC__EDIT_UNDO_H
+
+/*** typedefs(not structures) and defined constants **********************************************/
+
+/*** enums ***************************************************************************************/
+
+/*** structures declarations (and typedefs of structures)*****************************************/
+
+typedef struct edit_undo_stack_struct
+{
+    unsigned char *data;      // ring of encoded actions
+    unsigned long size;       // size of ring, power of 2
+    unsigned long size_mask;  // size - 1
+    unsigned long pointer;    // top of stack
+    unsigned long bottom;     // bottom of stack
+} edit_undo_stack_t;
+
+/*** global variables defined in .c file *********************************************************/
+
+/*** declarations of public functions ************************************************************/
+
+void edit_undo_stack_init (edit_undo_stack_t *s);
+void edit_undo_stack_clean (edit_undo_stack_t *s);
+void edit_undo_stack_clear (edit_undo_stack_t *s);
+
+void edit_undo_stack_push (edit_undo_stack_t *s, long c, unsigned long max_size);
+long edit_undo_stack_pop (edit_undo_stack_t *s);
+long edit_undo_stack_get_top (const edit_undo_stack_t *s);
+
+/*** inline functions ****************************************************************************/
+
+#endif
@@ -12,6 +12,7 @@
 
 #include "edit-impl.h"
 #include "editbuffer.h"
+#include "editundo.h"
 
 /*** typedefs(not structures) and defined constants **********************************************/
 
@@ -30,6 +31,9 @@ struct edit_book_mark_t
     edit_book_mark_t *prev;
 };
 
+/* index of words for completion, see editcomplete.c */
+typedef struct edit_complete_index_t edit_complete_index_t;
+
 typedef struct edit_syntax_rule_t edit_syntax_rule_t;
 struct edit_syntax_rule_t
 {
@@ -122,18 +126,10 @@ struct WEdit
     GArray *serialized_bookmarks;
 
     // undo stack and pointers
-    unsigned long undo_stack_pointer;
-    long *undo_stack;
-    unsigned long undo_stack_size;
-    unsigned long undo_stack_size_mask;
-    unsigned long undo_stack_bottom;
+    edit_undo_stack_t undo_stack;
     unsigned int undo_stack_disable : 1;  // If not 0, don't save events in the undo stack
 
-    unsigned long redo_stack_pointer;
-    long *redo_stack;
-    unsigned long redo_stack_size;
-    unsigned long redo_stack_size_mask;
-    unsigned long redo_stack_bottom;
+    edit_undo_stack_t redo_stack;
     unsigned int redo_stack_reset : 1;  // If 1, need clear redo stack
 
     struct stat stat1;    // Result of mc_fstat() on the file
@@ -143,14 +139,18 @@ struct WEdit
     unsigned int skip_detach_prompt : 1;  // Do not prompt whether to detach a file anymore
 
     // syntax highlighting
-    GSList *syntax_marker;
+    GArray *syntax_marker;  // saved states of highlighting sorted by offset
     GPtrArray *rules;
     off_t last_get_rule;
+    off_t syntax_changed;  // lowest offset changed since the last highlighting or -1
     edit_syntax_rule_t rule;
     char *syntax_type;             // description of syntax highlighting type being used
     GTree *defines;                // List of defines
     gboolean is_case_insensitive;  // selects language case sensitivity
 
+    // word completion
+    edit_complete_index_t *completion_index;  // NULL until the first completion
+
     // line break
     LineBreaks lb;
 };
@@ -36,6 +36,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
 
 #include "lib/global.h"
 #include "lib/fileloc.h"  // TAGS_NAME
@@ -51,14 +52,43 @@
 
 /*** file scope macro definitions ****************************************************************/
 
+/* characters which cannot be a part of implicit tag name */
+#define ETAGS_NOT_IN_NAME " \f\t\n\r()=,;"
+
+#define ETAGS_NO_TAG      G_MAXUINT
+
 /*** file scope type declarations ****************************************************************/
 
+/* tag: definition line in TAGS file */
+typedef struct
+{
+    off_t offset;  // offset of definition line in TAGS file
+    guint hash;    // hash of tag name
+    guint file;    // index of source file name
+    guint next;    // next tag in the hash chain
+} etags_tag_t;
+
+/* index of TAGS file */
+typedef struct
+{
+    char *path;
+    time_t mtime;
+    off_t size;
+    GPtrArray *files;  // names of source files
+    GArray *tags;      // etags_tag_t
+    guint *buckets;    // first tags of hash chains
+    guint mask;        // number of buckets - 1
+} etags_index_t;
+
 /*** forward declarations (file scope functions) *************************************************/
 
 /*** file scope variables ************************************************************************/
 
 static int def_max_width;
 
+/* index of the last used TAGS file, it is kept between lookups */
+static etags_index_t *etags_index = NULL;
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -191,8 +221,108 @@ parse_define (const char *buf, char **long_name, char **short_name, long *line)
 
 /* --------------------------------------------------------------------------------------------- */
 
-static GPtrArray *
-etags_set_definition_hash (const char *tagfile, const char *start_path, const char *match_func)
+static guint
+etags_name_hash (const char *name, size_t len)
+{
+    guint h = 5381;
+    size_t i;
+
+    for (i = 0; i < len; i++)
+        h = (h << 5) + h + (unsigned char) name[i];
+
+    return h;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get name of tag from the definition line.
+ *
+ * Line is "pattern DEL [name SOH] line,offset". If explicit name is absent, the name is the last
+ * sequence of characters in the pattern which are allowed in names.
+ *
+ * @return TRUE if line contains a tag
+ */
+
+static gboolean
+etags_get_tag_name (const char *buf, const char **name, size_t *len)
+{
+    const char *del, *soh, *start, *end;
+
+    del = strchr (buf, 0x7F);
+    if (del == NULL)
+        return FALSE;
+
+    soh = strchr (del + 1, 0x01);
+    if (soh != NULL)
+    {
+        *name = del + 1;
+        *len = (size_t) (soh - del - 1);
+        return *len != 0;
+    }
+
+    for (end = del; end > buf && strchr (ETAGS_NOT_IN_NAME, end[-1]) != NULL; end--)
+        ;
+    for (start = end; start > buf && strchr (ETAGS_NOT_IN_NAME, start[-1]) == NULL; start--)
+        ;
+
+    *name = start;
+    *len = (size_t) (end - start);
+    return *len != 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Get unqualified part of name: "Class::method" -> "method" */
+
+static gboolean
+etags_get_tag_short_name (const char **name, size_t *len)
+{
+    size_t i;
+
+    for (i = *len; i > 0; i--)
+        if ((*name)[i - 1] == ':' || (*name)[i - 1] == '.')
+        {
+            if (i == *len)
+                return FALSE;
+
+            *name += i;
+            *len -= i;
+            return TRUE;
+        }
+
+    return FALSE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+etags_index_add_tag (etags_index_t *idx, off_t offset, const char *name, size_t len)
+{
+    etags_tag_t tag;
+
+    tag.offset = offset;
+    tag.hash = etags_name_hash (name, len);
+    tag.file = idx->files->len - 1;
+    tag.next = ETAGS_NO_TAG;
+    g_array_append_val (idx->tags, tag);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+etags_index_free (etags_index_t *idx)
+{
+    g_free (idx->path);
+    g_ptr_array_free (idx->files, TRUE);
+    g_array_free (idx->tags, TRUE);
+    g_free (idx->buckets);
+    g_free (idx);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Read TAGS file once and index tags by name. Only offsets of lines are kept in memory */
+
+static etags_index_t *
+etags_index_new (const char *tagfile, const struct stat *st)
 {
     enum
     {
@@ -203,18 +333,22 @@ etags_set_definition_hash (const char *tagfile, const char *start_path, const ch
 
     FILE *f;
     char buf[BUF_LARGE];
-    char *filename = NULL;
-    GPtrArray *ret = NULL;
-
-    if (match_func == NULL || tagfile == NULL)
-        return NULL;
+    etags_index_t *idx;
+    off_t offset;
+    guint i;
 
-    // open file with positions
     f = fopen (tagfile, "r");
     if (f == NULL)
         return NULL;
 
-    while (fgets (buf, sizeof (buf), f) != NULL)
+    idx = g_new (etags_index_t, 1);
+    idx->path = g_strdup (tagfile);
+    idx->mtime = st->st_mtime;
+    idx->size = st->st_size;
+    idx->files = g_ptr_array_new_with_free_func (g_free);
+    idx->tags = g_array_new (FALSE, FALSE, sizeof (etags_tag_t));
+
+    for (offset = 0; fgets (buf, sizeof (buf), f) != NULL; offset = ftello (f))
         switch (state)
         {
         case start:
@@ -223,64 +357,170 @@ etags_set_definition_hash (const char *tagfile, const char *start_path, const ch
             break;
 
         case in_filename:
-        {
-            size_t pos;
-
-            pos = strcspn (buf, ",");
-            g_free (filename);
-            filename = g_strndup (buf, pos);
+            g_ptr_array_add (idx->files, g_strndup (buf, strcspn (buf, ",")));
             state = in_define;
             break;
-        }
 
         case in_define:
             if (buf[0] == 0x0C)
                 state = in_filename;
             else
             {
-                char *chekedstr;
+                const char *name;
+                size_t len;
 
-                // check if the filename matches the define pos
-                chekedstr = strstr (buf, match_func);
-                if (chekedstr != NULL)
+                if (etags_get_tag_name (buf, &name, &len))
                 {
-                    char *longname = NULL;
-                    char *shortname = NULL;
-                    etags_hash_t *def_hash;
+                    etags_index_add_tag (idx, offset, name, len);
+                    if (etags_get_tag_short_name (&name, &len))
+                        etags_index_add_tag (idx, offset, name, len);
+                }
+            }
+            break;
 
-                    def_hash = g_new (etags_hash_t, 1);
+        default:
+            break;
+        }
 
-                    def_hash->fullpath = mc_build_filename (start_path, filename, (char *) NULL);
-                    def_hash->filename = g_strdup (filename);
+    fclose (f);
 
-                    def_hash->line = 0;
+    for (idx->mask = 1; idx->mask < idx->tags->len; idx->mask <<= 1)
+        ;
+    idx->buckets = g_new (guint, idx->mask);
+    idx->mask--;
+    memset (idx->buckets, 0xFF, (idx->mask + 1) * sizeof (guint));
 
-                    parse_define (chekedstr, &longname, &shortname, &def_hash->line);
+    // prepend tags to chains from the end to keep them in the file order
+    for (i = idx->tags->len; i > 0; i--)
+    {
+        etags_tag_t *tag = &g_array_index (idx->tags, etags_tag_t, i - 1);
+        guint *bucket = &idx->buckets[tag->hash & idx->mask];
 
-                    if (shortname != NULL && *shortname != '\0')
-                    {
-                        def_hash->short_define = shortname;
-                        g_free (longname);
-                    }
-                    else
-                    {
-                        def_hash->short_define = longname;
-                        g_free (shortname);
-                    }
+        tag->next = *bucket;
+        *bucket = i - 1;
+    }
 
-                    if (ret == NULL)
-                        ret = g_ptr_array_new_with_free_func (etags_hash_free);
+    return idx;
+}
 
-                    g_ptr_array_add (ret, def_hash);
-                }
+/* --------------------------------------------------------------------------------------------- */
+/** Get index of TAGS file. Index is rebuilt if the file was changed since the last call */
+
+static etags_index_t *
+etags_index_get (const char *tagfile)
+{
+    struct stat st;
+
+    if (stat (tagfile, &st) != 0)
+        return NULL;
+
+    if (etags_index != NULL
+        && (strcmp (etags_index->path, tagfile) != 0 || etags_index->mtime != st.st_mtime
+            || etags_index->size != st.st_size))
+    {
+        etags_index_free (etags_index);
+        etags_index = NULL;
+    }
+
+    if (etags_index == NULL)
+        etags_index = etags_index_new (tagfile, &st);
+
+    return etags_index;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static GPtrArray *
+etags_set_definition_hash (const char *tagfile, const char *start_path, const char *match_func)
+{
+    etags_index_t *idx;
+    FILE *f;
+    char buf[BUF_LARGE];
+    size_t match_len;
+    guint match_hash;
+    off_t last_offset = -1;
+    guint i;
+    GPtrArray *ret = NULL;
+
+    if (match_func == NULL || tagfile == NULL)
+        return NULL;
+
+    idx = etags_index_get (tagfile);
+    if (idx == NULL || idx->tags->len == 0)
+        return NULL;
+
+    // open file with positions
+    f = fopen (tagfile, "r");
+    if (f == NULL)
+        return NULL;
+
+    match_len = strlen (match_func);
+    match_hash = etags_name_hash (match_func, match_len);
+
+    for (i = idx->buckets[match_hash & idx->mask]; i != ETAGS_NO_TAG;
+         i = g_array_index (idx->tags, etags_tag_t, i).next)
+    {
+        const etags_tag_t *tag = &g_array_index (idx->tags, etags_tag_t, i);
+        const char *name;
+        size_t len;
+        char *chekedstr;
+
+        // other names in the same bucket
+        if (tag->hash != match_hash)
+            continue;
+
+        // full and short names of qualified tag are adjacent in the chain and both can match
+        // the same name: the line is already added
+        if (tag->offset == last_offset)
+            continue;
+
+        if (fseeko (f, tag->offset, SEEK_SET) != 0 || fgets (buf, sizeof (buf), f) == NULL
+            || !etags_get_tag_name (buf, &name, &len))
+            continue;
+
+        // check if the tag is the one we are looking for
+        if (!(len == match_len && strncmp (name, match_func, len) == 0)
+            && !(etags_get_tag_short_name (&name, &len) && len == match_len
+                 && strncmp (name, match_func, len) == 0))
+            continue;
+
+        last_offset = tag->offset;
+
+        chekedstr = strstr (buf, match_func);
+        if (chekedstr != NULL)
+        {
+            const char *filename = g_ptr_array_index (idx->files, tag->file);
+            char *longname = NULL;
+            char *shortname = NULL;
+            etags_hash_t *def_hash;
+
+            def_hash = g_new (etags_hash_t, 1);
+
+            def_hash->fullpath = mc_build_filename (start_path, filename, (char *) NULL);
+            def_hash->filename = g_strdup (filename);
+
+            def_hash->line = 0;
+
+            parse_define (chekedstr, &longname, &shortname, &def_hash->line);
+
+            if (shortname != NULL && *shortname != '\0')
+            {
+                def_hash->short_define = shortname;
+                g_free (longname);
+            }
+            else
+            {
+                def_hash->short_define = longname;
+                g_free (shortname);
             }
-            break;
 
-        default:
-            break;
+            if (ret == NULL)
+                ret = g_ptr_array_new_with_free_func (etags_hash_free);
+
+            g_ptr_array_add (ret, def_hash);
         }
+    }
 
-    g_free (filename);
     fclose (f);
 
     return ret;
@@ -457,3 +697,15 @@ edit_get_match_keyword_cmd (WEdit *edit)
 }
 
 /* --------------------------------------------------------------------------------------------- */
+
+void
+etags_cache_free (void)
+{
+    if (etags_index != NULL)
+    {
+        etags_index_free (etags_index);
+        etags_index = NULL;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
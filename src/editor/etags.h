@@ -20,6 +20,7 @@ typedef struct etags_hash_struct
 /*** declarations of public functions ************************************************************/
 
 void edit_get_match_keyword_cmd (WEdit *edit);
+void etags_cache_free (void);
 
 /*** inline functions ****************************************************************************/
 
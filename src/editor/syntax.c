@@ -73,8 +73,10 @@ gboolean auto_syntax = TRUE;
 
 /*** file scope macro definitions ****************************************************************/
 
-/* bytes */
-#define SYNTAX_MARKER_DENSITY 512
+/* bytes: state is saved at starts of lines at least SYNTAX_MARKER_DENSITY bytes apart
+   and inside of lines longer than SYNTAX_MARKER_MAX_DISTANCE */
+#define SYNTAX_MARKER_DENSITY      512
+#define SYNTAX_MARKER_MAX_DISTANCE 4096
 
 #define RULE_ON_LEFT_BORDER   1
 #define RULE_ON_RIGHT_BORDER  2
@@ -84,6 +86,9 @@ gboolean auto_syntax = TRUE;
 #define SYNTAX_TOKEN_BRACKET  '\003'
 #define SYNTAX_TOKEN_BRACE    '\004'
 
+/* maximal length of keyword prefix indexed in trie */
+#define SYNTAX_TRIE_DEPTH     16
+
 #define break_a                                                                                    \
     {                                                                                              \
         result = line;                                                                             \
@@ -126,6 +131,22 @@ typedef struct
     int color;
 } syntax_keyword_t;
 
+typedef struct
+{
+    unsigned char c;  // byte of keyword prefix
+    int child;        // first child node or -1
+    int sibling;      // next sibling node or -1
+    int keyword;      // first keyword which prefix ends here or 0
+} syntax_trie_node_t;
+
+typedef struct syntax_trie_t
+{
+    int first[256];  // node for the first byte of keyword or -1
+    int wild;        // first keyword starting with wildcard or 0: such ones are tried everywhere
+    GArray *nodes;   // syntax_trie_node_t
+    int *next;       // next keyword with the same prefix, 0 terminates the list
+} syntax_trie_t;
+
 typedef struct
 {
     GString *left;
@@ -137,12 +158,14 @@ typedef struct
     gboolean between_delimiters;
     char *whole_word_chars_left;
     char *whole_word_chars_right;
-    char *keyword_first_chars;
     gboolean spelling;
     // first word is word[1]
     GPtrArray *keyword;
+    // index of keywords by their literal prefixes, NULL if there are no keywords
+    struct syntax_trie_t *keyword_trie;
 } context_rule_t;
 
+// state of highlighting after the byte at offset
 typedef struct
 {
     off_t offset;
@@ -172,6 +195,18 @@ syntax_keyword_free (gpointer keyword)
 
 /* --------------------------------------------------------------------------------------------- */
 
+static void
+syntax_trie_free (syntax_trie_t *t)
+{
+    if (t == NULL)
+        return;
+
+    g_array_free (t->nodes, TRUE);
+    g_free (t->next);
+    g_free (t);
+}
+
+/* --------------------------------------------------------------------------------------------- */
 static void
 context_rule_free (gpointer rule)
 {
@@ -181,7 +216,7 @@ context_rule_free (gpointer rule)
     g_string_free (r->right, TRUE);
     g_free (r->whole_word_chars_left);
     g_free (r->whole_word_chars_right);
-    g_free (r->keyword_first_chars);
+    syntax_trie_free (r->keyword_trie);
 
     if (r->keyword != NULL)
         g_ptr_array_free (r->keyword, TRUE);
@@ -222,6 +257,84 @@ xx_tolower (const WEdit *edit, int c)
     return edit->is_case_insensitive ? tolower (c) : c;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Index keywords of context by their literal prefixes (parts before the first wildcard).
+ *
+ * @return trie or NULL if context has no keywords
+ */
+
+static syntax_trie_t *
+syntax_trie_new (const WEdit *edit, const GPtrArray *keywords)
+{
+    syntax_trie_t *t;
+    guint j;
+
+    if (keywords->len < 2)
+        return NULL;
+
+    t = g_new (syntax_trie_t, 1);
+    memset (t->first, -1, sizeof (t->first));
+    t->wild = 0;
+    t->nodes = g_array_new (FALSE, FALSE, sizeof (syntax_trie_node_t));
+    t->next = g_new0 (int, keywords->len);
+
+    for (j = 1; j < keywords->len; j++)
+    {
+        const syntax_keyword_t *k = SYNTAX_KEYWORD (g_ptr_array_index (keywords, j));
+        const unsigned char *p = (const unsigned char *) k->keyword->str;
+        int *link;
+        int node = -1;
+        size_t depth;
+
+        // empty keyword ends the list of keywords
+        if (*p == '\0')
+            break;
+
+        if (*p < '\005')
+        {
+            link = &t->wild;
+            while (*link != 0)
+                link = &t->next[*link];
+            *link = (int) j;
+            continue;
+        }
+
+        // first byte is compared case-insensitively, the rest as is by compare_word_to_right()
+        link = &t->first[(unsigned char) xx_tolower (edit, *p)];
+
+        for (depth = 0; depth < SYNTAX_TRIE_DEPTH && p[depth] >= '\005'; depth++)
+        {
+            const unsigned char b = depth == 0 ? (unsigned char) xx_tolower (edit, *p) : p[depth];
+
+            while (*link >= 0 && g_array_index (t->nodes, syntax_trie_node_t, *link).c != b)
+                link = &g_array_index (t->nodes, syntax_trie_node_t, *link).sibling;
+
+            if (*link >= 0)
+                node = *link;
+            else
+            {
+                syntax_trie_node_t nd = { .c = b, .child = -1, .sibling = -1, .keyword = 0 };
+
+                // link can point to array data which is moved when array grows
+                node = (int) t->nodes->len;
+                *link = node;
+                g_array_append_val (t->nodes, nd);
+            }
+
+            link = &g_array_index (t->nodes, syntax_trie_node_t, node).child;
+        }
+
+        // append keyword to the list of its node to keep order of definition
+        link = &g_array_index (t->nodes, syntax_trie_node_t, node).keyword;
+        while (*link != 0)
+            link = &t->next[*link];
+        *link = (int) j;
+    }
+
+    return t;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 static void
@@ -381,13 +494,77 @@ compare_word_to_right (const WEdit *edit, off_t i, const GString *text, const ch
 
 /* --------------------------------------------------------------------------------------------- */
 
-static const char *
-xx_strchr (const WEdit *edit, const unsigned char *s, int char_byte)
+/**
+ * Find the first keyword of context matching text at offset.
+ *
+ * Keywords are tried in order of their definition, like syntax files expect, but only ones
+ * which literal prefix matches the text and ones starting with wildcard.
+ *
+ * @param c lowered byte at offset
+ * @param end pointer to store the end of matched keyword
+ *
+ * @return index of keyword or 0 if no keyword matches
+ */
+
+static int
+find_keyword_to_right (const WEdit *edit, const context_rule_t *r, off_t i, int c, off_t *end)
 {
-    while (*s >= '\005' && xx_tolower (edit, *s) != char_byte)
-        s++;
+    const syntax_trie_t *t = r->keyword_trie;
+    int lists[SYNTAX_TRIE_DEPTH + 1];
+    int n = 0;
+    int node;
+    off_t j = i;
+
+    if (t == NULL)
+        return 0;
+
+    if (t->wild != 0)
+        lists[n++] = t->wild;
+
+    // collect lists of keywords which prefixes match the text
+    node = t->first[(unsigned char) c];
+    while (node >= 0)
+    {
+        const syntax_trie_node_t *nd = &g_array_index (t->nodes, syntax_trie_node_t, node);
+        int b;
+
+        if (nd->keyword != 0)
+            lists[n++] = nd->keyword;
+
+        b = edit_buffer_get_byte (&edit->buffer, ++j);
+        b = xx_tolower (edit, b);
+        for (node = nd->child;
+             node >= 0 && g_array_index (t->nodes, syntax_trie_node_t, node).c != b;
+             node = g_array_index (t->nodes, syntax_trie_node_t, node).sibling)
+            ;
+    }
+
+    // try keywords in order of definition
+    while (n > 0)
+    {
+        const syntax_keyword_t *k;
+        off_t e;
+        int m, l;
 
-    return (const char *) s;
+        for (m = 0, l = 1; l < n; l++)
+            if (lists[l] < lists[m])
+                m = l;
+
+        k = SYNTAX_KEYWORD (g_ptr_array_index (r->keyword, lists[m]));
+        e = compare_word_to_right (edit, i, k->keyword, k->whole_word_chars_left,
+                                   k->whole_word_chars_right, k->line_start);
+        if (e > 0)
+        {
+            *end = e;
+            return lists[m];
+        }
+
+        lists[m] = t->next[lists[m]];
+        if (lists[m] == 0)
+            lists[m] = lists[--n];
+    }
+
+    return 0;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -460,43 +637,30 @@ apply_rules_going_right (WEdit *edit, off_t i)
     // check to turn on a keyword
     if (_rule.keyword == 0)
     {
-        const char *p;
+        int count;
+        off_t e = -1;
 
         r = CONTEXT_RULE (g_ptr_array_index (edit->rules, _rule.context));
-        p = r->keyword_first_chars;
+        count = find_keyword_to_right (edit, r, i, c, &e);
+        if (count != 0)
+        {
+            const syntax_keyword_t *k = SYNTAX_KEYWORD (g_ptr_array_index (r->keyword, count));
 
-        if (p != NULL)
-            while (*(p = xx_strchr (edit, (const unsigned char *) p + 1, c)) != '\0')
+            /* when both context and keyword terminate with a newline,
+               the context overflows to the next line and colorizes it incorrectly */
+            if (e > i + 1 && _rule._context != 0 && k->keyword->str[k->keyword->len - 1] == '\n')
             {
-                syntax_keyword_t *k;
-                int count;
-                off_t e = -1;
-
-                count = p - r->keyword_first_chars;
-                k = SYNTAX_KEYWORD (g_ptr_array_index (r->keyword, count));
-                if (k->keyword != 0)
-                    e = compare_word_to_right (edit, i, k->keyword, k->whole_word_chars_left,
-                                               k->whole_word_chars_right, k->line_start);
-                if (e > 0)
-                {
-                    /* when both context and keyword terminate with a newline,
-                       the context overflows to the next line and colorizes it incorrectly */
-                    if (e > i + 1 && _rule._context != 0
-                        && k->keyword->str[k->keyword->len - 1] == '\n')
-                    {
-                        r = CONTEXT_RULE (g_ptr_array_index (edit->rules, _rule._context));
-                        if (r->right != NULL && r->right->len != 0
-                            && r->right->str[r->right->len - 1] == '\n')
-                            e--;
-                    }
-
-                    end = e;
-                    _rule.end = e;
-                    _rule.keyword = count;
-                    keyword_foundright = TRUE;
-                    break;
-                }
+                r = CONTEXT_RULE (g_ptr_array_index (edit->rules, _rule._context));
+                if (r->right != NULL && r->right->len != 0
+                    && r->right->str[r->right->len - 1] == '\n')
+                    e--;
             }
+
+            end = e;
+            _rule.end = e;
+            _rule.keyword = count;
+            keyword_foundright = TRUE;
+        }
     }
 
     // check to turn on a context
@@ -575,29 +739,15 @@ apply_rules_going_right (WEdit *edit, off_t i)
     // check again to turn on a keyword if the context switched
     if (contextchanged && _rule.keyword == 0)
     {
-        const char *p;
+        int count;
+        off_t e = -1;
 
         r = CONTEXT_RULE (g_ptr_array_index (edit->rules, _rule.context));
-        p = r->keyword_first_chars;
-
-        while (*(p = xx_strchr (edit, (const unsigned char *) p + 1, c)) != '\0')
+        count = find_keyword_to_right (edit, r, i, c, &e);
+        if (count != 0)
         {
-            syntax_keyword_t *k;
-            int count;
-            off_t e = -1;
-
-            count = p - r->keyword_first_chars;
-            k = SYNTAX_KEYWORD (g_ptr_array_index (r->keyword, count));
-
-            if (k->keyword->len != 0)
-                e = compare_word_to_right (edit, i, k->keyword, k->whole_word_chars_left,
-                                           k->whole_word_chars_right, k->line_start);
-            if (e > 0)
-            {
-                _rule.end = e;
-                _rule.keyword = count;
-                break;
-            }
+            _rule.end = e;
+            _rule.keyword = count;
         }
     }
 
@@ -606,61 +756,133 @@ apply_rules_going_right (WEdit *edit, off_t i)
 
 /* --------------------------------------------------------------------------------------------- */
 
-static void
-edit_get_rule (WEdit *edit, off_t byte_index)
+/**
+ * Find the last saved state at or before the byte.
+ *
+ * @return index of state in edit->syntax_marker or -1 if there is no such state
+ */
+
+static int
+syntax_marker_find (const WEdit *edit, off_t byte_index)
 {
-    off_t i;
+    int lo = 0, hi;
 
-    if (byte_index > edit->last_get_rule)
+    if (edit->syntax_marker == NULL)
+        return -1;
+
+    hi = (int) edit->syntax_marker->len;
+
+    while (lo < hi)
     {
-        for (i = edit->last_get_rule + 1; i <= byte_index; i++)
-        {
-            off_t d = SYNTAX_MARKER_DENSITY;
+        const int mid = lo + (hi - lo) / 2;
 
-            apply_rules_going_right (edit, i);
+        if (g_array_index (edit->syntax_marker, syntax_marker_t, mid).offset <= byte_index)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
 
-            if (edit->syntax_marker != NULL)
-                d += ((syntax_marker_t *) edit->syntax_marker->data)->offset;
+    return lo - 1;
+}
 
-            if (i > d)
-            {
-                syntax_marker_t *s;
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Restore state of highlighting from the last saved state at or before the byte.
+ */
 
-                s = g_new (syntax_marker_t, 1);
-                s->offset = i;
-                s->rule = edit->rule;
-                edit->syntax_marker = g_slist_prepend (edit->syntax_marker, s);
-            }
-        }
+static void
+edit_restore_rule (WEdit *edit, off_t byte_index)
+{
+    int n;
+
+    n = syntax_marker_find (edit, byte_index);
+    if (n >= 0)
+    {
+        const syntax_marker_t *s = &g_array_index (edit->syntax_marker, syntax_marker_t, n);
+
+        edit->rule = s->rule;
+        edit->last_get_rule = s->offset;
     }
-    else if (byte_index < edit->last_get_rule)
+    else
     {
-        while (TRUE)
-        {
-            syntax_marker_t *s;
+        memset (&edit->rule, 0, sizeof (edit->rule));
+        apply_rules_going_right (edit, -1);
+        edit->last_get_rule = -1;
+    }
+}
 
-            if (edit->syntax_marker == NULL)
-            {
-                memset (&edit->rule, 0, sizeof (edit->rule));
-                for (i = -1; i <= byte_index; i++)
-                    apply_rules_going_right (edit, i);
-                break;
-            }
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Forget highlighting state that can depend on the text changed since the last call.
+ */
 
-            s = (syntax_marker_t *) edit->syntax_marker->data;
+static void
+edit_syntax_flush_changes (WEdit *edit)
+{
+    const off_t offset = edit->syntax_changed;
+    off_t start;
 
-            if (byte_index >= s->offset)
-            {
-                edit->rule = s->rule;
-                for (i = s->offset + 1; i <= byte_index; i++)
-                    apply_rules_going_right (edit, i);
-                break;
-            }
+    edit->syntax_changed = -1;
 
-            g_free (s);
-            edit->syntax_marker = g_slist_delete_link (edit->syntax_marker, edit->syntax_marker);
+    // lookahead of rules matched in the line of the change can reach the changed text
+    for (start = offset; start > 0 && offset - start < SYNTAX_MARKER_MAX_DISTANCE; start--)
+        if (edit_buffer_get_byte (&edit->buffer, start - 1) == '\n')
+            break;
+
+    if (edit->syntax_marker != NULL)
+    {
+        int n;
+
+        n = syntax_marker_find (edit, start - 1);
+        while (n >= 0
+               && g_array_index (edit->syntax_marker, syntax_marker_t, n).rule.end >= offset)
+            n--;
+        g_array_set_size (edit->syntax_marker, (guint) (n + 1));
+    }
+
+    if (edit->last_get_rule >= start || edit->rule.end >= offset)
+        edit_restore_rule (edit, edit->last_get_rule);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+edit_get_rule (WEdit *edit, off_t byte_index)
+{
+    off_t i;
+    off_t last = -1;
+
+    if (edit->syntax_changed >= 0)
+        edit_syntax_flush_changes (edit);
+
+    if (byte_index < edit->last_get_rule)
+        edit_restore_rule (edit, byte_index);
+
+    if (edit->syntax_marker == NULL)
+        edit->syntax_marker = g_array_new (FALSE, FALSE, sizeof (syntax_marker_t));
+    else if (edit->syntax_marker->len != 0)
+        last = g_array_index (edit->syntax_marker, syntax_marker_t, edit->syntax_marker->len - 1)
+                   .offset;
+
+    for (i = edit->last_get_rule + 1; i <= byte_index; i++)
+    {
+        apply_rules_going_right (edit, i);
+
+        // save state after lexing new text only
+        if (i > last
+            && ((i - last >= SYNTAX_MARKER_DENSITY
+                 && edit_buffer_get_byte (&edit->buffer, i - 1) == '\n')
+                || i - last >= SYNTAX_MARKER_MAX_DISTANCE))
+        {
+            syntax_marker_t s;
+
+            s.offset = i;
+            s.rule = edit->rule;
+            g_array_append_val (edit->syntax_marker, s);
+            last = i;
         }
     }
+
     edit->last_get_rule = byte_index;
 }
 
@@ -1251,34 +1473,15 @@ edit_read_syntax_rules (WEdit *edit, FILE *f, char **args, int args_size)
     if (result == 0)
     {
         size_t i;
-        GString *first_chars;
 
         if (edit->rules == NULL)
             return line;
 
-        first_chars = g_string_sized_new (32);
-
-        // collect first character of keywords
         for (i = 0; i < edit->rules->len; i++)
         {
-            size_t j;
-
-            g_string_set_size (first_chars, 0);
             c = CONTEXT_RULE (g_ptr_array_index (edit->rules, i));
-
-            g_string_append_c (first_chars, (char) 1);
-            for (j = 1; j < c->keyword->len; j++)
-            {
-                syntax_keyword_t *k;
-
-                k = SYNTAX_KEYWORD (g_ptr_array_index (c->keyword, j));
-                g_string_append_c (first_chars, k->keyword->str[0]);
-            }
-
-            c->keyword_first_chars = g_strndup (first_chars->str, first_chars->len);
+            c->keyword_trie = syntax_trie_new (edit, c->keyword);
         }
-
-        g_string_free (first_chars, TRUE);
     }
 
     return result;
@@ -1497,6 +1700,27 @@ edit_get_syntax_color (WEdit *edit, off_t byte_index)
 }
 
 /* --------------------------------------------------------------------------------------------- */
+/**
+ * Mark highlighting state that can depend on the text being changed as invalid.
+ * Must be called before the text is changed.
+ *
+ * Only the lowest changed offset is remembered here: the text before it is the same after
+ * any number of changes, so the state is checked once by edit_get_rule() and bulk changes
+ * (file insertion, block copy) cost O(1) per byte.
+ *
+ * @param edit editor object
+ * @param offset offset of the first changed byte
+ */
+
+void
+edit_syntax_invalidate (WEdit *edit, off_t offset)
+{
+    if (edit->rules != NULL && (edit->syntax_changed < 0 || offset < edit->syntax_changed))
+        edit->syntax_changed = offset;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 
 void
 edit_free_syntax_rules (WEdit *edit)
@@ -1511,11 +1735,16 @@ edit_free_syntax_rules (WEdit *edit)
         return;
 
     edit_get_rule (edit, -1);
+    edit->syntax_changed = -1;
     MC_PTR_FREE (edit->syntax_type);
 
     g_ptr_array_free (edit->rules, TRUE);
     edit->rules = NULL;
-    g_clear_slist (&edit->syntax_marker, g_free);
+    if (edit->syntax_marker != NULL)
+    {
+        g_array_free (edit->syntax_marker, TRUE);
+        edit->syntax_marker = NULL;
+    }
     tty_color_free_temp ();
 }
 
@@ -725,6 +725,7 @@ panel_options_box (void)
                     QUICK_CHECKBOX (_ ("Show &backup files"), &panels_options.show_backups, NULL),
                     QUICK_CHECKBOX (_ ("Show &hidden files"), &panels_options.show_dot_files, NULL),
                     QUICK_CHECKBOX (_ ("&Fast dir reload"), &panels_options.fast_reload, NULL),
+                    QUICK_CHECKBOX (_ ("Wat&ch directories"), &panels_options.watch_dirs, NULL),
                     QUICK_CHECKBOX (_ ("Ma&rk moves down"), &panels_options.mark_moves_down, NULL),
                     QUICK_CHECKBOX (_ ("Re&verse files only"), &panels_options.reverse_files_only,
                                     NULL),
@@ -733,7 +734,6 @@ panel_options_box (void)
                                     NULL),
                     QUICK_SEPARATOR (FALSE),
                     QUICK_SEPARATOR (FALSE),
-                    QUICK_SEPARATOR (FALSE),
                 QUICK_STOP_GROUPBOX,
             QUICK_NEXT_COLUMN,
                 QUICK_START_GROUPBOX (_ ("Navigation")),
@@ -0,0 +1,421 @@
+/*
+   Concurrent copying of small local files.
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** \file copyqueue.c
+ *  \brief Source: concurrent copying of small local files
+ *
+ *  Copying of many small files is dominated by latency of open, create and close rather than
+ *  by bandwidth, especially on network file systems. The copy queue runs several such copies
+ *  concurrently in a pool of threads.
+ *
+ *  Worker threads call the system directly and never enter VFS or UI, which are not
+ *  thread-safe. A worker copies the file only if it doesn't require any question or
+ *  special handling: the source is a regular file that is small and not a hard link, and
+ *  the destination doesn't exist. In all other cases and on any error the worker removes
+ *  what it has created and returns the job to the caller, who copies the file with
+ *  copy_file_file() in the main thread. Jobs are returned in the order they were queued,
+ *  so all questions and error messages are shown one by one in the order of files as before.
+ */
+
+#include <config.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "lib/global.h"
+#include "lib/vfs/vfs.h"
+#include "lib/vfs/utilvfs.h"  // vfs_utime(), vfs_get_timesbuf_from_stat()
+
+#include "ioblksize.h"  // io_blksize()
+
+#include "copyqueue.h"
+
+/*** global variables ****************************************************************************/
+
+/*** file scope macro definitions ****************************************************************/
+
+// number of worker threads
+#define FILE_COPY_QUEUE_THREADS 8
+// maximum number of queued and not processed by caller jobs
+#define FILE_COPY_QUEUE_LENGTH  (4 * FILE_COPY_QUEUE_THREADS)
+// larger files are copied by copy_file_file() with progress
+#define FILE_COPY_QUEUE_MAX_SIZE (1024 * 1024)
+
+#ifndef O_NOFOLLOW
+#define O_NOFOLLOW 0
+#endif
+
+/*** file scope type declarations ****************************************************************/
+
+struct file_copy_queue_t
+{
+    // copy options
+    gboolean follow_links;
+    gboolean preserve;
+    gboolean preserve_uidgid;
+    mode_t umask_kill;
+    // mode of new file if permissions are not preserved
+    mode_t new_mode;
+
+    GThreadPool *pool;
+    // pushed and not popped jobs in the order of pushing
+    GQueue *jobs;
+    // jobs finished by workers
+    GAsyncQueue *done;
+    gint cancelled;
+};
+
+/*** forward declarations (file scope functions) *************************************************/
+
+/*** file scope variables ************************************************************************/
+
+/* --------------------------------------------------------------------------------------------- */
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+file_copy_job_write (int fd, const char *buf, size_t len)
+{
+    while (len != 0)
+    {
+        ssize_t n;
+
+        n = write (fd, buf, len);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return FALSE;
+        }
+
+        buf += n;
+        len -= (size_t) n;
+    }
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+file_copy_job_data (int src_fd, int dst_fd, const struct stat *st)
+{
+    char *buf;
+    size_t bufsize;
+    ssize_t n;
+    gboolean ok = TRUE;
+
+#ifdef HAVE_COPY_FILE_RANGE
+    if (st->st_size > 0)
+    {
+        off_t copied = 0;
+
+        while ((n = copy_file_range (src_fd, NULL, dst_fd, NULL, FILE_COPY_QUEUE_MAX_SIZE, 0)) > 0
+               || (n < 0 && errno == EINTR))
+            if (n > 0)
+                copied += n;
+
+        if (n == 0 && copied >= st->st_size)
+            return TRUE;
+        if (n < 0 && copied != 0)
+            return FALSE;
+
+        // not supported or file was changed: continue with read() and write()
+    }
+#endif
+
+    bufsize = io_blksize (*st);
+    buf = g_malloc (bufsize);
+
+    while (ok && ((n = read (src_fd, buf, bufsize)) != 0))
+    {
+        if (n > 0)
+            ok = file_copy_job_write (dst_fd, buf, (size_t) n);
+        else if (errno != EINTR)
+            ok = FALSE;
+    }
+
+    g_free (buf);
+
+    return ok;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static file_copy_job_result_t
+file_copy_job_run (const file_copy_queue_t *q, file_copy_job_t *job)
+{
+    struct stat st;
+    int src_fd, dst_fd;
+    gboolean ok;
+
+    if ((q->follow_links ? stat (job->src_local, &st) : lstat (job->src_local, &st)) != 0
+        || !S_ISREG (st.st_mode) || st.st_size > FILE_COPY_QUEUE_MAX_SIZE
+        || (!q->follow_links && st.st_nlink > 1))
+        return FILE_COPY_JOB_FALLBACK;
+
+    src_fd = open (job->src_local, O_RDONLY | O_NOCTTY | (q->follow_links ? 0 : O_NOFOLLOW));
+    if (src_fd == -1)
+        return FILE_COPY_JOB_FALLBACK;
+
+    // file could be replaced after stat()
+    if (fstat (src_fd, &st) != 0 || !S_ISREG (st.st_mode))
+    {
+        close (src_fd);
+        return FILE_COPY_JOB_FALLBACK;
+    }
+
+    job->size = st.st_size;
+
+    // don't overwrite anything: let copy_file_file() ask user
+    dst_fd = open (job->dst_local, O_WRONLY | O_CREAT | O_EXCL | O_NOCTTY, S_IRUSR | S_IWUSR);
+    if (dst_fd == -1)
+    {
+        close (src_fd);
+        return FILE_COPY_JOB_FALLBACK;
+    }
+
+    ok = file_copy_job_data (src_fd, dst_fd, &st);
+
+    if (ok && q->preserve_uidgid)
+        ok = fchown (dst_fd, st.st_uid, st.st_gid) == 0;
+
+    if (ok)
+    {
+        if (q->preserve)
+            ok = fchmod (dst_fd, st.st_mode & q->umask_kill & 07777) == 0;
+        else
+            (void) fchmod (dst_fd, q->new_mode & q->umask_kill & 07777);
+    }
+
+    // close() reports delayed write errors on network file systems
+    if (close (dst_fd) != 0)
+        ok = FALSE;
+    close (src_fd);
+
+    if (!ok)
+    {
+        unlink (job->dst_local);
+        return FILE_COPY_JOB_FALLBACK;
+    }
+
+    // like copy_file_file(), always sync timestamps after close
+    {
+        mc_timesbuf_t times;
+
+        vfs_get_timesbuf_from_stat (&st, &times);
+        (void) vfs_utime (job->dst_local, &times);
+    }
+
+    return FILE_COPY_JOB_OK;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+file_copy_queue_worker (gpointer data, gpointer user_data)
+{
+    file_copy_job_t *job = (file_copy_job_t *) data;
+    file_copy_queue_t *q = (file_copy_queue_t *) user_data;
+
+    if (g_atomic_int_get (&q->cancelled) != 0)
+        job->result = FILE_COPY_JOB_CANCELLED;
+    else
+        job->result = file_copy_job_run (q, job);
+
+    g_async_queue_push (q->done, job);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Create copy queue.
+ *
+ * @param ctx file operation context to get copy options from
+ *
+ * @return new copy queue or NULL if threads are not available.
+ */
+
+file_copy_queue_t *
+file_copy_queue_new (const file_op_context_t *ctx)
+{
+    file_copy_queue_t *q;
+    mode_t mask;
+
+#ifdef ENABLE_BACKGROUND
+    // a forked background process inherits the state of GLib shared thread pool but not
+    // its threads: jobs pushed there would never run, so copy files sequentially
+    if (mc_global.we_are_background)
+        return NULL;
+#endif
+
+    q = g_new0 (file_copy_queue_t, 1);
+    q->follow_links = ctx->follow_links;
+    q->preserve = ctx->preserve;
+    q->preserve_uidgid = ctx->preserve_uidgid;
+    q->umask_kill = ctx->umask_kill;
+
+    // umask() is not thread-safe, get it once here
+    mask = umask (-1);
+    umask (mask);
+    q->new_mode = 0666 & ~mask;
+
+    q->pool = g_thread_pool_new (file_copy_queue_worker, q, FILE_COPY_QUEUE_THREADS, FALSE, NULL);
+    if (q->pool == NULL)
+    {
+        g_free (q);
+        return NULL;
+    }
+
+    q->jobs = g_queue_new ();
+    q->done = g_async_queue_new ();
+
+    return q;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Cancel not started jobs, wait for running ones and free copy queue.
+ * Jobs not popped yet are lost.
+ */
+
+void
+file_copy_queue_free (file_copy_queue_t *q)
+{
+    file_copy_job_t *job;
+
+    if (q == NULL)
+        return;
+
+    file_copy_queue_cancel (q);
+
+    while ((job = file_copy_queue_pop (q, TRUE)) != NULL)
+        file_copy_job_free (job);
+
+    g_thread_pool_free (q->pool, FALSE, TRUE);
+    g_queue_free (q->jobs);
+    g_async_queue_unref (q->done);
+    g_free (q);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Queue file copy. Both files must be local.
+ *
+ * @param entry index of panel entry to return with the job, -1 if the file is not a panel entry
+ */
+
+void
+file_copy_queue_push (file_copy_queue_t *q, const char *src_path, const vfs_path_t *src_vpath,
+                      const char *dst_path, const vfs_path_t *dst_vpath, int entry)
+{
+    file_copy_job_t *job;
+
+    job = g_new0 (file_copy_job_t, 1);
+    job->src_path = g_strdup (src_path);
+    job->dst_path = g_strdup (dst_path);
+    job->src_local = g_strdup (vfs_path_get_last_path_str (src_vpath));
+    job->dst_local = g_strdup (vfs_path_get_last_path_str (dst_vpath));
+    job->entry = entry;
+
+    g_queue_push_tail (q->jobs, job);
+    g_thread_pool_push (q->pool, job, NULL);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get finished job. Jobs are got in the order of pushing.
+ *
+ * @param q copy queue
+ * @param wait wait for the oldest job if it isn't finished yet
+ *
+ * @return finished job or NULL if there are no jobs or the oldest job is not finished and @wait
+ *         is FALSE. Job must be freed with file_copy_job_free().
+ */
+
+file_copy_job_t *
+file_copy_queue_pop (file_copy_queue_t *q, gboolean wait)
+{
+    file_copy_job_t *head;
+
+    head = (file_copy_job_t *) g_queue_peek_head (q->jobs);
+    if (head == NULL)
+        return NULL;
+
+    // jobs are finished in any order: keep them until the older ones are finished
+    while (!head->finished)
+    {
+        file_copy_job_t *job;
+
+        if (wait)
+            job = (file_copy_job_t *) g_async_queue_pop (q->done);
+        else
+            job = (file_copy_job_t *) g_async_queue_try_pop (q->done);
+
+        if (job == NULL)
+            return NULL;
+
+        job->finished = TRUE;
+    }
+
+    return (file_copy_job_t *) g_queue_pop_head (q->jobs);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Check whether the caller should wait for finished jobs before queue new ones.
+ */
+
+gboolean
+file_copy_queue_is_full (const file_copy_queue_t *q)
+{
+    return g_queue_get_length (q->jobs) >= FILE_COPY_QUEUE_LENGTH;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Don't start queued jobs. Running jobs are finished, the rest ones are returned as cancelled.
+ */
+
+void
+file_copy_queue_cancel (file_copy_queue_t *q)
+{
+    g_atomic_int_set (&q->cancelled, 1);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+void
+file_copy_job_free (file_copy_job_t *job)
+{
+    g_free (job->src_path);
+    g_free (job->dst_path);
+    g_free (job->src_local);
+    g_free (job->dst_local);
+    g_free (job);
+}
+
+/* --------------------------------------------------------------------------------------------- */
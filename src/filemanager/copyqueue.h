@@ -0,0 +1,59 @@
+/** \file copyqueue.h
+ *  \brief Header: concurrent copying of small local files
+ */
+
+#ifndef MC__FILEMANAGER_COPYQUEUE_H
+#define MC__FILEMANAGER_COPYQUEUE_H
+
+#include "filegui.h"  // file_op_context_t
+
+/*** typedefs(not structures) and defined constants **********************************************/
+
+/*** enums ***************************************************************************************/
+
+typedef enum
+{
+    FILE_COPY_JOB_OK = 0,    // File was copied
+    FILE_COPY_JOB_FALLBACK,  // File was not copied: copy it with copy_file_file()
+    FILE_COPY_JOB_CANCELLED  // File was not copied: queue was cancelled
+} file_copy_job_result_t;
+
+/*** structures declarations (and typedefs of structures)*****************************************/
+
+typedef struct file_copy_queue_t file_copy_queue_t;
+
+typedef struct
+{
+    // paths as passed to copy_file_file()
+    char *src_path;
+    char *dst_path;
+    // paths in local file system
+    char *src_local;
+    char *dst_local;
+    // index of panel entry, -1 if the file is not a panel entry
+    int entry;
+    // size of copied file
+    off_t size;
+    file_copy_job_result_t result;
+    // result is got from worker
+    gboolean finished;
+} file_copy_job_t;
+
+/*** global variables defined in .c file *********************************************************/
+
+/*** declarations of public functions ************************************************************/
+
+file_copy_queue_t *file_copy_queue_new (const file_op_context_t *ctx);
+void file_copy_queue_free (file_copy_queue_t *q);
+
+void file_copy_queue_push (file_copy_queue_t *q, const char *src_path, const vfs_path_t *src_vpath,
+                           const char *dst_path, const vfs_path_t *dst_vpath, int entry);
+file_copy_job_t *file_copy_queue_pop (file_copy_queue_t *q, gboolean wait);
+gboolean file_copy_queue_is_full (const file_copy_queue_t *q);
+void file_copy_queue_cancel (file_copy_queue_t *q);
+
+void file_copy_job_free (file_copy_job_t *job);
+
+/*** inline functions ****************************************************************************/
+
+#endif
@@ -53,6 +53,9 @@
 
 /*** file scope macro definitions ****************************************************************/
 
+/* Length of runs sorted by insertion before merging */
+#define DIR_SORT_RUN 8
+
 #define MY_ISDIR(x)                                                                                \
     ((is_exe (x->st.st_mode) && !(S_ISDIR (x->st.st_mode) || link_isdir (x)) && exec_first)        \
          ? 1                                                                                       \
@@ -73,7 +76,7 @@ static gboolean case_sensitive = OS_SORT_CASE_SENSITIVE_DEFAULT;
 /* Are the exec_bit files top in list */
 static gboolean exec_first = TRUE;
 
-static dir_list dir_copy = { NULL, 0, 0, NULL };
+static dir_list dir_copy = { NULL, 0, 0, NULL, FALSE };
 
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
@@ -111,7 +114,7 @@ key_collate (const char *t1, const char *t2)
 static inline int
 compare_by_names (file_entry_t *a, file_entry_t *b)
 {
-    // create key if does not exist, key will be freed after sorting
+    // create key if does not exist, key is kept for next sortings
     if (a->name_sort_key == NULL)
         a->name_sort_key = str_create_key_for_filename (a->fname->str, case_sensitive);
     if (b->name_sort_key == NULL)
@@ -122,7 +125,7 @@ compare_by_names (file_entry_t *a, file_entry_t *b)
 
 /* --------------------------------------------------------------------------------------------- */
 /**
- * clear keys, should be call after sorting is finished.
+ * Release sort keys of list entries.
  */
 
 static void
@@ -135,22 +138,125 @@ clean_sort_keys (dir_list *list, int start, int count)
         file_entry_t *fentry;
 
         fentry = &list->list[i + start];
-        str_release_key (fentry->name_sort_key, case_sensitive);
+        str_release_key (fentry->name_sort_key, list->keys_case_sensitive);
         fentry->name_sort_key = NULL;
-        str_release_key (fentry->extension_sort_key, case_sensitive);
+        str_release_key (fentry->extension_sort_key, list->keys_case_sensitive);
         fentry->extension_sort_key = NULL;
     }
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Stable merge sort of entry indices. Entries themselves are not moved here.
+ * Runs which are already in order are merged by plain copying, so re-sorting
+ * of sorted list costs only n comparisons.
+ */
+
+static void
+sort_indices (file_entry_t *base, int *idx, int *tmp, int n, GCompareFunc sort)
+{
+    int *src = idx;
+    int *dst = tmp;
+    int width, i;
+
+    for (i = 0; i < n; i += DIR_SORT_RUN)
+    {
+        const int hi = MIN (i + DIR_SORT_RUN, n);
+        int j;
+
+        for (j = i + 1; j < hi; j++)
+        {
+            const int v = idx[j];
+            int k;
+
+            for (k = j; k > i && sort (&base[idx[k - 1]], &base[v]) > 0; k--)
+                idx[k] = idx[k - 1];
+            idx[k] = v;
+        }
+    }
+
+    for (width = DIR_SORT_RUN; width < n; width *= 2)
+    {
+        int *t;
+
+        for (i = 0; i < n; i += 2 * width)
+        {
+            const int mid = MIN (i + width, n);
+            const int hi = MIN (i + 2 * width, n);
+            int a = i, b = mid, k = i;
+
+            if (mid < hi && sort (&base[src[mid - 1]], &base[src[mid]]) > 0)
+                while (a < mid && b < hi)
+                    dst[k++] = sort (&base[src[b]], &base[src[a]]) < 0 ? src[b++] : src[a++];
+
+            while (a < mid)
+                dst[k++] = src[a++];
+            while (b < hi)
+                dst[k++] = src[b++];
+        }
+
+        t = src;
+        src = dst;
+        dst = t;
+    }
+
+    if (src != idx)
+        memcpy (idx, src, n * sizeof (*idx));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Sort entries: sort indices, then move each entry once into its place.
+ */
+
+static void
+sort_entries (file_entry_t *base, int n, GCompareFunc sort)
+{
+    int *idx, *tmp;
+    int i;
+
+    idx = g_new (int, 2 * n);
+    tmp = idx + n;
+
+    for (i = 0; i < n; i++)
+        idx[i] = i;
+
+    sort_indices (base, idx, tmp, n, sort);
+
+    // apply permutation in place: position j gets entry idx[j]
+    for (i = 0; i < n; i++)
+        if (idx[i] != i)
+        {
+            file_entry_t fentry = base[i];
+            int j = i;
+
+            while (idx[j] != i)
+            {
+                const int k = idx[j];
+
+                base[j] = base[k];
+                idx[j] = j;
+                j = k;
+            }
+
+            base[j] = fentry;
+            idx[j] = j;
+        }
+
+    g_free (idx);
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /**
  * If you change handle_dirent then check also handle_path.
+ * buf1 and link_buf can be already filled by mc_readdir_plus(). If buf1->st_mode is 0,
+ * mc_lstat() is used. If link_buf->st_mode is 0, the symlink target is stat'ed here.
  * @return FALSE = don't add, TRUE = add to the list
  */
 
 static gboolean
 handle_dirent (struct vfs_dirent *dp, const file_filter_t *filter, struct stat *buf1,
-               gboolean *link_to_dir, gboolean *stale_link)
+               const struct stat *link_buf, gboolean *link_to_dir, gboolean *stale_link)
 {
     vfs_path_t *vpath;
     gboolean ok = TRUE;
@@ -163,7 +269,7 @@ handle_dirent (struct vfs_dirent *dp, const file_filter_t *filter, struct stat *
         return FALSE;
 
     vpath = vfs_path_from_str (dp->d_name);
-    if (mc_lstat (vpath, buf1) == -1)
+    if (buf1->st_mode == 0 && mc_lstat (vpath, buf1) == -1)
     {
         /*
          * lstat() fails - such entries should be identified by
@@ -177,7 +283,13 @@ handle_dirent (struct vfs_dirent *dp, const file_filter_t *filter, struct stat *
         tree_store_mark_checked (dp->d_name);
 
     // A link to a file or a directory?
-    *link_to_dir = file_is_symlink_to_dir (vpath, buf1, stale_link);
+    if (S_ISLNK (buf1->st_mode) && link_buf->st_mode != 0)
+    {
+        *link_to_dir = S_ISDIR (link_buf->st_mode);
+        *stale_link = FALSE;
+    }
+    else
+        *link_to_dir = file_is_symlink_to_dir (vpath, buf1, stale_link);
 
     vfs_path_free (vpath, TRUE);
 
@@ -218,6 +330,27 @@ dir_get_dotdot_stat (const vfs_path_t *vpath, struct stat *st)
     return ret;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Set up sort options for comparison functions. Release keys which were created
+ * with other case sensitivity.
+ */
+
+static void
+dir_list_sort_prepare (dir_list *list, const dir_sort_options_t *sort_op)
+{
+    reverse = sort_op->reverse ? -1 : 1;
+    case_sensitive = sort_op->case_sensitive ? 1 : 0;
+    exec_first = sort_op->exec_first;
+
+    // keys kept from previous sorting are valid for the same case sensitivity only
+    if (list->keys_case_sensitive != (case_sensitive != 0))
+    {
+        clean_sort_keys (list, 0, list->len);
+        list->keys_case_sensitive = case_sensitive != 0;
+    }
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 static void
@@ -505,13 +638,8 @@ dir_list_sort (dir_list *list, GCompareFunc sort, const dir_sort_options_t *sort
         /* If there is an ".." entry the caller must take care to
            ensure that it occupies the first list element. */
         dot_dot_found = DIR_IS_DOTDOT (fentry->fname->str) ? 1 : 0;
-        reverse = sort_op->reverse ? -1 : 1;
-        case_sensitive = sort_op->case_sensitive ? 1 : 0;
-        exec_first = sort_op->exec_first;
-        qsort (&(list->list)[dot_dot_found], list->len - dot_dot_found, sizeof (file_entry_t),
-               sort);
-
-        clean_sort_keys (list, dot_dot_found, list->len - dot_dot_found);
+        dir_list_sort_prepare (list, sort_op);
+        sort_entries (&(list->list)[dot_dot_found], list->len - dot_dot_found, sort);
     }
 }
 
@@ -531,6 +659,7 @@ dir_list_clean (dir_list *list)
         fentry->fname = NULL;
     }
 
+    clean_sort_keys (list, 0, list->len);
     list->len = 0;
     // reduce memory usage
     dir_list_grow (list, DIR_LIST_MIN_SIZE - list->size);
@@ -551,6 +680,7 @@ dir_list_free_list (dir_list *list)
         g_string_free (fentry->fname, TRUE);
     }
 
+    clean_sort_keys (list, 0, list->len);
     MC_PTR_FREE (list->list);
     list->len = 0;
     list->size = 0;
@@ -636,7 +766,7 @@ dir_list_load (dir_list *list, const vfs_path_t *vpath, GCompareFunc sort,
 {
     DIR *dirp;
     struct vfs_dirent *dp;
-    struct stat st;
+    struct stat st, link_st;
     file_entry_t *fentry;
     const char *vpath_str;
     gboolean ret = TRUE;
@@ -662,14 +792,14 @@ dir_list_load (dir_list *list, const vfs_path_t *vpath, GCompareFunc sort,
     if (IS_PATH_SEP (vpath_str[0]) && vpath_str[1] == '\0')
         dir_list_clean (list);
 
-    while (ret && (dp = mc_readdir (dirp)) != NULL)
+    while (ret && (dp = mc_readdir_plus (dirp, &st, &link_st)) != NULL)
     {
         gboolean link_to_dir, stale_link;
 
         if (list->callback != NULL)
             list->callback (DIR_READ, dp);
 
-        if (!handle_dirent (dp, filter, &st, &link_to_dir, &stale_link))
+        if (!handle_dirent (dp, filter, &st, &link_st, &link_to_dir, &stale_link))
             continue;
 
         if (!dir_list_append (list, dp->d_name, &st, link_to_dir, stale_link))
@@ -710,9 +840,9 @@ dir_list_reload (dir_list *list, const vfs_path_t *vpath, GCompareFunc sort,
     DIR *dirp;
     struct vfs_dirent *dp;
     int i;
-    struct stat st;
+    struct stat st, link_st;
     int marked_cnt;
-    GHashTable *marked_files;
+    GHashTable *old_files;
     const char *tmp_path;
     gboolean ret = TRUE;
 
@@ -728,7 +858,7 @@ dir_list_reload (dir_list *list, const vfs_path_t *vpath, GCompareFunc sort,
 
     tree_store_start_check (vpath);
 
-    marked_files = g_hash_table_new (g_str_hash, g_str_equal);
+    old_files = g_hash_table_new (g_str_hash, g_str_equal);
     alloc_dir_copy (list->len);
     for (marked_cnt = i = 0; i < list->len; i++)
     {
@@ -742,17 +872,19 @@ dir_list_reload (dir_list *list, const vfs_path_t *vpath, GCompareFunc sort,
         dfentry->f.dir_size_computed = fentry->f.dir_size_computed;
         dfentry->f.link_to_dir = fentry->f.link_to_dir;
         dfentry->f.stale_link = fentry->f.stale_link;
-        dfentry->name_sort_key = NULL;
-        dfentry->extension_sort_key = NULL;
+        // move sort keys to reuse them for files which are still here
+        dfentry->name_sort_key = fentry->name_sort_key;
+        dfentry->extension_sort_key = fentry->extension_sort_key;
+        fentry->name_sort_key = NULL;
+        fentry->extension_sort_key = NULL;
+        g_hash_table_insert (old_files, dfentry->fname->str, dfentry);
         if (fentry->f.marked != 0)
-        {
-            g_hash_table_insert (marked_files, dfentry->fname->str, dfentry);
             marked_cnt++;
-        }
     }
 
     // save len for later dir_list_clean()
     dir_copy.len = list->len;
+    dir_copy.keys_case_sensitive = list->keys_case_sensitive;
 
     /* Add ".." except to the root directory. The ".." entry
        (if any) must be the first in the list. */
@@ -781,31 +913,39 @@ dir_list_reload (dir_list *list, const vfs_path_t *vpath, GCompareFunc sort,
         }
     }
 
-    while (ret && (dp = mc_readdir (dirp)) != NULL)
+    while (ret && (dp = mc_readdir_plus (dirp, &st, &link_st)) != NULL)
     {
         gboolean link_to_dir, stale_link;
 
         if (list->callback != NULL)
             list->callback (DIR_READ, dp);
 
-        if (!handle_dirent (dp, filter, &st, &link_to_dir, &stale_link))
+        if (!handle_dirent (dp, filter, &st, &link_st, &link_to_dir, &stale_link))
             continue;
 
         if (!dir_list_append (list, dp->d_name, &st, link_to_dir, stale_link))
             ret = FALSE;
         else
         {
-            file_entry_t *fentry;
+            file_entry_t *fentry, *dfentry;
 
             fentry = &list->list[list->len - 1];
+            dfentry = (file_entry_t *) g_hash_table_lookup (old_files, dp->d_name);
+
+            if (dfentry != NULL)
+            {
+                fentry->name_sort_key = dfentry->name_sort_key;
+                fentry->extension_sort_key = dfentry->extension_sort_key;
+                dfentry->name_sort_key = NULL;
+                dfentry->extension_sort_key = NULL;
+            }
 
             /*
              * If we have marked files in the copy, scan through the copy
              * to find matching file.  Decrease number of remaining marks if
              * we copied one.
              */
-            fentry->f.marked =
-                (marked_cnt > 0 && g_hash_table_lookup (marked_files, dp->d_name) != NULL) ? 1 : 0;
+            fentry->f.marked = (marked_cnt > 0 && dfentry != NULL && dfentry->f.marked != 0) ? 1 : 0;
             if (fentry->f.marked != 0)
                 marked_cnt--;
         }
@@ -819,12 +959,136 @@ dir_list_reload (dir_list *list, const vfs_path_t *vpath, GCompareFunc sort,
     mc_closedir (dirp);
     tree_store_end_check ();
 
-    g_hash_table_destroy (marked_files);
+    g_hash_table_destroy (old_files);
     dir_list_free_list (&dir_copy);
 
     return ret;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Update entries with given names: read them again, add new ones and remove deleted ones.
+ * Marks of files are kept. Names are relative to the current directory.
+ *
+ * Changed entries are taken out of the list, then read, sorted and merged back, so the list
+ * must be sorted with the same function and options. The cost is linear in the list length
+ * plus sorting of changed entries only.
+ *
+ * @param list directory list
+ * @param names set of names of changed entries
+ * @param sort sort function
+ * @param sort_op sort options
+ * @param filter file name filter
+ *
+ * @return FALSE on failure (list is not changed), TRUE on success
+ */
+
+gboolean
+dir_list_update (dir_list *list, GHashTable *names, GCompareFunc sort,
+                 const dir_sort_options_t *sort_op, const file_filter_t *filter)
+{
+    dir_list changed = { NULL, 0, 0, NULL, FALSE };
+    GHashTable *changed_files;
+    GHashTableIter iter;
+    gpointer key;
+    int first, i, j, k;
+
+    dir_list_sort_prepare (list, sort_op);
+    changed.keys_case_sensitive = list->keys_case_sensitive;
+
+    // read entries which still exist
+    g_hash_table_iter_init (&iter, names);
+    while (g_hash_table_iter_next (&iter, &key, NULL))
+    {
+        const char *name = (const char *) key;
+        struct vfs_dirent *dp;
+        vfs_path_t *vpath;
+        struct stat st, link_st;
+        gboolean link_to_dir, stale_link, ok;
+
+        vpath = vfs_path_from_str (name);
+        ok = mc_lstat (vpath, &st) == 0;
+        vfs_path_free (vpath, TRUE);
+        if (!ok)
+            continue;
+
+        link_st.st_mode = 0;
+        dp = vfs_dirent_init (NULL, name, st.st_ino, DT_UNKNOWN);
+        ok = handle_dirent (dp, filter, &st, &link_st, &link_to_dir, &stale_link);
+        vfs_dirent_free (dp);
+
+        if (ok && !dir_list_append (&changed, name, &st, link_to_dir, stale_link))
+        {
+            dir_list_free_list (&changed);
+            return FALSE;
+        }
+    }
+
+    // make room for merge
+    if (list->size < list->len + changed.len
+        && !dir_list_grow (list, list->len + changed.len - list->size))
+    {
+        dir_list_free_list (&changed);
+        return FALSE;
+    }
+
+    changed_files = g_hash_table_new (g_str_hash, g_str_equal);
+    for (i = 0; i < changed.len; i++)
+        g_hash_table_insert (changed_files, changed.list[i].fname->str, &changed.list[i]);
+
+    // ".." (if any) is the first entry and never changes
+    first = (list->len != 0 && DIR_IS_DOTDOT (list->list[0].fname->str)) ? 1 : 0;
+
+    // take old entries out, keep their marks and sort keys
+    for (i = j = first; i < list->len; i++)
+    {
+        file_entry_t *fentry = &list->list[i];
+        file_entry_t *cfentry;
+
+        if (!g_hash_table_contains (names, fentry->fname->str))
+        {
+            if (j != i)
+                list->list[j] = *fentry;
+            j++;
+            continue;
+        }
+
+        cfentry = (file_entry_t *) g_hash_table_lookup (changed_files, fentry->fname->str);
+        if (cfentry != NULL)
+        {
+            cfentry->f.marked = fentry->f.marked;
+            cfentry->name_sort_key = fentry->name_sort_key;
+            cfentry->extension_sort_key = fentry->extension_sort_key;
+        }
+        else
+        {
+            str_release_key (fentry->name_sort_key, list->keys_case_sensitive);
+            str_release_key (fentry->extension_sort_key, list->keys_case_sensitive);
+        }
+
+        g_string_free (fentry->fname, TRUE);
+    }
+    list->len = j;
+
+    g_hash_table_destroy (changed_files);
+
+    if (sort != (GCompareFunc) unsorted)
+        sort_entries (changed.list, changed.len, sort);
+
+    // merge from the end, old entries go first among equal ones
+    for (i = list->len - 1, j = changed.len - 1, k = list->len + changed.len - 1; j >= 0; k--)
+        if (i >= first && sort (&list->list[i], &changed.list[j]) > 0)
+            list->list[k] = list->list[i--];
+        else
+            list->list[k] = changed.list[j--];
+
+    list->len += changed.len;
+    // entries are moved to the list
+    g_free (changed.list);
+
+    return TRUE;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 void
@@ -50,6 +50,7 @@ typedef struct
     int size;                 // number of allocated elements in list (capacity)
     int len;                  // number of used elements in list
     dir_list_cb_fn callback;  // callback to visualize of directory read
+    gboolean keys_case_sensitive;  // case sensitivity of sort keys kept in entries
 } dir_list;
 
 /**
@@ -82,6 +83,8 @@ gboolean dir_list_load (dir_list *list, const vfs_path_t *vpath, GCompareFunc so
                         const dir_sort_options_t *sort_op, const file_filter_t *filter);
 gboolean dir_list_reload (dir_list *list, const vfs_path_t *vpath, GCompareFunc sort,
                           const dir_sort_options_t *sort_op, const file_filter_t *filter);
+gboolean dir_list_update (dir_list *list, GHashTable *names, GCompareFunc sort,
+                          const dir_sort_options_t *sort_op, const file_filter_t *filter);
 void dir_list_sort (dir_list *list, GCompareFunc sort, const dir_sort_options_t *sort_op);
 gboolean dir_list_init (dir_list *list);
 void dir_list_clean (dir_list *list);
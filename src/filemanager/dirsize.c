@@ -0,0 +1,459 @@
+/*
+   Parallel computing of local directory size.
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** \file dirsize.c
+ *  \brief Source: parallel computing of local directory size
+ *
+ *  Directories of a tree are scanned by several threads taking directories from the shared
+ *  stack. Entries are stat'ed with fstatat() relative to the directory descriptor, so the
+ *  full path is resolved once per directory rather than once per file. Threads are started
+ *  once per operation and are reused for every marked directory.
+ *
+ *  Results are not cached between scans: a file changed in place changes neither times nor
+ *  size of its directory, so any cached size would have to be validated by stat() of every
+ *  file, which is what the scan does anyway.
+ *
+ *  Threads call the system directly and never enter VFS or UI, which are not thread-safe.
+ *  The status dialog is updated by the calling thread.
+ */
+
+#include <config.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "lib/global.h"
+#include "lib/vfs/vfs.h"
+#include "lib/util.h"  // mc_time_elapsed()
+
+#include "dirsize.h"
+
+/*** global variables ****************************************************************************/
+
+/*** file scope macro definitions ****************************************************************/
+
+#if defined(HAVE_FSTATAT) && (defined(HAVE_DIRFD) || defined(dirfd)) && !defined(HAVE_STATLSTAT)
+#define DIRSIZE_LOCAL_WALK 1
+#endif
+
+// number of scanning threads
+#define DIRSIZE_THREADS 8
+
+/*** file scope type declarations ****************************************************************/
+
+#ifdef DIRSIZE_LOCAL_WALK
+/* scanned directory */
+typedef struct
+{
+    dev_t dev;
+    ino_t ino;
+} dirsize_dir_t;
+
+/* scanning of trees by threads living during the whole operation */
+typedef struct
+{
+    gboolean follow_links;
+
+    GMutex lock;
+    GCond cond;
+    GThread *threads[DIRSIZE_THREADS];
+    int n_threads;
+    // threads should exit
+    gboolean quit;
+    // paths of directories to scan
+    GPtrArray *stack;
+    // number of directories being scanned
+    guint active;
+    // scanning of current tree is stopped. Read without lock, use g_atomic_int_*()
+    gint stop;
+    // already scanned directories to avoid loops of symlinks
+    GHashTable *visited;
+
+    size_t dir_count;
+    size_t count;
+    uintmax_t size;
+    // last scanned directory
+    char *current;
+} dirsize_walk_t;
+#endif
+
+/*** forward declarations (file scope functions) *************************************************/
+
+/*** file scope variables ************************************************************************/
+
+/* --------------------------------------------------------------------------------------------- */
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+#ifdef DIRSIZE_LOCAL_WALK
+static guint
+dirsize_dir_hash (gconstpointer v)
+{
+    const dirsize_dir_t *d = (const dirsize_dir_t *) v;
+
+    return (guint) d->ino ^ ((guint) d->dev << 1);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+dirsize_dir_equal (gconstpointer a, gconstpointer b)
+{
+    const dirsize_dir_t *d1 = (const dirsize_dir_t *) a;
+    const dirsize_dir_t *d2 = (const dirsize_dir_t *) b;
+
+    return d1->ino == d2->ino && d1->dev == d2->dev;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Push subdirectories of directory to the stack.
+ */
+
+static void
+dirsize_walk_push (dirsize_walk_t *w, const char *path, char **names, size_t len)
+{
+    size_t i;
+
+    if (len == 0)
+        return;
+
+    g_mutex_lock (&w->lock);
+    for (i = 0; i < len; i++)
+        g_ptr_array_add (w->stack, g_build_filename (path, names[i], (char *) NULL));
+    g_cond_broadcast (&w->cond);
+    g_mutex_unlock (&w->lock);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Read directory, get size of files and push subdirectories to the stack.
+ */
+
+static void
+dirsize_walk_dir (dirsize_walk_t *w, const char *path)
+{
+    DIR *dir;
+    int fd;
+    struct stat st;
+    dirsize_dir_t key;
+    gboolean visited;
+    struct dirent *dirent;
+    GPtrArray *subdirs;
+    size_t count = 0;
+    uintmax_t size = 0;
+
+    g_mutex_lock (&w->lock);
+    w->dir_count++;
+    g_free (w->current);
+    w->current = g_strdup (path);
+    g_mutex_unlock (&w->lock);
+
+    dir = opendir (path);
+    if (dir == NULL)
+        return;
+
+    fd = dirfd (dir);
+    if (fstat (fd, &st) != 0)
+    {
+        closedir (dir);
+        return;
+    }
+
+    key.dev = st.st_dev;
+    key.ino = st.st_ino;
+
+    g_mutex_lock (&w->lock);
+    visited = g_hash_table_contains (w->visited, &key);
+    if (!visited)
+    {
+        dirsize_dir_t *d;
+
+        d = g_new (dirsize_dir_t, 1);
+        *d = key;
+        g_hash_table_add (w->visited, d);
+    }
+    g_mutex_unlock (&w->lock);
+
+    if (visited)
+    {
+        closedir (dir);
+        return;
+    }
+
+    subdirs = g_ptr_array_new_with_free_func (g_free);
+
+    while (g_atomic_int_get (&w->stop) == 0 && (dirent = readdir (dir)) != NULL)
+    {
+        struct stat s;
+
+        if (DIR_IS_DOT (dirent->d_name) || DIR_IS_DOTDOT (dirent->d_name))
+            continue;
+
+        if (fstatat (fd, dirent->d_name, &s, w->follow_links ? 0 : AT_SYMLINK_NOFOLLOW) != 0)
+            continue;
+
+        if (S_ISDIR (s.st_mode))
+            g_ptr_array_add (subdirs, g_strdup (dirent->d_name));
+        else
+        {
+            count++;
+            size += (uintmax_t) s.st_size;
+        }
+    }
+
+    closedir (dir);
+
+    dirsize_walk_push (w, path, (char **) subdirs->pdata, subdirs->len);
+    g_ptr_array_free (subdirs, TRUE);
+
+    g_mutex_lock (&w->lock);
+    w->count += count;
+    w->size += size;
+    g_mutex_unlock (&w->lock);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Scan directories from the stack until the stack is empty or scanning is stopped.
+ * Must be called with locked walk.
+ */
+
+static void
+dirsize_walk_run (dirsize_walk_t *w)
+{
+    while (g_atomic_int_get (&w->stop) == 0 && w->stack->len != 0)
+    {
+        char *path;
+
+        // depth first: the last pushed directory
+        path = (char *) g_ptr_array_remove_index (w->stack, w->stack->len - 1);
+        w->active++;
+        g_mutex_unlock (&w->lock);
+
+        dirsize_walk_dir (w, path);
+        g_free (path);
+
+        g_mutex_lock (&w->lock);
+        w->active--;
+        if (w->active == 0)
+            g_cond_broadcast (&w->cond);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gpointer
+dirsize_walk_thread (gpointer data)
+{
+    dirsize_walk_t *w = (dirsize_walk_t *) data;
+
+    g_mutex_lock (&w->lock);
+
+    while (!w->quit)
+    {
+        if (w->stack->len == 0 || g_atomic_int_get (&w->stop) != 0)
+            g_cond_wait (&w->cond, &w->lock);
+        else
+            dirsize_walk_run (w);
+    }
+
+    g_mutex_unlock (&w->lock);
+
+    return NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Create walk and start scanning threads. Threads wait for directories until walk is freed.
+ */
+
+static dirsize_walk_t *
+dirsize_walk_new (void)
+{
+    dirsize_walk_t *w;
+    int i;
+
+    w = g_new0 (dirsize_walk_t, 1);
+    g_mutex_init (&w->lock);
+    g_cond_init (&w->cond);
+    w->stack = g_ptr_array_new ();
+    w->visited = g_hash_table_new_full (dirsize_dir_hash, dirsize_dir_equal, g_free, NULL);
+
+    for (i = 0; i < DIRSIZE_THREADS; i++)
+    {
+        w->threads[w->n_threads] = g_thread_try_new ("mc-dirsize", dirsize_walk_thread, w, NULL);
+        if (w->threads[w->n_threads] != NULL)
+            w->n_threads++;
+    }
+
+    return w;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+dirsize_walk_free (dirsize_walk_t *w)
+{
+    int i;
+
+    g_mutex_lock (&w->lock);
+    w->quit = TRUE;
+    g_cond_broadcast (&w->cond);
+    g_mutex_unlock (&w->lock);
+
+    for (i = 0; i < w->n_threads; i++)
+        g_thread_join (w->threads[i]);
+
+    g_ptr_array_free (w->stack, TRUE);
+    g_hash_table_destroy (w->visited);
+    g_cond_clear (&w->cond);
+    g_mutex_clear (&w->lock);
+    g_free (w);
+}
+#endif
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Compute the number and size of files in local directory tree.
+ * Counters are increased like do_compute_dir_size() does.
+ *
+ * @param status result of computing: FILE_CONT or status returned by dialog update
+ *
+ * @return FALSE if directory is not local and should be scanned via VFS, TRUE otherwise
+ */
+
+gboolean
+dirsize_compute_local (const vfs_path_t *dirname_vpath, dirsize_status_msg_t *dsm,
+                       size_t *dir_count, size_t *ret_marked, uintmax_t *ret_total,
+                       gboolean follow_links, FileProgressStatus *status)
+{
+#ifdef DIRSIZE_LOCAL_WALK
+    static gint64 timestamp = 0;
+    // update with 25 FPS rate
+    static const gint64 delay = G_USEC_PER_SEC / 25;
+
+    status_msg_t *sm = STATUS_MSG (dsm);
+    dirsize_walk_t *w;
+
+    if (!vfs_file_is_local (dirname_vpath))
+        return FALSE;
+
+    *status = FILE_CONT;
+
+    // threads are started once per operation and are reused for all marked directories
+    if (dsm->walk == NULL)
+        dsm->walk = dirsize_walk_new ();
+    w = (dirsize_walk_t *) dsm->walk;
+
+    g_mutex_lock (&w->lock);
+
+    w->follow_links = follow_links;
+    w->dir_count = 0;
+    w->count = 0;
+    w->size = 0;
+    g_ptr_array_add (w->stack, g_strdup (vfs_path_get_last_path_str (dirname_vpath)));
+    g_cond_broadcast (&w->cond);
+
+    while (g_atomic_int_get (&w->stop) == 0 && (w->stack->len != 0 || w->active != 0))
+    {
+        if (w->n_threads == 0)
+            // no threads: scan in this thread without updating of dialog
+            dirsize_walk_run (w);
+        else
+            g_cond_wait_until (&w->cond, &w->lock, g_get_monotonic_time () + delay);
+
+        if (sm->update != NULL && w->current != NULL && mc_time_elapsed (&timestamp, delay))
+        {
+            vfs_path_t *vpath;
+
+            vpath = vfs_path_from_str (w->current);
+            dsm->dir_count = *dir_count + w->dir_count;
+            dsm->total_size = *ret_total + w->size;
+            g_mutex_unlock (&w->lock);
+
+            dsm->dirname_vpath = vpath;
+            *status = sm->update (sm);
+            dsm->dirname_vpath = NULL;
+            vfs_path_free (vpath, TRUE);
+
+            g_mutex_lock (&w->lock);
+            if (*status != FILE_CONT)
+                g_atomic_int_set (&w->stop, 1);
+        }
+    }
+
+    // if scanning was stopped, wait for directories being scanned and forget the rest
+    while (w->active != 0)
+        g_cond_wait (&w->cond, &w->lock);
+    g_ptr_array_foreach (w->stack, (GFunc) g_free, NULL);
+    g_ptr_array_set_size (w->stack, 0);
+    g_atomic_int_set (&w->stop, 0);
+
+    *dir_count += w->dir_count;
+    *ret_marked += w->count;
+    *ret_total += w->size;
+
+    g_hash_table_remove_all (w->visited);
+    MC_PTR_FREE (w->current);
+
+    g_mutex_unlock (&w->lock);
+
+    return TRUE;
+#else
+    (void) dirname_vpath;
+    (void) dsm;
+    (void) dir_count;
+    (void) ret_marked;
+    (void) ret_total;
+    (void) follow_links;
+    (void) status;
+
+    return FALSE;
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Stop threads started by dirsize_compute_local() for the operation.
+ */
+
+void
+dirsize_local_done (dirsize_status_msg_t *dsm)
+{
+#ifdef DIRSIZE_LOCAL_WALK
+    if (dsm->walk != NULL)
+    {
+        dirsize_walk_free ((dirsize_walk_t *) dsm->walk);
+        dsm->walk = NULL;
+    }
+#else
+    (void) dsm;
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
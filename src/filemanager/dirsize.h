@@ -0,0 +1,27 @@
+/** \file dirsize.h
+ *  \brief Header: parallel computing of local directory size
+ */
+
+#ifndef MC__FILEMANAGER_DIRSIZE_H
+#define MC__FILEMANAGER_DIRSIZE_H
+
+#include "file.h"  // dirsize_status_msg_t
+
+/*** typedefs(not structures) and defined constants **********************************************/
+
+/*** enums ***************************************************************************************/
+
+/*** structures declarations (and typedefs of structures)*****************************************/
+
+/*** global variables defined in .c file *********************************************************/
+
+/*** declarations of public functions ************************************************************/
+
+gboolean dirsize_compute_local (const vfs_path_t *dirname_vpath, dirsize_status_msg_t *dsm,
+                                size_t *dir_count, size_t *ret_marked, uintmax_t *ret_total,
+                                gboolean follow_links, FileProgressStatus *status);
+void dirsize_local_done (dirsize_status_msg_t *dsm);
+
+/*** inline functions ****************************************************************************/
+
+#endif
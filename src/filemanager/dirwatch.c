@@ -0,0 +1,268 @@
+/*
+   Watcher of changes in local directories.
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** \file dirwatch.c
+ *  \brief Source: watcher of changes in local directories
+ *
+ *  Watcher reads inotify events of the directory from the main loop (see add_select_channel())
+ *  and queues names of created, deleted, moved and changed entries. The owner is notified
+ *  and takes the queued names when it is able to update its view of the directory.
+ *
+ *  If events are lost, the directory itself is deleted or moved away, or too many names are
+ *  queued, only the request to reload the whole directory is kept.
+ *
+ *  Without inotify no watcher is created.
+ */
+
+#include <config.h>
+
+#include <errno.h>
+#include <unistd.h>
+#ifdef HAVE_SYS_INOTIFY_H
+#include <sys/inotify.h>
+#endif
+
+#include "lib/global.h"
+#include "lib/tty/key.h"  // add_select_channel(), delete_select_channel()
+#include "lib/vfs/vfs.h"
+
+#include "dirwatch.h"
+
+/*** global variables ****************************************************************************/
+
+/*** file scope macro definitions ****************************************************************/
+
+#ifdef HAVE_SYS_INOTIFY_H
+/* content changes are reported when file is closed, not on every write */
+#define DIR_WATCH_EVENTS                                                                           \
+    (IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO              \
+     | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR)
+
+/* events after which the whole directory should be reloaded */
+#define DIR_WATCH_RELOAD_EVENTS                                                                    \
+    (IN_Q_OVERFLOW | IN_DELETE_SELF | IN_MOVE_SELF | IN_UNMOUNT | IN_IGNORED)
+#endif
+
+/* reloading the whole directory is cheaper than updating so many entries one by one */
+#define DIR_WATCH_MAX_CHANGES 4096
+
+/*** file scope type declarations ****************************************************************/
+
+struct dir_watch_t
+{
+    vfs_path_t *vpath;    // watched directory
+    int fd;               // inotify descriptor
+    GHashTable *changes;  // names of changed entries
+    gboolean reload;      // changes are lost, the whole directory should be reloaded
+    gboolean stale;       // watch is removed or events are lost, watcher should be recreated
+    dir_watch_fn callback;
+    void *data;
+};
+
+/*** forward declarations (file scope functions) *************************************************/
+
+/*** file scope variables ************************************************************************/
+
+/* --------------------------------------------------------------------------------------------- */
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+#ifdef HAVE_SYS_INOTIFY_H
+static int
+dir_watch_read (int fd, void *info)
+{
+    dir_watch_t *w = (dir_watch_t *) info;
+    union
+    {
+        struct inotify_event event;  // for alignment
+        char buf[4096];
+    } u;
+    ssize_t len;
+    gboolean changed = FALSE;
+
+    // descriptor is non-blocking: read until the queue is empty
+    while ((len = read (fd, u.buf, sizeof (u.buf))) != 0)
+    {
+        const char *p;
+
+        if (len == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        for (p = u.buf; p < u.buf + len;)
+        {
+            const struct inotify_event *event = (const struct inotify_event *) p;
+
+            if ((event->mask & DIR_WATCH_RELOAD_EVENTS) != 0)
+            {
+                w->reload = TRUE;
+                w->stale = TRUE;
+            }
+            else if (event->len != 0 && !w->reload)
+                g_hash_table_add (w->changes, g_strdup (event->name));
+
+            changed = TRUE;
+            p += sizeof (*event) + event->len;
+        }
+    }
+
+    if (g_hash_table_size (w->changes) > DIR_WATCH_MAX_CHANGES)
+        w->reload = TRUE;
+
+    if (w->reload)
+        g_hash_table_remove_all (w->changes);
+
+    // callback can free the watcher
+    if (changed)
+        w->callback (w->data);
+
+    return 0;
+}
+#endif
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Start watching of directory.
+ *
+ * @param vpath directory
+ * @param callback function called when changes are queued
+ * @param data data for @callback
+ *
+ * @return new watcher or NULL if the directory cannot be watched (not local, no inotify, etc)
+ */
+
+dir_watch_t *
+dir_watch_new (const vfs_path_t *vpath, dir_watch_fn callback, void *data)
+{
+#ifdef HAVE_SYS_INOTIFY_H
+    dir_watch_t *w;
+    int fd;
+
+    if (!vfs_file_is_local (vpath))
+        return NULL;
+
+    fd = inotify_init1 (IN_NONBLOCK | IN_CLOEXEC);
+    if (fd == -1)
+        return NULL;
+
+    if (inotify_add_watch (fd, vfs_path_as_str (vpath), DIR_WATCH_EVENTS) == -1)
+    {
+        close (fd);
+        return NULL;
+    }
+
+    w = g_new0 (dir_watch_t, 1);
+    w->vpath = vfs_path_clone (vpath);
+    w->fd = fd;
+    w->changes = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    w->callback = callback;
+    w->data = data;
+
+    add_select_channel (fd, dir_watch_read, w);
+
+    return w;
+#else
+    (void) vpath;
+    (void) callback;
+    (void) data;
+
+    return NULL;
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+void
+dir_watch_free (dir_watch_t *w)
+{
+    if (w == NULL)
+        return;
+
+    delete_select_channel (w->fd);
+    close (w->fd);
+    g_hash_table_destroy (w->changes);
+    vfs_path_free (w->vpath, TRUE);
+    g_free (w);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Check whether watcher can be reused for directory.
+ *
+ * After the directory was deleted, moved away or unmounted the kernel watch is gone, even if
+ * a new directory appears at the same path, so such watcher is never reused.
+ *
+ * @param w watcher
+ * @param vpath directory
+ *
+ * @return TRUE if @w is alive and watches @vpath
+ */
+
+gboolean
+dir_watch_is_for (const dir_watch_t *w, const vfs_path_t *vpath)
+{
+    return (w != NULL && !w->stale && vfs_path_equal (w->vpath, vpath));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Take changes queued since the last call.
+ *
+ * @param w watcher
+ * @param reload pointer to store whether the whole directory should be reloaded
+ *
+ * @return names of changed entries (caller should destroy the table) or NULL if there are none
+ */
+
+GHashTable *
+dir_watch_take_changes (dir_watch_t *w, gboolean *reload)
+{
+    GHashTable *changes = NULL;
+
+    *reload = w->reload;
+    w->reload = FALSE;
+
+    if (g_hash_table_size (w->changes) != 0)
+    {
+        changes = w->changes;
+        w->changes = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+    }
+
+    return changes;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Drop queued changes: directory was just reloaded */
+
+void
+dir_watch_clear (dir_watch_t *w)
+{
+    w->reload = FALSE;
+    g_hash_table_remove_all (w->changes);
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,34 @@
+/** \file dirwatch.h
+ *  \brief Header: watcher of changes in local directories
+ */
+
+#ifndef MC__FILEMANAGER_DIRWATCH_H
+#define MC__FILEMANAGER_DIRWATCH_H
+
+#include "lib/global.h"
+#include "lib/vfs/vfs.h"
+
+/*** typedefs(not structures) and defined constants **********************************************/
+
+/* called when changes are queued */
+typedef void (*dir_watch_fn) (void *data);
+
+/*** enums ***************************************************************************************/
+
+/*** structures declarations (and typedefs of structures)*****************************************/
+
+typedef struct dir_watch_t dir_watch_t;
+
+/*** global variables defined in .c file *********************************************************/
+
+/*** declarations of public functions ************************************************************/
+
+dir_watch_t *dir_watch_new (const vfs_path_t *vpath, dir_watch_fn callback, void *data);
+void dir_watch_free (dir_watch_t *w);
+gboolean dir_watch_is_for (const dir_watch_t *w, const vfs_path_t *vpath);
+GHashTable *dir_watch_take_changes (dir_watch_t *w, gboolean *reload);
+void dir_watch_clear (dir_watch_t *w);
+
+/*** inline functions ****************************************************************************/
+
+#endif
@@ -53,6 +53,7 @@
 
 #include <ctype.h>
 #include <errno.h>
+#include <fcntl.h>  // openat()
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -82,6 +83,9 @@
 #include "filemanager.h"  // other_panel
 #include "layout.h"       // rotate_dash()
 #include "ioblksize.h"    // io_blksize()
+#include "readahead.h"
+#include "copyqueue.h"
+#include "dirsize.h"  // dirsize_compute_local()
 
 #include "file.h"
 
@@ -103,6 +107,22 @@ const char *op_names[3] = {
 #define FILEOP_UPDATE_INTERVAL_US   (FILEOP_UPDATE_INTERVAL * G_USEC_PER_SEC)
 #define FILEOP_STALLING_INTERVAL_US (FILEOP_STALLING_INTERVAL * G_USEC_PER_SEC)
 
+/* Local directory trees are removed using descriptors of directories instead of full paths */
+#if defined(HAVE_OPENAT) && defined(HAVE_UNLINKAT) && defined(HAVE_FDOPENDIR) && defined(HAVE_FSTATAT)
+#define ERASE_AT 1
+#endif
+
+#ifndef O_DIRECTORY
+#define O_DIRECTORY 0
+#endif
+
+#ifndef O_NOFOLLOW
+#define O_NOFOLLOW 0
+#endif
+
+/* Size of chunk copied in kernel at once: small enough to keep the progress dialog live */
+#define FILEOP_KERNEL_COPY_CHUNK (8 * 1024 * 1024)
+
 /*** file scope type declarations ****************************************************************/
 
 /* This is a hard link cache */
@@ -635,6 +655,11 @@ do_compute_dir_size (const vfs_path_t *dirname_vpath, dirsize_status_msg_t *dsm,
     struct vfs_dirent *dirent;
     FileProgressStatus ret = FILE_CONT;
 
+    // local tree is scanned in parallel at once
+    if (dirsize_compute_local (dirname_vpath, dsm, dir_count, ret_marked, ret_total,
+                               stat_func == mc_stat, &ret))
+        return ret;
+
     (*dir_count)++;
 
     dir = mc_opendir (dirname_vpath);
@@ -1385,7 +1410,7 @@ erase_file (file_op_context_t *ctx, const vfs_path_t *vpath)
     FileProgressStatus return_status;
 
     // check buttons if deleting info was changed
-    if (file_progress_show_deleting (ctx, vpath, &ctx->total_progress_count))
+    if (file_progress_show_deleting (ctx, vfs_path_as_str (vpath), &ctx->total_progress_count))
     {
         file_progress_show_count (ctx);
         if (file_progress_check_buttons (ctx) == FILE_ABORT)
@@ -1431,6 +1456,144 @@ try_erase_dir (file_op_context_t *ctx, const vfs_path_t *vpath)
 
 /* --------------------------------------------------------------------------------------------- */
 
+#ifdef ERASE_AT
+/**
+ * Remove file relative to the directory descriptor like erase_file() does.
+ *
+ * @param dir_fd descriptor of directory
+ * @param name name of file in the directory
+ * @param path full path of file for messages
+ */
+
+static FileProgressStatus
+erase_file_at (file_op_context_t *ctx, int dir_fd, const char *name, const char *path)
+{
+    FileProgressStatus return_status;
+
+    // check buttons if deleting info was changed
+    if (file_progress_show_deleting (ctx, path, &ctx->total_progress_count))
+    {
+        file_progress_show_count (ctx);
+        if (file_progress_check_buttons (ctx) == FILE_ABORT)
+            return FILE_ABORT;
+
+        mc_refresh ();
+    }
+
+    while (unlinkat (dir_fd, name, 0) != 0 && !ctx->ignore_all)
+    {
+        return_status = file_error (ctx, TRUE, _ ("Cannot remove file\n%s"), path);
+        if (return_status == FILE_RETRY)
+            continue;
+        if (return_status == FILE_IGNORE_ALL)
+            ctx->ignore_all = TRUE;
+        if (return_status == FILE_ABORT)
+            return FILE_ABORT;
+        break;
+    }
+
+    if (ctx->total_progress_count == 0)
+        return FILE_CONT;
+
+    return file_progress_check_buttons (ctx);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static FileProgressStatus
+try_erase_dir_at (file_op_context_t *ctx, int dir_fd, const char *name, const char *path)
+{
+    FileProgressStatus return_status = FILE_CONT;
+
+    while (unlinkat (dir_fd, name, AT_REMOVEDIR) != 0 && !ctx->ignore_all)
+    {
+        return_status = file_error (ctx, TRUE, _ ("Cannot remove directory\n%s"), path);
+        if (return_status == FILE_IGNORE_ALL)
+            ctx->ignore_all = TRUE;
+        if (return_status != FILE_RETRY)
+            break;
+    }
+
+    return return_status;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Recursive removal of local directory like recursive_erase() does.
+ * Entries are accessed relative to the descriptor of their directory, so the full path
+ * is never resolved and is only built for messages.
+ *
+ * @param parent_fd descriptor of parent directory or AT_FDCWD
+ * @param name name of directory in parent directory
+ * @param path full path of directory, it is used as a buffer and restored on return
+ */
+
+static FileProgressStatus
+recursive_erase_at (file_op_context_t *ctx, int parent_fd, const char *name, GString *path)
+{
+    int fd;
+    DIR *reading;
+    struct dirent *next;
+    const size_t len = path->len;
+    FileProgressStatus return_status = FILE_CONT;
+
+    fd = openat (parent_fd, name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_NOCTTY);
+    if (fd == -1)
+        return FILE_RETRY;
+
+    reading = fdopendir (fd);
+    if (reading == NULL)
+    {
+        close (fd);
+        return FILE_RETRY;
+    }
+
+    fd = dirfd (reading);
+
+    while (return_status != FILE_ABORT && (next = readdir (reading)) != NULL)
+    {
+        struct stat buf;
+
+        if (DIR_IS_DOT (next->d_name) || DIR_IS_DOTDOT (next->d_name))
+            continue;
+
+        if (len == 0 || !IS_PATH_SEP (path->str[len - 1]))
+            g_string_append_c (path, PATH_SEP);
+        g_string_append (path, next->d_name);
+
+        if (fstatat (fd, next->d_name, &buf, AT_SYMLINK_NOFOLLOW) != 0)
+        {
+            closedir (reading);
+            g_string_truncate (path, len);
+            return FILE_RETRY;
+        }
+
+        if (S_ISDIR (buf.st_mode))
+            return_status = recursive_erase_at (ctx, fd, next->d_name, path);
+        else
+            return_status = erase_file_at (ctx, fd, next->d_name, path->str);
+
+        g_string_truncate (path, len);
+    }
+
+    closedir (reading);
+
+    if (return_status == FILE_ABORT)
+        return FILE_ABORT;
+
+    file_progress_show_deleting (ctx, path->str, NULL);
+    file_progress_show_count (ctx);
+    if (file_progress_check_buttons (ctx) == FILE_ABORT)
+        return FILE_ABORT;
+
+    mc_refresh ();
+
+    return try_erase_dir_at (ctx, parent_fd, name, path->str);
+}
+#endif
+
+/* --------------------------------------------------------------------------------------------- */
+
 /**
   Recursive removal of files
   abort -> cancel stack
@@ -1444,6 +1607,21 @@ recursive_erase (file_op_context_t *ctx, const vfs_path_t *vpath)
     DIR *reading;
     FileProgressStatus return_status = FILE_CONT;
 
+#ifdef ERASE_AT
+    if (vfs_file_is_local (vpath))
+    {
+        const char *path;
+        GString *buf;
+
+        path = vfs_path_get_last_path_str (vpath);
+        buf = g_string_new (path);
+        return_status = recursive_erase_at (ctx, AT_FDCWD, path, buf);
+        g_string_free (buf, TRUE);
+
+        return return_status;
+    }
+#endif
+
     reading = mc_opendir (vpath);
     if (reading == NULL)
         return FILE_RETRY;
@@ -1474,7 +1652,7 @@ recursive_erase (file_op_context_t *ctx, const vfs_path_t *vpath)
     if (return_status == FILE_ABORT)
         return FILE_ABORT;
 
-    file_progress_show_deleting (ctx, vpath, NULL);
+    file_progress_show_deleting (ctx, vfs_path_as_str (vpath), NULL);
     file_progress_show_count (ctx);
     if (file_progress_check_buttons (ctx) == FILE_ABORT)
         return FILE_ABORT;
@@ -1546,7 +1724,7 @@ erase_dir_iff_empty (file_op_context_t *ctx, const vfs_path_t *vpath)
 {
     FileProgressStatus error = FILE_CONT;
 
-    file_progress_show_deleting (ctx, vpath, NULL);
+    file_progress_show_deleting (ctx, vfs_path_as_str (vpath), NULL);
     file_progress_show_count (ctx);
     if (file_progress_check_buttons (ctx) == FILE_ABORT)
         return FILE_ABORT;
@@ -2128,6 +2306,94 @@ operate_single_file (const WPanel *panel, file_op_context_t *ctx, const char *sr
     return value;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Check whether file can be passed to the copy queue: the queue copies local files only and
+ * doesn't support appending, preallocation and ext2 attributes.
+ */
+
+static gboolean
+copy_queue_accepts (const file_op_context_t *ctx, const vfs_path_t *src_vpath,
+                    const vfs_path_t *dst_vpath)
+{
+    return (ctx->copy_queue != NULL && ctx->operation == OP_COPY && !ctx->do_append
+            && ctx->do_reget == 0 && !copymove_persistent_ext2_attr
+            && !mc_global.vfs.preallocate_space
+#ifdef HAVE_FILE_CLONING_BY_PATH
+            && !mc_global.vfs.file_cloning
+#endif
+            && vfs_file_is_local (src_vpath) && vfs_file_is_local (dst_vpath));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Process copies finished by the copy queue in the order they were queued: update progress
+ * and copy the files that the queue couldn't copy in the usual way, asking questions and
+ * showing errors. Panel entries of copied files are stored in ctx->copy_queue_done.
+ *
+ * @param ctx file operation context
+ * @param wait_all wait for all queued copies, otherwise process the finished ones only
+ *
+ * @return FILE_ABORT if operation was aborted, FILE_CONT otherwise
+ */
+
+static FileProgressStatus
+copy_queue_process (file_op_context_t *ctx, gboolean wait_all)
+{
+    file_copy_queue_t *q = ctx->copy_queue;
+    file_copy_job_t *job;
+    FileProgressStatus status = FILE_CONT;
+
+    while (status != FILE_ABORT
+           && (job = file_copy_queue_pop (q, wait_all || file_copy_queue_is_full (q))) != NULL)
+    {
+        if (job->result == FILE_COPY_JOB_OK)
+        {
+            progress_update_one (TRUE, ctx, job->size);
+            status = FILE_CONT;
+        }
+        else if (job->result == FILE_COPY_JOB_FALLBACK)
+        {
+            // don't queue the file again
+            ctx->copy_queue = NULL;
+            status = copy_file_file (ctx, job->src_path, job->dst_path);
+            ctx->copy_queue = q;
+        }
+        else
+            status = FILE_SKIP;
+
+        if (status == FILE_CONT && job->entry >= 0)
+            g_array_append_val (ctx->copy_queue_done, job->entry);
+
+        file_copy_job_free (job);
+
+        if (status != FILE_ABORT)
+            status = file_progress_check_buttons (ctx);
+    }
+
+    if (status != FILE_ABORT)
+        return FILE_CONT;
+
+    file_copy_queue_cancel (q);
+    return FILE_ABORT;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Unmark panel entries copied by the copy queue.
+ */
+
+static void
+copy_queue_unmark (WPanel *panel, file_op_context_t *ctx)
+{
+    guint i;
+
+    for (i = 0; i < ctx->copy_queue_done->len; i++)
+        do_file_mark (panel, g_array_index (ctx->copy_queue_done, int, i), 0);
+
+    g_array_set_size (ctx->copy_queue_done, 0);
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 static FileProgressStatus
@@ -2294,6 +2560,7 @@ copy_file_file (file_op_context_t *ctx, const char *src_path, const char *dst_pa
     int open_flags;
     vfs_path_t *src_vpath = NULL, *dst_vpath = NULL;
     char *buf = NULL;
+    file_readahead_t *ra = NULL;
 
     /* Keep the non-default value applied in chain of calls:
        move_file_file() -> file_progress_real_query_replace()
@@ -2317,6 +2584,16 @@ copy_file_file (file_op_context_t *ctx, const char *src_path, const char *dst_pa
 
     mc_refresh ();
 
+    if (copy_queue_accepts (ctx, src_vpath, dst_vpath))
+    {
+        file_copy_queue_push (ctx->copy_queue, src_path, src_vpath, dst_path, dst_vpath,
+                              ctx->copy_queue_entry);
+        // panel entry will be unmarked after the file is copied
+        ctx->copy_queue_entry = -1;
+        return_status = copy_queue_process (ctx, FALSE);
+        goto ret_fast;
+    }
+
     while (mc_stat (dst_vpath, &dst_stat) == 0)
     {
         if (S_ISDIR (dst_stat.st_mode))
@@ -2752,6 +3029,9 @@ open_dest:
         gint64 tv_last_update = ctx->transfer_start;
         gint64 tv_last_input = 0;
         gboolean is_first_time = TRUE;
+        // try to copy local files in kernel first
+        gboolean kernel_copy = (open_flags & O_APPEND) == 0;
+        gboolean readahead_checked = FALSE;
 
         const size_t bufsize = io_blksize (dst_stat);
         buf = g_malloc (bufsize);
@@ -2759,9 +3039,42 @@ open_dest:
         while (TRUE)
         {
             ssize_t n_read = -1;
+            char *t = buf;
+
+            if (kernel_copy)
+            {
+                n_read = vfs_copy_file_range (dest_desc, src_desc, FILEOP_KERNEL_COPY_CHUNK);
+                if (n_read <= 0)
+                {
+                    /* Not supported, error or EOF: continue with mc_read() and mc_write()
+                       that find out EOF and report errors */
+                    kernel_copy = FALSE;
+                    n_read = -1;
+                }
+            }
+
+            if (!kernel_copy && !readahead_checked)
+            {
+                // read the local source in a separate thread while the destination is being written
+                if (file_size - file_part - ctx->do_reget > (off_t) bufsize)
+                    ra = file_readahead_new (src_desc, bufsize);
+                readahead_checked = TRUE;
+            }
+
+            if (ra != NULL)
+            {
+                n_read = file_readahead_get (ra, &t);
+                if (n_read <= 0)
+                {
+                    // EOF or error: the reader has stopped, retry with mc_read() on error
+                    file_readahead_free (ra);
+                    ra = NULL;
+                    t = buf;
+                }
+            }
 
             // src_read
-            if (mc_ctl (src_desc, VFS_CTL_IS_NOTREADY, 0) == 0)
+            if (!kernel_copy && ra == NULL && mc_ctl (src_desc, VFS_CTL_IS_NOTREADY, 0) == 0)
                 while ((n_read = mc_read (src_desc, buf, bufsize)) < 0 && !ctx->ignore_all)
                 {
                     return_status =
@@ -2780,12 +3093,14 @@ open_dest:
 
             if (n_read > 0)
             {
-                ssize_t n_written;
-                char *t = buf;
-
                 file_part += n_read;
 
                 tv_last_input = tv_current;
+            }
+
+            if (n_read > 0 && !kernel_copy)
+            {
+                ssize_t n_written;
 
                 // dst_write
                 while ((n_written = mc_write (dest_desc, t, (size_t) n_read)) < n_read)
@@ -2822,6 +3137,9 @@ open_dest:
                     if (return_status != FILE_RETRY)
                         goto ret;
                 }
+
+                if (ra != NULL)
+                    file_readahead_release (ra);
             }
 
             ctx->progress_bytes = file_part + ctx->do_reget;
@@ -2895,6 +3213,7 @@ open_dest:
     }
 
 ret:
+    file_readahead_free (ra);
     g_free (buf);
 
     rotate_dash (FALSE);
@@ -3049,7 +3368,7 @@ copy_dir_dir (file_op_context_t *ctx, const char *s, const char *d, gboolean top
               gboolean move_over, gboolean do_delete, GSList *parent_dirs)
 {
     struct vfs_dirent *next;
-    struct stat dst_stat, src_stat;
+    struct stat dst_stat, src_stat, link_stat;
     unsigned long attrs = 0;
     gboolean attrs_ok = copymove_persistent_ext2_attr;
     DIR *reading;
@@ -3057,10 +3376,15 @@ copy_dir_dir (file_op_context_t *ctx, const char *s, const char *d, gboolean top
     link_t *lp;
     vfs_path_t *src_vpath, *dst_vpath;
     gboolean do_mkdir = TRUE;
+    int copy_queue_entry;
 
     src_vpath = vfs_path_from_str (s);
     dst_vpath = vfs_path_from_str (d);
 
+    // files of directory are not panel entries
+    copy_queue_entry = ctx->copy_queue_entry;
+    ctx->copy_queue_entry = -1;
+
     // First get the mode of the source dir
 
 retry_src_stat:
@@ -3260,10 +3584,11 @@ retry_dst_stat:
     if (reading == NULL)
         goto ret;
 
-    while ((next = mc_readdir (reading)) && return_status != FILE_ABORT)
+    while ((next = mc_readdir_plus (reading, &dst_stat, &link_stat)) != NULL
+           && return_status != FILE_ABORT)
     {
         char *path;
-        vfs_path_t *tmp_vpath;
+        vfs_path_t *tmp_vpath = NULL;
 
         /*
          * Now, we don't want '.' and '..' to be created / copied at any time
@@ -3273,9 +3598,16 @@ retry_dst_stat:
 
         // get the filename and add it to the src directory
         path = mc_build_filename (s, next->d_name, (char *) NULL);
-        tmp_vpath = vfs_path_from_str (path);
 
-        (*ctx->stat_func) (tmp_vpath, &dst_stat);
+        // use the status got together with the directory entry if any
+        if (ctx->stat_func != mc_lstat && S_ISLNK (dst_stat.st_mode))
+            dst_stat = link_stat;
+        if (dst_stat.st_mode == 0)
+        {
+            tmp_vpath = vfs_path_from_str (path);
+            (*ctx->stat_func) (tmp_vpath, &dst_stat);
+        }
+
         if (S_ISDIR (dst_stat.st_mode))
         {
             char *mdpath;
@@ -3299,6 +3631,9 @@ retry_dst_stat:
             g_free (dest_file);
         }
 
+        if (do_delete && return_status == FILE_CONT && tmp_vpath == NULL)
+            tmp_vpath = vfs_path_from_str (path);
+
         g_free (path);
 
         if (do_delete && return_status == FILE_CONT)
@@ -3323,6 +3658,15 @@ retry_dst_stat:
     }
     mc_closedir (reading);
 
+    // files must be created before the attributes of directory are set
+    if (ctx->copy_queue != NULL)
+    {
+        if (return_status == FILE_ABORT)
+            file_copy_queue_cancel (ctx->copy_queue);
+        else if (copy_queue_process (ctx, TRUE) == FILE_ABORT)
+            return_status = FILE_ABORT;
+    }
+
     if (ctx->preserve)
     {
         mc_timesbuf_t times;
@@ -3347,6 +3691,7 @@ ret:
     free_link (parent_dirs->data);
     g_slist_free_1 (parent_dirs);
 ret_fast:
+    ctx->copy_queue_entry = copy_queue_entry;
     vfs_path_free (src_vpath, TRUE);
     vfs_path_free (dst_vpath, TRUE);
     return return_status;
@@ -3373,7 +3718,7 @@ erase_dir (file_op_context_t *ctx, const vfs_path_t *vpath)
 {
     FileProgressStatus error = FILE_CONT;
 
-    file_progress_show_deleting (ctx, vpath, NULL);
+    file_progress_show_deleting (ctx, vfs_path_as_str (vpath), NULL);
     file_progress_show_count (ctx);
     if (file_progress_check_buttons (ctx) == FILE_ABORT)
         return FILE_ABORT;
@@ -3484,7 +3829,7 @@ dirsize_status_update_cb (status_msg_t *sm)
 void
 dirsize_status_deinit_cb (status_msg_t *sm)
 {
-    (void) sm;
+    dirsize_local_done ((dirsize_status_msg_t *) sm);
 
     // schedule to update passive panel
     if (get_other_type () == view_listing)
@@ -3629,6 +3974,14 @@ panel_operate (void *source_panel, FileOperation operation, gboolean force_singl
 
     // Now, let's do the job
 
+    // copy small files concurrently when many files are copied
+    if (operation == OP_COPY && dialog_type == FILEGUI_DIALOG_MULTI_ITEM)
+    {
+        ctx->copy_queue = file_copy_queue_new (ctx);
+        if (ctx->copy_queue != NULL)
+            ctx->copy_queue_done = g_array_new (FALSE, FALSE, sizeof (int));
+    }
+
     // This code is only called by the tree and panel code
     if (single_entry)
     {
@@ -3694,19 +4047,39 @@ panel_operate (void *source_panel, FileOperation operation, gboolean force_singl
                 source2 = panel->dir.list[i].fname->str;
                 src_stat = panel->dir.list[i].st;
 
+                ctx->copy_queue_entry = i;
                 value = operate_one_file (panel, ctx, source2, &src_stat, dest);
+                // queued file is not copied yet: it isn't the current entry anymore
+                if (value == FILE_CONT && ctx->copy_queue_entry == i)
+                    do_file_mark (panel, i, 0);
+                ctx->copy_queue_entry = -1;
+
+                if (ctx->copy_queue != NULL)
+                    copy_queue_unmark (panel, ctx);
+
                 if (value == FILE_ABORT)
                     break;
 
-                if (value == FILE_CONT)
-                    do_file_mark (panel, i, 0);
-
                 mc_refresh ();
             }  // Loop for every file
+
+        if (value != FILE_ABORT && ctx->copy_queue != NULL)
+        {
+            value = copy_queue_process (ctx, TRUE);
+            copy_queue_unmark (panel, ctx);
+        }
     }  // Many entries
 
 clean_up:
     // Clean up
+    file_copy_queue_free (ctx->copy_queue);
+    ctx->copy_queue = NULL;
+    if (ctx->copy_queue_done != NULL)
+    {
+        g_array_free (ctx->copy_queue_done, TRUE);
+        ctx->copy_queue_done = NULL;
+    }
+
     if (save_cwd != NULL)
     {
         mc_setctl (save_cwd, VFS_SETCTL_STALE_DATA, NULL);
@@ -33,6 +33,7 @@ struct dirsize_status_msg_t
     const vfs_path_t *dirname_vpath;
     size_t dir_count;
     uintmax_t total_size;
+    void *walk;  // threads scanning local directories, see dirsize.c
 };
 
 /*** global variables defined in .c file *********************************************************/
@@ -780,6 +780,7 @@ file_op_context_new (const FileOperation op)
     ctx->do_reget = -1;
     ctx->stat_func = mc_lstat;
     ctx->ask_overwrite = TRUE;
+    ctx->copy_queue_entry = -1;
 
     return ctx;
 }
@@ -1200,7 +1201,7 @@ file_progress_show_target (file_op_context_t *ctx, const vfs_path_t *vpath)
 /* --------------------------------------------------------------------------------------------- */
 
 gboolean
-file_progress_show_deleting (file_op_context_t *ctx, const vfs_path_t *vpath, size_t *count)
+file_progress_show_deleting (file_op_context_t *ctx, const char *path, size_t *count)
 {
     static gint64 timestamp = 0;
     const gint64 delay = G_USEC_PER_SEC / 25;  // update with 25 FPS rate
@@ -1213,15 +1214,13 @@ file_progress_show_deleting (file_op_context_t *ctx, const vfs_path_t *vpath, si
     if (ret)
     {
         file_progress_ui_t *ui;
-        const char *s;
 
         ui = ctx->ui;
 
         if (ui->src_file_label != NULL)
             label_set_text (ui->src_file_label, _ ("Deleting"));
 
-        s = vfs_path_as_str (vpath);
-        label_set_text (ui->src_file, truncFileStringSecure (ui->op_dlg, s));
+        label_set_text (ui->src_file, truncFileStringSecure (ui->op_dlg, path));
     }
 
     if (count != NULL)
@@ -63,6 +63,7 @@ enum OperationMode
 /*** structures declarations (and typedefs of structures)*****************************************/
 
 struct mc_search_struct;
+struct file_copy_queue_t;
 
 /* This structure describes a context for file operations.  It is used to update
  * the progress windows and pass around options.
@@ -116,6 +117,12 @@ typedef struct
     gboolean ask_overwrite;
     // Result from the recursive query
     FileCopyMode recursive_result;
+    // Queue to copy small files concurrently, NULL if files are copied one by one
+    struct file_copy_queue_t *copy_queue;
+    // Panel entry copied now, -1 if copied file is not a panel entry or it was queued
+    int copy_queue_entry;
+    // Panel entries copied by the queue (int)
+    GArray *copy_queue_done;
 
     // PID of the child for background operations
     pid_t pid;
@@ -179,8 +186,7 @@ void file_progress_show_total (file_op_context_t *ctx, uintmax_t copied_bytes, g
                                gboolean show_summary);
 void file_progress_show_source (file_op_context_t *ctx, const vfs_path_t *vpath);
 void file_progress_show_target (file_op_context_t *ctx, const vfs_path_t *vpath);
-gboolean file_progress_show_deleting (file_op_context_t *ctx, const vfs_path_t *vpath,
-                                      size_t *count);
+gboolean file_progress_show_deleting (file_op_context_t *ctx, const char *path, size_t *count);
 
 /* The following functions are implemented separately by each port */
 FileProgressStatus file_progress_real_query_replace (file_op_context_t *ctx,
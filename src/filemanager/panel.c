@@ -160,6 +160,9 @@ static const char *string_marked (const file_entry_t *fe, int len);
 static const char *string_space (const file_entry_t *fe, int len);
 static const char *string_dot (const file_entry_t *fe, int len);
 
+static gboolean panel_watch_apply (WPanel *panel);
+static void panel_watch_cwd (WPanel *panel);
+
 /*** file scope variables ************************************************************************/
 
 static panel_field_t panel_fields[] = {
@@ -1442,6 +1445,9 @@ panel_destroy (WPanel *p)
 
     panel_clean_dir (p);
 
+    dir_watch_free (p->watch);
+    p->watch = NULL;
+
     // clean history
     if (p->dir_history.list != NULL)
     {
@@ -3393,6 +3399,7 @@ panel_do_cd_int (WPanel *panel, const vfs_path_t *new_dir_vpath, enum cd_enum cd
 
     // Reload current panel
     panel_clean_dir (panel);
+    panel_watch_cwd (panel);
 
     if (!dir_list_load (&panel->dir, panel->cwd_vpath, panel->sort_field->sort_routine,
                         &panel->sort_info, &panel->filter))
@@ -3771,6 +3778,9 @@ panel_callback (Widget *w, Widget *sender, widget_msg_t msg, int parm, void *dat
         return MSG_HANDLED;
 
     case MSG_DRAW:
+        // changes could be queued while other dialog was shown
+        panel_watch_apply (panel);
+
         // Repaint everything, including frame and separator
         widget_erase (w);
         show_dir (panel);
@@ -4141,7 +4151,11 @@ reload_panelized (WPanel *panel)
 
         vpath = vfs_path_from_str (list->list[i].fname->str);
         if (mc_lstat (vpath, &list->list[i].st) != 0)
+        {
             g_string_free (list->list[i].fname, TRUE);
+            str_release_key (list->list[i].name_sort_key, list->keys_case_sensitive);
+            str_release_key (list->list[i].extension_sort_key, list->keys_case_sensitive);
+        }
         else
         {
             if (j != i)
@@ -4201,6 +4215,106 @@ update_one_panel_widget (WPanel *panel, panel_update_flags_t flags, const char *
         g_free (my_current_file);
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Apply changes of the current directory queued by watcher. Panel contents are not changed
+ * while other dialog is shown over file manager: file operations iterate panel entries.
+ *
+ * @return TRUE if panel is changed, FALSE otherwise
+ */
+
+static gboolean
+panel_watch_apply (WPanel *panel)
+{
+    GHashTable *names;
+    gboolean reload;
+
+    if (panel->watch == NULL || panel->is_panelized || top_dlg == NULL
+        || DIALOG (top_dlg->data) != filemanager)
+        return FALSE;
+
+    names = dir_watch_take_changes (panel->watch, &reload);
+    if (names == NULL && !reload)
+        return FALSE;
+
+    // names are relative to panel directory
+    (void) mc_chdir (panel->cwd_vpath);
+
+    if (!reload)
+    {
+        const file_entry_t *fe;
+        char *current_file = NULL;
+
+        fe = panel_current_entry (panel);
+        if (fe != NULL)
+            current_file = g_strndup (fe->fname->str, fe->fname->len);
+
+        reload = !dir_list_update (&panel->dir, names, panel->sort_field->sort_routine,
+                                   &panel->sort_info, &panel->filter);
+        if (!reload)
+        {
+            panel_set_current_by_name (panel, current_file);
+            recalculate_panel_summary (panel);
+        }
+
+        g_free (current_file);
+    }
+
+    // watcher can be freed here if directory is deleted
+    if (reload)
+        update_one_panel_widget (panel, UP_RELOAD, UP_KEEPSEL);
+
+    (void) mc_chdir (current_panel->cwd_vpath);
+
+    if (names != NULL)
+        g_hash_table_destroy (names);
+
+    panel->dirty = TRUE;
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+panel_watch_callback (void *data)
+{
+    WPanel *panel = PANEL (data);
+
+    if (panel_watch_apply (panel))
+    {
+        widget_draw (WIDGET (panel));
+
+        /* we are called from one of the tty_get_event channels, so the screen is not
+         * refreshed automatically: force a cursor update and a screen refresh */
+        widget_update_cursor (WIDGET (filemanager));
+        mc_refresh ();
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Watch the current directory of panel: start, stop or move the watcher as needed */
+
+static void
+panel_watch_cwd (WPanel *panel)
+{
+    if (!panels_options.watch_dirs)
+    {
+        dir_watch_free (panel->watch);
+        panel->watch = NULL;
+    }
+    else if (dir_watch_is_for (panel->watch, panel->cwd_vpath))
+    {
+        // directory is about to be read entirely
+        dir_watch_clear (panel->watch);
+    }
+    else
+    {
+        dir_watch_free (panel->watch);
+        panel->watch = dir_watch_new (panel->cwd_vpath, panel_watch_callback, panel);
+    }
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 static void
@@ -4601,6 +4715,8 @@ panel_sized_with_dir_new (const char *panel_name, const WRect *r, const vfs_path
         panel->cwd_vpath = vfs_path_clone (vfs_get_raw_current_dir ());
     }
 
+    panel_watch_cwd (panel);
+
     // Load the default format
     if (!dir_list_load (&panel->dir, panel->cwd_vpath, panel->sort_field->sort_routine,
                         &panel->sort_info, &panel->filter))
@@ -4646,12 +4762,14 @@ panel_reload (WPanel *panel)
         panel->cwd_vpath = vfs_path_from_str (PATH_SEP_STR);
         panel_clean_dir (panel);
         dir_list_init (&panel->dir);
+        panel_watch_cwd (panel);
         return;
     }
 
     panel->cwd_vpath = cwd_vpath;
     memset (&(panel->dir_stat), 0, sizeof (panel->dir_stat));
     show_dir (panel);
+    panel_watch_cwd (panel);
 
     if (!dir_list_reload (&panel->dir, panel->cwd_vpath, panel->sort_field->sort_routine,
                           &panel->sort_info, &panel->filter))
@@ -5301,8 +5419,8 @@ panel_panelize_restore (void)
         list->list[i].f.dir_size_computed = plist->list[i].f.dir_size_computed;
         list->list[i].f.marked = plist->list[i].f.marked;
         list->list[i].st = plist->list[i].st;
-        list->list[i].name_sort_key = plist->list[i].name_sort_key;
-        list->list[i].extension_sort_key = plist->list[i].extension_sort_key;
+        list->list[i].name_sort_key = NULL;
+        list->list[i].extension_sort_key = NULL;
     }
 
     panel->is_panelized = TRUE;
@@ -5401,8 +5519,8 @@ panel_panelize_save (WPanel *panel)
         plist->list[i].f.dir_size_computed = list->list[i].f.dir_size_computed;
         plist->list[i].f.marked = list->list[i].f.marked;
         plist->list[i].st = list->list[i].st;
-        plist->list[i].name_sort_key = list->list[i].name_sort_key;
-        plist->list[i].extension_sort_key = list->list[i].extension_sort_key;
+        plist->list[i].name_sort_key = NULL;
+        plist->list[i].extension_sort_key = NULL;
     }
 }
 
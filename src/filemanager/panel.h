@@ -15,7 +15,8 @@
 #include "lib/filehighlight.h"
 #include "lib/file-entry.h"
 
-#include "dir.h"  // dir_list
+#include "dir.h"       // dir_list
+#include "dirwatch.h"  // dir_watch_t
 
 /*** typedefs(not structures) and defined constants **********************************************/
 
@@ -94,6 +95,7 @@ typedef struct
 
     dir_list dir;          // Directory contents
     struct stat dir_stat;  // Stat of current dir: used by execute ()
+    dir_watch_t *watch;    // Watcher of changes in current dir
 
     vfs_path_t *cwd_vpath;  // Current Working Directory
     vfs_path_t *lwd_vpath;  // Last Working Directory
@@ -0,0 +1,243 @@
+/*
+   Read-ahead of local files in a separate thread.
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** \file readahead.c
+ *  \brief Source: read-ahead of local files in a separate thread
+ *
+ *  The reader thread fills a ring of buffers from the source file while the caller
+ *  writes already read buffers to the destination, so reading and writing overlap in time.
+ *
+ *  Only files of local VFS are read ahead: the reader thread calls read(2) directly and
+ *  never enters VFS, which is not thread-safe. The reader stops at the first error or EOF
+ *  and doesn't read past it, so after the error slot is got the file offset is right after
+ *  the last read data and the caller can retry reading with mc_read().
+ */
+
+#include <config.h>
+
+#include <errno.h>
+#include <unistd.h>
+
+#include "lib/global.h"
+#include "lib/vfs/vfs.h"
+
+#include "readahead.h"
+
+/*** global variables ****************************************************************************/
+
+/*** file scope macro definitions ****************************************************************/
+
+// number of buffers in the ring
+#define READAHEAD_BUFFERS 4
+
+/*** file scope type declarations ****************************************************************/
+
+struct file_readahead_t
+{
+    int fd;
+    size_t bufsize;
+    char *buf[READAHEAD_BUFFERS];
+    ssize_t len[READAHEAD_BUFFERS];
+    int err[READAHEAD_BUFFERS];
+
+    // number of filled buffers, changed by reader thread only
+    guint head;
+    // number of released buffers, changed by caller only
+    guint tail;
+    gboolean stop;
+
+    GMutex lock;
+    GCond cond;
+    GThread *thread;
+};
+
+/*** forward declarations (file scope functions) *************************************************/
+
+/*** file scope variables ************************************************************************/
+
+/* --------------------------------------------------------------------------------------------- */
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+static gpointer
+file_readahead_thread (gpointer data)
+{
+    file_readahead_t *ra = (file_readahead_t *) data;
+    ssize_t n;
+
+    g_mutex_lock (&ra->lock);
+
+    do
+    {
+        guint slot;
+        int err;
+
+        while (!ra->stop && ra->head - ra->tail == READAHEAD_BUFFERS)
+            g_cond_wait (&ra->cond, &ra->lock);
+
+        if (ra->stop)
+            break;
+
+        slot = ra->head % READAHEAD_BUFFERS;
+        g_mutex_unlock (&ra->lock);
+
+        while ((n = read (ra->fd, ra->buf[slot], ra->bufsize)) == -1
+               && (errno == EINTR || errno == EAGAIN))
+            ;
+        err = errno;
+
+        g_mutex_lock (&ra->lock);
+        ra->len[slot] = n;
+        ra->err[slot] = err;
+        ra->head++;
+        g_cond_broadcast (&ra->cond);
+    }
+    while (n > 0);
+
+    g_mutex_unlock (&ra->lock);
+
+    return NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Start read-ahead of file.
+ *
+ * @param vfs_fd file descriptor of VFS
+ * @param bufsize size of every read
+ *
+ * @return read-ahead object or NULL if file is not local or thread cannot be started.
+ *         In the latter case the file should be read with mc_read().
+ */
+
+file_readahead_t *
+file_readahead_new (int vfs_fd, size_t bufsize)
+{
+    void *fsinfo = NULL;
+    struct vfs_class *me;
+    file_readahead_t *ra;
+    int i;
+
+    me = vfs_class_find_by_handle (vfs_fd, &fsinfo);
+    if (me == NULL || (me->flags & VFSF_LOCAL) == 0 || fsinfo == NULL)
+        return NULL;
+
+    ra = g_new0 (file_readahead_t, 1);
+    ra->fd = *(int *) fsinfo;
+    ra->bufsize = bufsize;
+    for (i = 0; i < READAHEAD_BUFFERS; i++)
+        ra->buf[i] = g_malloc (bufsize);
+    g_mutex_init (&ra->lock);
+    g_cond_init (&ra->cond);
+
+    ra->thread = g_thread_try_new ("mc-readahead", file_readahead_thread, ra, NULL);
+    if (ra->thread == NULL)
+    {
+        file_readahead_free (ra);
+        ra = NULL;
+    }
+
+    return ra;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get the next buffer. Wait for the reader thread if the buffer is not filled yet.
+ * The buffer must be released with file_readahead_release() after use.
+ *
+ * @param ra read-ahead object
+ * @param data pointer to store buffer address
+ *
+ * @return number of bytes in the buffer, 0 at EOF or -1 on error (errno is set).
+ *         After EOF or error no more buffers are available.
+ */
+
+ssize_t
+file_readahead_get (file_readahead_t *ra, char **data)
+{
+    guint slot;
+    ssize_t n;
+    int err;
+
+    g_mutex_lock (&ra->lock);
+    while (ra->head == ra->tail)
+        g_cond_wait (&ra->cond, &ra->lock);
+    slot = ra->tail % READAHEAD_BUFFERS;
+    n = ra->len[slot];
+    err = ra->err[slot];
+    g_mutex_unlock (&ra->lock);
+
+    *data = ra->buf[slot];
+    if (n < 0)
+        errno = err;
+
+    return n;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Return the buffer got by file_readahead_get() to the reader thread.
+ */
+
+void
+file_readahead_release (file_readahead_t *ra)
+{
+    g_mutex_lock (&ra->lock);
+    ra->tail++;
+    g_cond_broadcast (&ra->cond);
+    g_mutex_unlock (&ra->lock);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Stop reader thread and free read-ahead object.
+ * The file offset is undefined after that unless EOF or error was got.
+ */
+
+void
+file_readahead_free (file_readahead_t *ra)
+{
+    int i;
+
+    if (ra == NULL)
+        return;
+
+    if (ra->thread != NULL)
+    {
+        g_mutex_lock (&ra->lock);
+        ra->stop = TRUE;
+        g_cond_broadcast (&ra->cond);
+        g_mutex_unlock (&ra->lock);
+
+        g_thread_join (ra->thread);
+    }
+
+    g_cond_clear (&ra->cond);
+    g_mutex_clear (&ra->lock);
+    for (i = 0; i < READAHEAD_BUFFERS; i++)
+        g_free (ra->buf[i]);
+    g_free (ra);
+}
+
+/* --------------------------------------------------------------------------------------------- */
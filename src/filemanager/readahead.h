@@ -0,0 +1,27 @@
+/** \file readahead.h
+ *  \brief Header: read-ahead of local files in a separate thread
+ */
+
+#ifndef MC__FILEMANAGER_READAHEAD_H
+#define MC__FILEMANAGER_READAHEAD_H
+
+/*** typedefs(not structures) and defined constants **********************************************/
+
+/*** enums ***************************************************************************************/
+
+/*** structures declarations (and typedefs of structures)*****************************************/
+
+typedef struct file_readahead_t file_readahead_t;
+
+/*** global variables defined in .c file *********************************************************/
+
+/*** declarations of public functions ************************************************************/
+
+file_readahead_t *file_readahead_new (int vfs_fd, size_t bufsize);
+ssize_t file_readahead_get (file_readahead_t *ra, char **data);
+void file_readahead_release (file_readahead_t *ra);
+void file_readahead_free (file_readahead_t *ra);
+
+/*** inline functions ****************************************************************************/
+
+#endif
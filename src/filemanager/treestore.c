@@ -163,6 +163,16 @@ pathcmp (const vfs_path_t *p1_vpath, const vfs_path_t *p2_vpath)
 
 /* --------------------------------------------------------------------------------------------- */
 
+static int
+tree_entry_cmp (gconstpointer a, gconstpointer b, gpointer user_data)
+{
+    (void) user_data;
+
+    return pathcmp (((const tree_entry *) a)->name, ((const tree_entry *) b)->name);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static char *
 decode (char *buffer)
 {
@@ -384,22 +394,32 @@ tree_store_save_to (char *name)
 static tree_entry *
 tree_store_add_entry (const vfs_path_t *name)
 {
-    int flag = -1;
+    tree_entry key;
+    GSequenceIter *place;
     tree_entry *current;
-    tree_entry *old = NULL;
+    tree_entry *old;
     tree_entry *new;
     int submask = 0;
 
     if (ts.tree_last != NULL && ts.tree_last->next != NULL)
         abort ();
 
-    // Search for the correct place
-    for (current = ts.tree_first; current != NULL && (flag = pathcmp (current->name, name)) < 0;
-         current = current->next)
-        old = current;
+    if (ts.index == NULL)
+        ts.index = g_sequence_new (NULL);
 
-    if (flag == 0)
-        return current;  // Already in the list
+    // Search for the correct place: the first entry after name
+    key.name = (vfs_path_t *) name;
+    place = g_sequence_search (ts.index, &key, tree_entry_cmp, NULL);
+
+    if (!g_sequence_iter_is_begin (place))
+    {
+        old = (tree_entry *) g_sequence_get (g_sequence_iter_prev (place));
+        if (pathcmp (old->name, name) == 0)
+            return old;  // Already in the list
+    }
+
+    current = g_sequence_iter_is_end (place) ? NULL : (tree_entry *) g_sequence_get (place);
+    old = current != NULL ? current->prev : ts.tree_last;
 
     // Not in the list -> add it
     new = g_new0 (tree_entry, 1);
@@ -442,6 +462,7 @@ tree_store_add_entry (const vfs_path_t *name)
 
     // Calculate attributes
     new->name = vfs_path_clone (name);
+    new->index = g_sequence_insert_before (place, new);
     new->sublevel = vfs_path_tokens_count (new->name);
 
     {
@@ -520,6 +541,8 @@ remove_entry (tree_entry *entry)
     else
         ts.tree_last = entry->prev;
 
+    g_sequence_remove (entry->index);
+
     // Free the memory used by the entry
     vfs_path_free (entry->name, TRUE);
     g_free (entry);
@@ -602,14 +625,16 @@ queue_vpath_free (gpointer data)
 tree_entry *
 tree_store_whereis (const vfs_path_t *name)
 {
-    tree_entry *current;
-    int flag = -1;
+    tree_entry key;
+    GSequenceIter *iter;
 
-    for (current = ts.tree_first; current != NULL && (flag = pathcmp (current->name, name)) < 0;
-         current = current->next)
-        ;
+    if (ts.index == NULL)
+        return NULL;
 
-    return flag == 0 ? current : NULL;
+    key.name = (vfs_path_t *) name;
+    iter = g_sequence_lookup (ts.index, &key, tree_entry_cmp, NULL);
+
+    return iter != NULL ? (tree_entry *) g_sequence_get (iter) : NULL;
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -666,6 +691,28 @@ tree_store_save (void)
     return retval;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * \fn void tree_store_done(void)
+ * \brief Frees all entries of the tree and the index of them
+ */
+
+void
+tree_store_done (void)
+{
+    while (ts.tree_first != NULL)
+        remove_entry (ts.tree_first);
+
+    if (ts.index != NULL)
+    {
+        g_sequence_free (ts.index);
+        ts.index = NULL;
+    }
+
+    ts.loaded = FALSE;
+    tree_store_dirty (FALSE);
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 void
@@ -737,7 +784,6 @@ tree_store_mark_checked (const char *subname)
 {
     vfs_path_t *name;
     tree_entry *current, *base;
-    int flag = 1;
     const char *cname;
 
     if (!ts.loaded)
@@ -757,11 +803,9 @@ tree_store_mark_checked (const char *subname)
         name = vfs_path_append_new (ts.check_name, subname, (char *) NULL);
 
     // Search for the subdirectory
-    for (current = ts.check_start; current != NULL && (flag = pathcmp (current->name, name)) < 0;
-         current = current->next)
-        ;
+    current = tree_store_whereis (name);
 
-    if (flag != 0)
+    if (current == NULL)
     {
         // Doesn't exist -> add it
         current = tree_store_add_entry (name);
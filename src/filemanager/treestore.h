@@ -29,12 +29,14 @@ typedef struct tree_entry
     gboolean scanned;         // Flag: childs scanned or not
     struct tree_entry *next;  // Next item in the list
     struct tree_entry *prev;  // Previous item in the list
+    GSequenceIter *index;     // Position in the ordered index
 } tree_entry;
 
 struct TreeStore
 {
     tree_entry *tree_first;   // First entry in the list
     tree_entry *tree_last;    // Last entry in the list
+    GSequence *index;         // Entries ordered by name for fast search
     tree_entry *check_start;  // Start of checked subdirectories
     vfs_path_t *check_name;
     GList *add_queue_vpath;  // List of vfs_path_t objects of added directories
@@ -49,6 +51,7 @@ struct TreeStore
 struct TreeStore *tree_store_get (void);
 int tree_store_load (void);
 int tree_store_save (void);
+void tree_store_done (void);
 void tree_store_remove_entry (const vfs_path_t *name_vpath);
 tree_entry *tree_store_start_check (const vfs_path_t *vpath);
 void tree_store_mark_checked (const char *subname);
@@ -55,7 +55,7 @@
 #include "lib/vfs/vfs.h"  // vfs_init(), vfs_shut()
 
 #include "filemanager/filemanager.h"
-#include "filemanager/treestore.h"  // tree_store_save
+#include "filemanager/treestore.h"  // tree_store_save(), tree_store_done()
 #include "filemanager/layout.h"
 #include "filemanager/ext.h"      // flush_extension_file()
 #include "filemanager/command.h"  // cmdline
@@ -436,6 +436,7 @@ main (int argc, char *argv[])
 
     // Save the tree store
     (void) tree_store_save ();
+    tree_store_done ();
 
     keymap_free ();
 
@@ -132,6 +132,7 @@ panels_options_t panels_options = {
     .show_dot_files = TRUE,
     .fast_reload = FALSE,
     .fast_reload_msg_shown = FALSE,
+    .watch_dirs = TRUE,
     .mark_moves_down = TRUE,
     .reverse_files_only = TRUE,
     .auto_save_setup = FALSE,
@@ -382,6 +383,7 @@ static const struct
     { "double_click_speed", &double_click_speed },
     { "old_esc_mode_timeout", &old_esc_mode_timeout },
     { "max_dirt_limit", &mcview_max_dirt_limit },
+    { "mcview_file_cache_size", &mcview_file_cache_size },
     { "num_history_items_recorded", &num_history_items_recorded },
 
 #ifdef ENABLE_VFS
@@ -434,6 +436,7 @@ static const struct
     { "show_dot_files", &panels_options.show_dot_files },
     { "fast_reload", &panels_options.fast_reload },
     { "fast_reload_msg_shown", &panels_options.fast_reload_msg_shown },
+    { "watch_dirs", &panels_options.watch_dirs },
     { "mark_moves_down", &panels_options.mark_moves_down },
     { "reverse_files_only", &panels_options.reverse_files_only },
     { "auto_save_setup_panels", &panels_options.auto_save_setup },
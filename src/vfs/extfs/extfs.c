@@ -41,8 +41,10 @@
 
 #include <stdio.h>
 #include <ctype.h>
+#include <inttypes.h>  // PRIuMAX
 #include <string.h>
 #include <stdlib.h>
+#include <time.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -80,6 +82,13 @@
 
 #define RECORDSIZE     512
 
+/* first line of cached listing, change it if format of cache is changed */
+#define EXTFS_CACHE_MAGIC "MC extfs listing 1"
+
+/* least recently used listings are removed from cache above these limits */
+#define EXTFS_CACHE_MAX_FILES 256
+#define EXTFS_CACHE_MAX_SIZE  (64 * 1024 * 1024)
+
 #define EXTFS_SUPER(a) ((struct extfs_super_t *) (a))
 
 /*** file scope type declarations ****************************************************************/
@@ -101,6 +110,14 @@ typedef struct
     gboolean need_archive;
 } extfs_plugin_info_t;
 
+/* file of cached listing */
+typedef struct
+{
+    char *path;
+    time_t mtime;  // time of the last use
+    off_t size;
+} extfs_cache_file_t;
+
 /*** forward declarations (file scope functions) *************************************************/
 
 static struct vfs_s_entry *extfs_resolve_symlinks_int (struct vfs_s_entry *entry, GSList *list);
@@ -262,8 +279,6 @@ extfs_find_entry_int (struct vfs_s_inode *dir, const char *name, GSList *list, i
             pent = pent->dir != NULL ? pent->dir->ent : NULL;
         else
         {
-            GList *pl;
-
             pent = extfs_resolve_symlinks_int (pent, list);
             if (pent == NULL)
             {
@@ -279,8 +294,7 @@ extfs_find_entry_int (struct vfs_s_inode *dir, const char *name, GSList *list, i
             }
 
             pdir = pent;
-            pl = g_queue_find_custom (pent->ino->subdir, p, vfs_s_entry_compare);
-            pent = pl != NULL ? VFS_ENTRY (pl->data) : NULL;
+            pent = vfs_s_find_child (pent->ino, p);
             if (pent != NULL && q + 1 > name_end)
             {
                 // Hack: I keep the original semanthic unless q+1 would break in the strchr
@@ -447,14 +461,12 @@ extfs_add_file (struct extfs_super_t *archive, const char *file_name)
             if (pent != NULL)
             {
                 entry = extfs_entry_new (super->me, p, pent->ino);
-                entry->dir = pent->ino;
-                g_queue_push_tail (pent->ino->subdir, entry);
+                vfs_s_add_entry (pent->ino, entry);
             }
             else
             {
                 entry = extfs_entry_new (super->me, p, super->root);
-                entry->dir = super->root;
-                g_queue_push_tail (super->root->subdir, entry);
+                vfs_s_add_entry (super->root, entry);
             }
 
             if (!S_ISLNK (hstat.st_mode) && (current_link_name != NULL))
@@ -511,19 +523,55 @@ extfs_add_file (struct extfs_super_t *archive, const char *file_name)
     return ret;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Create archive with the root directory only.
+ *
+ * @param st stat of archive file, root directory gets its owner and times
+ */
+
+static struct extfs_super_t *
+extfs_archive_new (int fstype, const char *name, const vfs_path_t *local_name_vpath,
+                   const struct stat *st)
+{
+    static dev_t archive_counter = 0;
+    struct extfs_super_t *current_archive;
+    struct vfs_s_entry *root_entry;
+    mode_t mode;
+
+    current_archive = extfs_super_new (vfs_extfs_ops, name, local_name_vpath, fstype);
+    current_archive->rdev = archive_counter++;
+
+    mode = st->st_mode & 07777;
+    if (mode & 0400)
+        mode |= 0100;
+    if (mode & 0040)
+        mode |= 0010;
+    if (mode & 0004)
+        mode |= 0001;
+    mode |= S_IFDIR;
+
+    root_entry = extfs_generate_entry (current_archive, PATH_SEP_STR, NULL, mode);
+    root_entry->ino->st.st_uid = st->st_uid;
+    root_entry->ino->st.st_gid = st->st_gid;
+    root_entry->ino->st.st_atime = st->st_atime;
+    root_entry->ino->st.st_ctime = st->st_ctime;
+    root_entry->ino->st.st_mtime = st->st_mtime;
+    root_entry->ino->ent = root_entry;
+    VFS_SUPER (current_archive)->root = root_entry->ino;
+
+    return current_archive;
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 static mc_pipe_t *
 extfs_open_archive (int fstype, const char *name, struct extfs_super_t **pparc, GError **error)
 {
     const extfs_plugin_info_t *info;
-    static dev_t archive_counter = 0;
     mc_pipe_t *result = NULL;
-    mode_t mode;
     GString *cmd;
     struct stat mystat;
-    struct extfs_super_t *current_archive;
-    struct vfs_s_entry *root_entry;
     GString *quoted_name = NULL;
     vfs_path_t *local_name_vpath = NULL;
     vfs_path_t *name_vpath;
@@ -578,30 +626,9 @@ extfs_open_archive (int fstype, const char *name, struct extfs_super_t **pparc,
         goto ret;
     }
 
-    current_archive = extfs_super_new (vfs_extfs_ops, name, local_name_vpath, fstype);
-    current_archive->rdev = archive_counter++;
+    *pparc = extfs_archive_new (fstype, name, local_name_vpath, &mystat);
     vfs_path_free (local_name_vpath, TRUE);
 
-    mode = mystat.st_mode & 07777;
-    if (mode & 0400)
-        mode |= 0100;
-    if (mode & 0040)
-        mode |= 0010;
-    if (mode & 0004)
-        mode |= 0001;
-    mode |= S_IFDIR;
-
-    root_entry = extfs_generate_entry (current_archive, PATH_SEP_STR, NULL, mode);
-    root_entry->ino->st.st_uid = mystat.st_uid;
-    root_entry->ino->st.st_gid = mystat.st_gid;
-    root_entry->ino->st.st_atime = mystat.st_atime;
-    root_entry->ino->st.st_ctime = mystat.st_ctime;
-    root_entry->ino->st.st_mtime = mystat.st_mtime;
-    root_entry->ino->ent = root_entry;
-    VFS_SUPER (current_archive)->root = root_entry->ino;
-
-    *pparc = current_archive;
-
 ret:
     vfs_path_free (name_vpath, TRUE);
     return result;
@@ -610,11 +637,13 @@ ret:
 /* --------------------------------------------------------------------------------------------- */
 /**
  * Main loop for reading an archive.
+ * If @listing is not NULL, lines of listing are appended to it.
  * Return 0 on success, -1 on error.
  */
 
 static int
-extfs_read_archive (mc_pipe_t *pip, struct extfs_super_t *archive, GError **error)
+extfs_read_archive (mc_pipe_t *pip, struct extfs_super_t *archive, GString *listing,
+                    GError **error)
 {
     int ret = 0;
     GString *buffer;
@@ -688,6 +717,12 @@ extfs_read_archive (mc_pipe_t *pip, struct extfs_super_t *archive, GError **erro
                 continue;
             }
 
+            if (listing != NULL)
+            {
+                g_string_append_len (listing, buffer->str, buffer->len);
+                g_string_append_c (listing, '\n');
+            }
+
             ret = extfs_add_file (archive, buffer->str);
 
             g_string_free (buffer, TRUE);
@@ -710,6 +745,222 @@ extfs_read_archive (mc_pipe_t *pip, struct extfs_super_t *archive, GError **erro
     return ret;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get key of the cached listing of archive.
+ *
+ * Key contains everything the listing depends on: name, size, modification time and i-node of
+ * archive, name, size and modification time of helper. Key is written at the start of cache file
+ * and compared with the current one when cache is read.
+ *
+ * @param info helper
+ * @param name archive name
+ * @param st buffer to store stat of archive
+ *
+ * @return newly allocated key or NULL if listing of archive should not be cached
+ */
+
+static char *
+extfs_cache_get_key (const extfs_plugin_info_t *info, const char *name, struct stat *st)
+{
+    vfs_path_t *name_vpath;
+    gboolean ok;
+    char *helper;
+    struct stat hst;
+    long nsec;
+    char *key = NULL;
+
+    if (!info->need_archive)
+        return NULL;
+
+    name_vpath = vfs_path_from_str (name);
+    ok = vfs_file_is_local (name_vpath) && mc_stat (name_vpath, st) == 0 && S_ISREG (st->st_mode);
+    vfs_path_free (name_vpath, TRUE);
+
+    /* Archive changed just now could be changed again after reading without change of size and
+       time */
+    if (!ok || st->st_mtime >= time (NULL) - 1)
+        return NULL;
+
+#ifdef HAVE_STRUCT_STAT_ST_MTIM
+    nsec = st->st_mtim.tv_nsec;
+#else
+    nsec = 0;
+#endif
+
+    helper = g_strconcat (info->path, info->prefix, (char *) NULL);
+
+    if (stat (helper, &hst) == 0)
+        key = g_strdup_printf (EXTFS_CACHE_MAGIC "\n%s %" PRIuMAX " %" PRIdMAX "\n%s %" PRIuMAX
+                                                 " %" PRIdMAX ".%09ld %" PRIuMAX "\n",
+                               helper, (uintmax_t) hst.st_size, (intmax_t) hst.st_mtime, name,
+                               (uintmax_t) st->st_size, (intmax_t) st->st_mtime, nsec,
+                               (uintmax_t) st->st_ino);
+
+    g_free (helper);
+
+    return key;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get name of cache file. There is one file per archive and helper, listing of changed archive
+ * replaces the old one.
+ */
+
+static char *
+extfs_cache_get_path (const extfs_plugin_info_t *info, const char *name)
+{
+    char *checksum, *file_name, *path;
+
+    checksum = g_compute_checksum_for_string (G_CHECKSUM_SHA1, name, -1);
+    file_name = g_strconcat (info->prefix, "-", checksum, (char *) NULL);
+    path = mc_build_filename (mc_config_get_cache_path (), MC_EXTFS_DIR, file_name, (char *) NULL);
+    g_free (file_name);
+    g_free (checksum);
+
+    return path;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Create archive from cached listing.
+ *
+ * @return new archive or NULL if there is no valid cache
+ */
+
+static struct extfs_super_t *
+extfs_cache_load (int fstype, const char *name, const char *path, const char *key,
+                  const struct stat *st)
+{
+    char *contents;
+    struct extfs_super_t *archive;
+    char *line, *next;
+    int ret = 0;
+
+    if (!g_file_get_contents (path, &contents, NULL, NULL))
+        return NULL;
+
+    if (!g_str_has_prefix (contents, key))
+    {
+        g_free (contents);
+        return NULL;
+    }
+
+    archive = extfs_archive_new (fstype, name, NULL, st);
+
+    for (line = contents + strlen (key); ret != -1 && *line != '\0'; line = next)
+    {
+        next = strchr (line, '\n');
+        if (next == NULL)
+            ret = -1;  // truncated file
+        else
+        {
+            *next++ = '\0';
+            ret = extfs_add_file (archive, line);
+        }
+    }
+
+    g_free (contents);
+
+    if (ret == -1)
+    {
+        VFS_SUPER (archive)->me->free (VFS_SUPER (archive));
+        archive = NULL;
+    }
+    else
+    {
+        // cache is used: keep it longer than others
+        (void) utime (path, NULL);
+    }
+
+    return archive;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static int
+extfs_cache_file_cmp (gconstpointer a, gconstpointer b)
+{
+    const extfs_cache_file_t *fa = (const extfs_cache_file_t *) a;
+    const extfs_cache_file_t *fb = (const extfs_cache_file_t *) b;
+
+    // recently used first
+    return _GL_CMP (fb->mtime, fa->mtime);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Remove least recently used listings if there are too many of them or they are too big.
+ *
+ * @param dir cache directory
+ */
+
+static void
+extfs_cache_trim (const char *dir)
+{
+    GDir *d;
+    const char *name;
+    GArray *files;
+    off_t size = 0;
+    guint i;
+
+    d = g_dir_open (dir, 0, NULL);
+    if (d == NULL)
+        return;
+
+    files = g_array_new (FALSE, FALSE, sizeof (extfs_cache_file_t));
+
+    while ((name = g_dir_read_name (d)) != NULL)
+    {
+        extfs_cache_file_t f;
+        struct stat st;
+
+        f.path = g_build_filename (dir, name, (char *) NULL);
+        if (lstat (f.path, &st) != 0 || !S_ISREG (st.st_mode))
+            g_free (f.path);
+        else
+        {
+            f.mtime = st.st_mtime;
+            f.size = st.st_size;
+            g_array_append_val (files, f);
+        }
+    }
+
+    g_dir_close (d);
+
+    g_array_sort (files, extfs_cache_file_cmp);
+
+    for (i = 0; i < files->len; i++)
+    {
+        extfs_cache_file_t *f = &g_array_index (files, extfs_cache_file_t, i);
+
+        size += f->size;
+        if (i >= EXTFS_CACHE_MAX_FILES || size > EXTFS_CACHE_MAX_SIZE)
+            (void) unlink (f->path);
+        g_free (f->path);
+    }
+
+    g_array_free (files, TRUE);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+extfs_cache_save (const char *path, const GString *listing)
+{
+    char *dir;
+
+    dir = g_path_get_dirname (path);
+
+    // cache is optional: ignore errors
+    if (g_mkdir_with_parents (dir, 0700) == 0
+        && g_file_set_contents (path, listing->str, (gssize) listing->len, NULL))
+        extfs_cache_trim (dir);
+
+    g_free (dir);
+}
+
 /* --------------------------------------------------------------------------------------------- */
 
 static int
@@ -741,9 +992,35 @@ static int
 extfs_open_and_read_archive (int fstype, const char *name, struct extfs_super_t **archive)
 {
     int result = -1;
+    const extfs_plugin_info_t *info;
     struct extfs_super_t *a;
     mc_pipe_t *pip;
     GError *error = NULL;
+    struct stat st;
+    char *cache_key;
+    char *cache_path = NULL;
+    GString *listing = NULL;
+    gsize key_len = 0;
+
+    info = &g_array_index (extfs_plugins, extfs_plugin_info_t, fstype);
+
+    // listing of unchanged archive is taken from cache without running of helper
+    cache_key = extfs_cache_get_key (info, name, &st);
+    if (cache_key != NULL)
+    {
+        cache_path = extfs_cache_get_path (info, name);
+        *archive = extfs_cache_load (fstype, name, cache_path, cache_key, &st);
+        if (*archive != NULL)
+        {
+            g_free (cache_path);
+            g_free (cache_key);
+            return 0;
+        }
+
+        listing = g_string_new (cache_key);
+        key_len = listing->len;
+        g_free (cache_key);
+    }
 
     pip = extfs_open_archive (fstype, name, archive, &error);
 
@@ -751,9 +1028,6 @@ extfs_open_and_read_archive (int fstype, const char *name, struct extfs_super_t
 
     if (pip == NULL)
     {
-        const extfs_plugin_info_t *info;
-
-        info = &g_array_index (extfs_plugins, extfs_plugin_info_t, fstype);
         if (error == NULL)
             message (D_ERROR, MSG_ERROR, _ ("Cannot open %s archive\n%s"), info->prefix, name);
         else
@@ -765,20 +1039,33 @@ extfs_open_and_read_archive (int fstype, const char *name, struct extfs_super_t
     }
     else
     {
-        result = extfs_read_archive (pip, a, &error);
+        gboolean cache;
+        int status;
+
+        result = extfs_read_archive (pip, a, listing, &error);
 
         if (result != 0)
             VFS_SUPER (a)->me->free (VFS_SUPER (a));
 
+        // don't keep listing of helper which failed or found nothing: it can be temporary
+        cache = result == 0 && error == NULL && listing != NULL && listing->len > key_len;
+
         if (error != NULL)
         {
             message (D_ERROR, MSG_ERROR, _ ("EXTFS virtual file system:\n%s"), error->message);
             g_error_free (error);
         }
 
-        mc_pclose (pip, NULL);
+        status = mc_pclose (pip, NULL);
+
+        if (cache && status != -1 && WIFEXITED (status) && WEXITSTATUS (status) == 0)
+            extfs_cache_save (cache_path, listing);
     }
 
+    if (listing != NULL)
+        g_string_free (listing, TRUE);
+    g_free (cache_path);
+
     return result;
 }
 
@@ -1273,6 +1560,23 @@ extfs_stat_move (struct stat *buf, const struct vfs_s_inode *inode)
 
 /* --------------------------------------------------------------------------------------------- */
 
+static struct vfs_dirent *
+extfs_readdir_plus (void *data, struct stat *buf, struct stat *link_buf)
+{
+    GList **info = (GList **) data;
+
+    (void) link_buf;
+
+    if (*info == NULL)
+        return NULL;
+
+    extfs_stat_move (buf, VFS_ENTRY ((*info)->data)->ino);
+
+    return extfs_readdir (data);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static int
 extfs_internal_stat (const vfs_path_t *vpath, struct stat *buf, gboolean resolve)
 {
@@ -1742,6 +2046,7 @@ vfs_init_extfs (void)
     vfs_extfs_ops->write = extfs_write;
     vfs_extfs_ops->opendir = extfs_opendir;
     vfs_extfs_ops->readdir = extfs_readdir;
+    vfs_extfs_ops->readdir_plus = extfs_readdir_plus;
     vfs_extfs_ops->closedir = extfs_closedir;
     vfs_extfs_ops->stat = extfs_stat;
     vfs_extfs_ops->lstat = extfs_lstat;
@@ -28,7 +28,9 @@
 #include <config.h>
 
 #include <errno.h>
+#include <fcntl.h>  // AT_SYMLINK_NOFOLLOW
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <unistd.h>
 #include <stdio.h>
 #include <string.h>
@@ -47,8 +49,49 @@
 
 /*** file scope macro definitions ****************************************************************/
 
+/* dirfd() is a macro on some systems */
+#if defined(HAVE_FSTATAT) && (defined(HAVE_DIRFD) || defined(dirfd)) && !defined(HAVE_STATLSTAT)
+#define LOCAL_READDIR_PLUS 1
+#endif
+
+/* Number of entries read ahead and stat'ed at once by readdir_plus */
+#define LOCAL_STAT_BATCH   512
+/* Number of entries stat'ed by one worker at once */
+#define LOCAL_STAT_CHUNK   32
+/* Maximum number of worker threads */
+#define LOCAL_STAT_THREADS 8
+
 /*** file scope type declarations ****************************************************************/
 
+typedef struct
+{
+    struct vfs_dirent *dirent;
+    struct stat st;       // lstat() of entry, st_mode is 0 on error
+    struct stat link_st;  // stat() of symlink target, st_mode is 0 if unknown
+} local_dirent_plus_t;
+
+/* Entries read ahead by readdir_plus. Shared with worker threads */
+typedef struct
+{
+    gint ref_count;
+    int dir_fd;
+    local_dirent_plus_t *entries;
+    guint len;
+    guint pos;  // next entry to be returned
+
+    gint next_chunk;  // next chunk to be claimed by worker
+    guint chunks;
+    guint chunks_done;
+    GMutex lock;
+    GCond cond;  // signaled when all chunks are done
+} local_stat_batch_t;
+
+typedef struct
+{
+    DIR *dir;
+    local_stat_batch_t *batch;
+} local_dir_t;
+
 /*** forward declarations (file scope functions) *************************************************/
 
 /*** file scope variables ************************************************************************/
@@ -56,6 +99,10 @@
 static struct vfs_s_subclass local_subclass;
 static struct vfs_class *vfs_local_ops = VFS_CLASS (&local_subclass);
 
+#ifdef LOCAL_READDIR_PLUS
+static GThreadPool *local_stat_pool = NULL;
+#endif
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
@@ -84,6 +131,7 @@ static void *
 local_opendir (const vfs_path_t *vpath)
 {
     DIR *dir = NULL;
+    local_dir_t *local_info;
 
     const char *path = vfs_path_get_last_path_str (vpath);
 
@@ -115,8 +163,8 @@ local_opendir (const vfs_path_t *vpath)
             rewinddir (dir);
     }
 
-    DIR **local_info = (DIR **) g_new (DIR *, 1);
-    *local_info = dir;
+    local_info = g_new0 (local_dir_t, 1);
+    local_info->dir = dir;
 
     return local_info;
 }
@@ -124,12 +172,12 @@ local_opendir (const vfs_path_t *vpath)
 /* --------------------------------------------------------------------------------------------- */
 
 static struct vfs_dirent *
-local_readdir (void *data)
+local_readdir_raw (DIR *dir)
 {
     struct dirent *d;
     unsigned char type;
 
-    d = readdir (*(DIR **) data);
+    d = readdir (dir);
 
     if (d == NULL)
         return NULL;
@@ -145,18 +193,280 @@ local_readdir (void *data)
 
 /* --------------------------------------------------------------------------------------------- */
 
+static struct vfs_dirent *
+local_readdir (void *data)
+{
+    local_dir_t *local_info = (local_dir_t *) data;
+
+#ifdef LOCAL_READDIR_PLUS
+    // entries already read ahead by local_readdir_plus()
+    if (local_info->batch != NULL && local_info->batch->pos < local_info->batch->len)
+        return local_info->batch->entries[local_info->batch->pos++].dirent;
+#endif
+
+    return local_readdir_raw (local_info->dir);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+#ifdef LOCAL_READDIR_PLUS
+/**
+ * stat() or lstat() of directory entry relative to the directory: avoid lookup of full path.
+ */
+
+static int
+local_stat_at (int dir_fd, const char *name, struct stat *buf, gboolean follow)
+{
+#if defined(HAVE_STATX) && defined(AT_STATX_DONT_SYNC)
+    struct statx stx;
+
+    // don't force attribute synchronization with server on network file systems
+    if (statx (dir_fd, name, (follow ? 0 : AT_SYMLINK_NOFOLLOW) | AT_STATX_DONT_SYNC,
+               STATX_BASIC_STATS, &stx)
+            == 0
+        && (stx.stx_mask & STATX_BASIC_STATS) == STATX_BASIC_STATS)
+    {
+        memset (buf, 0, sizeof (*buf));
+        buf->st_dev = makedev (stx.stx_dev_major, stx.stx_dev_minor);
+        buf->st_ino = stx.stx_ino;
+        buf->st_mode = stx.stx_mode;
+        buf->st_nlink = stx.stx_nlink;
+        buf->st_uid = stx.stx_uid;
+        buf->st_gid = stx.stx_gid;
+#ifdef HAVE_STRUCT_STAT_ST_RDEV
+        buf->st_rdev = makedev (stx.stx_rdev_major, stx.stx_rdev_minor);
+#endif
+        buf->st_size = stx.stx_size;
+#ifdef HAVE_STRUCT_STAT_ST_BLKSIZE
+        buf->st_blksize = stx.stx_blksize;
+#endif
+#ifdef HAVE_STRUCT_STAT_ST_BLOCKS
+        buf->st_blocks = stx.stx_blocks;
+#endif
+#ifdef HAVE_STRUCT_STAT_ST_MTIM
+        buf->st_atim.tv_sec = stx.stx_atime.tv_sec;
+        buf->st_atim.tv_nsec = stx.stx_atime.tv_nsec;
+        buf->st_mtim.tv_sec = stx.stx_mtime.tv_sec;
+        buf->st_mtim.tv_nsec = stx.stx_mtime.tv_nsec;
+        buf->st_ctim.tv_sec = stx.stx_ctime.tv_sec;
+        buf->st_ctim.tv_nsec = stx.stx_ctime.tv_nsec;
+#else
+        buf->st_atime = stx.stx_atime.tv_sec;
+        buf->st_mtime = stx.stx_mtime.tv_sec;
+        buf->st_ctime = stx.stx_ctime.tv_sec;
+#endif
+        return 0;
+    }
+#endif
+
+    return fstatat (dir_fd, name, buf, follow ? 0 : AT_SYMLINK_NOFOLLOW);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+local_stat_batch_unref (local_stat_batch_t *batch)
+{
+    if (g_atomic_int_dec_and_test (&batch->ref_count))
+    {
+        guint i;
+
+        // entries that were not returned to the caller
+        for (i = batch->pos; i < batch->len; i++)
+            vfs_dirent_free (batch->entries[i].dirent);
+
+        g_free (batch->entries);
+        g_mutex_clear (&batch->lock);
+        g_cond_clear (&batch->cond);
+        g_free (batch);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Stat chunks of the batch until there are no more unclaimed ones.
+ * Called both by worker threads and by the main thread.
+ */
+
+static void
+local_stat_batch_run (local_stat_batch_t *batch)
+{
+    gint chunk;
+
+    while ((chunk = g_atomic_int_add (&batch->next_chunk, 1)) < (gint) batch->chunks)
+    {
+        guint i, last;
+
+        i = (guint) chunk * LOCAL_STAT_CHUNK;
+        last = MIN (i + LOCAL_STAT_CHUNK, batch->len);
+
+        for (; i < last; i++)
+        {
+            local_dirent_plus_t *e = &batch->entries[i];
+
+            if (local_stat_at (batch->dir_fd, e->dirent->d_name, &e->st, FALSE) != 0)
+                memset (&e->st, 0, sizeof (e->st));
+
+            // follow-up stat for symlinks to find out whether they point to directories
+            if (!S_ISLNK (e->st.st_mode)
+                || local_stat_at (batch->dir_fd, e->dirent->d_name, &e->link_st, TRUE) != 0)
+                memset (&e->link_st, 0, sizeof (e->link_st));
+        }
+
+        g_mutex_lock (&batch->lock);
+        batch->chunks_done++;
+        if (batch->chunks_done == batch->chunks)
+            g_cond_signal (&batch->cond);
+        g_mutex_unlock (&batch->lock);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+local_stat_worker (gpointer data, gpointer user_data)
+{
+    local_stat_batch_t *batch = (local_stat_batch_t *) data;
+
+    (void) user_data;
+
+    local_stat_batch_run (batch);
+    local_stat_batch_unref (batch);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Read next entries of directory and stat them in parallel.
+ *
+ * @return new batch of entries
+ */
+
+static local_stat_batch_t *
+local_stat_batch_new (DIR *dir)
+{
+    local_stat_batch_t *batch;
+    struct vfs_dirent *d;
+    guint tasks = 0;
+
+    batch = g_new0 (local_stat_batch_t, 1);
+    batch->ref_count = 1;
+    batch->dir_fd = dirfd (dir);
+    batch->entries = g_new (local_dirent_plus_t, LOCAL_STAT_BATCH);
+    g_mutex_init (&batch->lock);
+    g_cond_init (&batch->cond);
+
+    while (batch->len < LOCAL_STAT_BATCH && (d = local_readdir_raw (dir)) != NULL)
+        batch->entries[batch->len++].dirent = d;
+
+    batch->chunks = (batch->len + LOCAL_STAT_CHUNK - 1) / LOCAL_STAT_CHUNK;
+
+    // small directories are not worth to be stat'ed in parallel
+    if (batch->chunks > 1)
+    {
+        if (local_stat_pool == NULL)
+            local_stat_pool =
+                g_thread_pool_new (local_stat_worker, NULL, LOCAL_STAT_THREADS, FALSE, NULL);
+
+        if (local_stat_pool != NULL)
+        {
+            guint i;
+
+            tasks = MIN (batch->chunks - 1, LOCAL_STAT_THREADS);
+            g_atomic_int_add (&batch->ref_count, (gint) tasks);
+
+            for (i = 0; i < tasks; i++)
+                g_thread_pool_push (local_stat_pool, batch, NULL);
+        }
+    }
+
+    /* The main thread takes part too: listing completes even if the pool cannot start
+       any thread. Workers that start late find no work and just drop their reference. */
+    local_stat_batch_run (batch);
+
+    if (tasks != 0)
+    {
+        g_mutex_lock (&batch->lock);
+        while (batch->chunks_done < batch->chunks)
+            g_cond_wait (&batch->cond, &batch->lock);
+        g_mutex_unlock (&batch->lock);
+    }
+
+    return batch;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static struct vfs_dirent *
+local_readdir_plus (void *data, struct stat *buf, struct stat *link_buf)
+{
+    local_dir_t *local_info = (local_dir_t *) data;
+    local_dirent_plus_t *e;
+
+    if (local_info->batch != NULL && local_info->batch->pos >= local_info->batch->len)
+    {
+        gboolean eof;
+
+        eof = local_info->batch->len < LOCAL_STAT_BATCH;
+        local_stat_batch_unref (local_info->batch);
+        local_info->batch = NULL;
+        if (eof)
+            return NULL;
+    }
+
+    if (local_info->batch == NULL)
+    {
+        local_info->batch = local_stat_batch_new (local_info->dir);
+        if (local_info->batch->len == 0)
+            return NULL;
+    }
+
+    e = &local_info->batch->entries[local_info->batch->pos++];
+
+    // on error let the caller use lstat() and handle the error by itself
+    *buf = e->st;
+    if (link_buf != NULL)
+        *link_buf = e->link_st;
+
+    return e->dirent;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+#endif
+
 static int
 local_closedir (void *data)
 {
+    local_dir_t *local_info = (local_dir_t *) data;
     int i;
 
-    i = closedir (*(DIR **) data);
-    g_free (data);
+#ifdef LOCAL_READDIR_PLUS
+    if (local_info->batch != NULL)
+        local_stat_batch_unref (local_info->batch);
+#endif
+
+    i = closedir (local_info->dir);
+    g_free (local_info);
     return i;
 }
 
 /* --------------------------------------------------------------------------------------------- */
 
+#ifdef LOCAL_READDIR_PLUS
+static void
+local_done (struct vfs_class *me)
+{
+    (void) me;
+
+    if (local_stat_pool != NULL)
+    {
+        g_thread_pool_free (local_stat_pool, FALSE, TRUE);
+        local_stat_pool = NULL;
+    }
+}
+#endif
+
+/* --------------------------------------------------------------------------------------------- */
+
 static int
 local_stat (const vfs_path_t *vpath, struct stat *buf)
 {
@@ -493,6 +803,9 @@ vfs_init_localfs (void)
     memset (&local_subclass, 0, sizeof (local_subclass));
 
     vfs_init_class (vfs_local_ops, "localfs", VFSF_LOCAL, NULL);
+#ifdef LOCAL_READDIR_PLUS
+    vfs_local_ops->done = local_done;
+#endif
     vfs_local_ops->which = local_which;
     vfs_local_ops->open = local_open;
     vfs_local_ops->close = local_close;
@@ -500,6 +813,9 @@ vfs_init_localfs (void)
     vfs_local_ops->write = local_write;
     vfs_local_ops->opendir = local_opendir;
     vfs_local_ops->readdir = local_readdir;
+#ifdef LOCAL_READDIR_PLUS
+    vfs_local_ops->readdir_plus = local_readdir_plus;
+#endif
     vfs_local_ops->closedir = local_closedir;
     vfs_local_ops->stat = local_stat;
     vfs_local_ops->lstat = local_lstat;
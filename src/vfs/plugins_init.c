@@ -66,6 +66,10 @@
 #include "tar/tar.h"
 #endif
 
+#ifdef ENABLE_VFS_ZIP
+#include "zip/zip.h"
+#endif
+
 #include "plugins_init.h"
 
 /*** global variables ****************************************************************************/
@@ -95,6 +99,9 @@ vfs_plugins_init (void)
 #ifdef ENABLE_VFS_TAR
     vfs_init_tarfs ();
 #endif
+#ifdef ENABLE_VFS_ZIP
+    vfs_init_zipfs ();
+#endif
 #ifdef ENABLE_VFS_SFS
     vfs_init_sfs ();
 #endif
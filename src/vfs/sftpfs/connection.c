@@ -1002,6 +1002,8 @@ sftpfs_close_connection (struct vfs_s_super *super, const char *shutdown_message
 
     MC_PTR_FREE (sftpfs_super->known_hosts_file);
 
+    sftpfs_attr_cache_free (sftpfs_super);
+
     if (sftpfs_super->session != NULL)
     {
         libssh2_session_disconnect (sftpfs_super->session, shutdown_message);
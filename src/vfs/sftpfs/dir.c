@@ -44,6 +44,9 @@ typedef struct
 {
     LIBSSH2_SFTP_HANDLE *handle;
     sftpfs_super_t *super;
+    char *path;         // directory path as sent to server
+    GHashTable *attrs;  // attributes of entries to be put to the cache of connection
+    gint64 timestamp;   // when the directory was opened
 } sftpfs_dir_data_t;
 
 /*** file scope variables ************************************************************************/
@@ -70,11 +73,13 @@ sftpfs_opendir (const vfs_path_t *vpath, GError **mcerror)
     const vfs_path_element_t *path_element;
     LIBSSH2_SFTP_HANDLE *handle = NULL;
     const GString *fixfname;
+    gint64 timestamp;
 
     if (!sftpfs_op_init (&sftpfs_super, &path_element, vpath, mcerror))
         return NULL;
 
     fixfname = sftpfs_fix_filename (path_element->path);
+    timestamp = g_get_monotonic_time ();
 
     while (TRUE)
     {
@@ -93,6 +98,9 @@ sftpfs_opendir (const vfs_path_t *vpath, GError **mcerror)
     sftpfs_dir = g_new0 (sftpfs_dir_data_t, 1);
     sftpfs_dir->handle = handle;
     sftpfs_dir->super = sftpfs_super;
+    sftpfs_dir->path = g_strndup (fixfname->str, fixfname->len);
+    sftpfs_dir->attrs = sftpfs_attr_cache_new_dir ();
+    sftpfs_dir->timestamp = timestamp;
 
     return (void *) sftpfs_dir;
 }
@@ -102,12 +110,13 @@ sftpfs_opendir (const vfs_path_t *vpath, GError **mcerror)
  * Get a pointer to a structure representing the next directory entry.
  *
  * @param data    directory data handler
+ * @param buf     buffer for store stat-info of direntry (may be NULL)
  * @param mcerror pointer to the error handler
  * @return information about direntry if success, NULL otherwise
  */
 
 struct vfs_dirent *
-sftpfs_readdir (void *data, GError **mcerror)
+sftpfs_readdir (void *data, struct stat *buf, GError **mcerror)
 {
     char mem[BUF_MEDIUM];
     LIBSSH2_SFTP_ATTRIBUTES attrs;
@@ -127,7 +136,23 @@ sftpfs_readdir (void *data, GError **mcerror)
     }
     while (rc == LIBSSH2_ERROR_EAGAIN);
 
-    return (rc != 0 ? vfs_dirent_init (NULL, mem, 0, DT_UNKNOWN) : NULL);  // FIXME: inode
+    if (rc == 0)
+        return NULL;
+
+    // keep attributes to avoid stat round trip for each entry
+    sftpfs_attr_cache_add (sftpfs_dir->attrs, mem, &attrs);
+
+    if (buf != NULL)
+    {
+        memset (buf, 0, sizeof (*buf));
+        if ((attrs.flags & LIBSSH2_SFTP_ATTR_PERMISSIONS) != 0)
+        {
+            buf->st_nlink = 1;
+            sftpfs_attr_to_stat (&attrs, buf);
+        }
+    }
+
+    return vfs_dirent_init (NULL, mem, 0, DT_UNKNOWN);  // FIXME: inode
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -148,6 +173,9 @@ sftpfs_closedir (void *data, GError **mcerror)
     mc_return_val_if_error (mcerror, -1);
 
     rc = libssh2_sftp_closedir (sftpfs_dir->handle);
+    sftpfs_attr_cache_store (sftpfs_dir->super, sftpfs_dir->path, sftpfs_dir->attrs,
+                             sftpfs_dir->timestamp);
+    g_free (sftpfs_dir->path);
     g_free (sftpfs_dir);
     return rc;
 }
@@ -174,6 +202,7 @@ sftpfs_mkdir (const vfs_path_t *vpath, mode_t mode, GError **mcerror)
         return -1;
 
     fixfname = sftpfs_fix_filename (path_element->path);
+    sftpfs_attr_cache_invalidate (sftpfs_super, fixfname->str);
 
     do
     {
@@ -211,6 +240,7 @@ sftpfs_rmdir (const vfs_path_t *vpath, GError **mcerror)
         return -1;
 
     fixfname = sftpfs_fix_filename (path_element->path);
+    sftpfs_attr_cache_invalidate_tree (sftpfs_super, fixfname->str);
 
     do
     {
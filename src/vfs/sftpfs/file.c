@@ -162,6 +162,9 @@ sftpfs_open_file (vfs_file_handler_t *fh, int flags, mode_t mode, GError **mcerr
 
     fixfname = sftpfs_fix_filename (name);
 
+    if (sftp_open_flags != LIBSSH2_FXF_READ)
+        sftpfs_attr_cache_invalidate (super, fixfname->str);
+
     while (TRUE)
     {
         int libssh_errno;
@@ -364,6 +367,20 @@ sftpfs_close_file (vfs_file_handler_t *fh, GError **mcerror)
 
     ret = libssh2_sftp_close (SFTP_FILE_HANDLER (fh)->handle);
 
+    // size and times of written file are changed
+    if ((SFTP_FILE_HANDLER (fh)->flags & (O_WRONLY | O_RDWR | O_CREAT)) != 0)
+    {
+        char *name;
+
+        name = vfs_s_fullpath (vfs_sftpfs_ops, fh->ino);
+        if (name != NULL)
+        {
+            sftpfs_attr_cache_invalidate (SFTP_SUPER (fh->ino->super),
+                                          sftpfs_fix_filename (name)->str);
+            g_free (name);
+        }
+    }
+
     return ret == 0 ? 0 : -1;
 }
 
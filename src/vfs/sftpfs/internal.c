@@ -47,8 +47,17 @@ GString *sftpfs_filename_buffer = NULL;
 
 /*** file scope macro definitions ****************************************************************/
 
+/* How long attributes got by readdir are used instead of stat requests, in microseconds */
+#define SFTPFS_ATTR_CACHE_TTL (5 * G_USEC_PER_SEC)
+
 /*** file scope type declarations ****************************************************************/
 
+typedef struct
+{
+    gint64 timestamp;     // when the directory was opened
+    GHashTable *entries;  // entry name -> LIBSSH2_SFTP_ATTRIBUTES
+} sftpfs_attr_cache_dir_t;
+
 /*** forward declarations (file scope functions) *************************************************/
 
 /*** file scope variables ************************************************************************/
@@ -114,6 +123,105 @@ sftpfs_internal_waitsocket (sftpfs_super_t *super, GError **mcerror)
 
 /* --------------------------------------------------------------------------------------------- */
 
+static void
+sftpfs_attr_cache_dir_free (gpointer data)
+{
+    sftpfs_attr_cache_dir_t *dir = (sftpfs_attr_cache_dir_t *) data;
+
+    g_hash_table_destroy (dir->entries);
+    g_free (dir);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+sftpfs_attr_cache_dir_is_expired (gpointer key, gpointer value, gpointer user_data)
+{
+    const sftpfs_attr_cache_dir_t *dir = (const sftpfs_attr_cache_dir_t *) value;
+    const gint64 *now = (const gint64 *) user_data;
+
+    (void) key;
+
+    return (*now - dir->timestamp > SFTPFS_ATTR_CACHE_TTL);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Make the key of directory: strip trailing path separators.
+ *
+ * @param path path to directory
+ * @param len  length of path
+ * @return newly allocated string
+ */
+
+static char *
+sftpfs_attr_cache_dir_key (const char *path, size_t len)
+{
+    while (len != 0 && IS_PATH_SEP (path[len - 1]))
+        len--;
+
+    return (len == 0 ? g_strdup (PATH_SEP_STR) : g_strndup (path, len));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Split path to the key of parent directory and the entry name.
+ *
+ * @param path path to file or directory
+ * @param name where to store the newly allocated name of entry
+ * @return newly allocated key of parent directory
+ */
+
+static char *
+sftpfs_attr_cache_split (const char *path, char **name)
+{
+    size_t len;
+    const char *sep;
+
+    len = strlen (path);
+    while (len > 1 && IS_PATH_SEP (path[len - 1]))
+        len--;
+
+    sep = g_strrstr_len (path, (gssize) len, PATH_SEP_STR);
+    if (sep == NULL)
+    {
+        *name = g_strndup (path, len);
+        return g_strdup (PATH_SEP_STR);
+    }
+
+    *name = g_strndup (sep + 1, len - (size_t) (sep + 1 - path));
+    return sftpfs_attr_cache_dir_key (path, (size_t) (sep - path));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Check whether the cached directory lies below the given one.
+ *
+ * @param key       key of cached directory
+ * @param value     unused
+ * @param user_data key of parent directory
+ * @return TRUE if @key is a subdirectory of @user_data, FALSE otherwise
+ */
+
+static gboolean
+sftpfs_attr_cache_is_below (gpointer key, gpointer value, gpointer user_data)
+{
+    const char *dir_key = (const char *) key;
+    const char *prefix = (const char *) user_data;
+    size_t len;
+
+    (void) value;
+
+    // everything is below the root
+    if (IS_PATH_SEP (prefix[0]) && prefix[1] == '\0')
+        return TRUE;
+
+    len = strlen (prefix);
+    return (strncmp (dir_key, prefix, len) == 0 && IS_PATH_SEP (dir_key[len]));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static int
 sftpfs_stat_init (sftpfs_super_t **super, const vfs_path_element_t **path_element,
                   const vfs_path_t *vpath, GError **mcerror, int stat_type,
@@ -127,6 +235,11 @@ sftpfs_stat_init (sftpfs_super_t **super, const vfs_path_element_t **path_elemen
 
     fixfname = sftpfs_fix_filename ((*path_element)->path);
 
+    // readdir returns attributes of symlinks themselves
+    if (sftpfs_attr_cache_lookup (*super, fixfname->str, attrs)
+        && (stat_type == LIBSSH2_SFTP_LSTAT || !S_ISLNK (attrs->permissions)))
+        return 0;
+
     do
     {
         res = libssh2_sftp_stat_ex ((*super)->sftp_session, fixfname->str, fixfname->len, stat_type,
@@ -272,6 +385,183 @@ sftpfs_attr_to_stat (const LIBSSH2_SFTP_ATTRIBUTES *attrs, struct stat *s)
         s->st_mode = attrs->permissions;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Create the table to collect attributes of directory entries got by readdir.
+ *
+ * @return new hash table
+ */
+
+GHashTable *
+sftpfs_attr_cache_new_dir (void)
+{
+    return g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Remember attributes of directory entry.
+ *
+ * @param dir   table created by sftpfs_attr_cache_new_dir()
+ * @param name  name of entry
+ * @param attrs attributes of entry got by readdir
+ */
+
+void
+sftpfs_attr_cache_add (GHashTable *dir, const char *name, const LIBSSH2_SFTP_ATTRIBUTES *attrs)
+{
+    LIBSSH2_SFTP_ATTRIBUTES *cached;
+
+    // without permissions we cannot tell the file type
+    if ((attrs->flags & LIBSSH2_SFTP_ATTR_PERMISSIONS) == 0 || DIR_IS_DOT (name)
+        || DIR_IS_DOTDOT (name))
+        return;
+
+    cached = g_new (LIBSSH2_SFTP_ATTRIBUTES, 1);
+    *cached = *attrs;
+    g_hash_table_replace (dir, g_strdup (name), cached);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Put attributes of directory entries to the cache of connection.
+ *
+ * @param super     connection data
+ * @param path      path to directory (as sent to server)
+ * @param dir       table created by sftpfs_attr_cache_new_dir(). Ownership is transferred
+ * @param timestamp monotonic time when the directory was opened
+ */
+
+void
+sftpfs_attr_cache_store (sftpfs_super_t *super, const char *path, GHashTable *dir,
+                         gint64 timestamp)
+{
+    sftpfs_attr_cache_dir_t *cdir;
+    gint64 now;
+
+    if (super->attr_cache == NULL)
+        super->attr_cache =
+            g_hash_table_new_full (g_str_hash, g_str_equal, g_free, sftpfs_attr_cache_dir_free);
+    else
+    {
+        now = g_get_monotonic_time ();
+        g_hash_table_foreach_remove (super->attr_cache, sftpfs_attr_cache_dir_is_expired, &now);
+    }
+
+    cdir = g_new (sftpfs_attr_cache_dir_t, 1);
+    cdir->timestamp = timestamp;
+    cdir->entries = dir;
+
+    g_hash_table_replace (super->attr_cache, sftpfs_attr_cache_dir_key (path, strlen (path)),
+                          cdir);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Get attributes of file from the cache of connection.
+ *
+ * @param super connection data
+ * @param path  path to file (as sent to server)
+ * @param attrs where to store attributes
+ * @return TRUE if attributes were found and are not expired, FALSE otherwise
+ */
+
+gboolean
+sftpfs_attr_cache_lookup (sftpfs_super_t *super, const char *path,
+                          LIBSSH2_SFTP_ATTRIBUTES *attrs)
+{
+    char *dir_key, *name;
+    sftpfs_attr_cache_dir_t *cdir;
+    const LIBSSH2_SFTP_ATTRIBUTES *cached = NULL;
+
+    if (super->attr_cache == NULL)
+        return FALSE;
+
+    dir_key = sftpfs_attr_cache_split (path, &name);
+    cdir = (sftpfs_attr_cache_dir_t *) g_hash_table_lookup (super->attr_cache, dir_key);
+
+    if (cdir != NULL)
+    {
+        if (g_get_monotonic_time () - cdir->timestamp > SFTPFS_ATTR_CACHE_TTL)
+            g_hash_table_remove (super->attr_cache, dir_key);
+        else
+            cached = (const LIBSSH2_SFTP_ATTRIBUTES *) g_hash_table_lookup (cdir->entries, name);
+    }
+
+    g_free (dir_key);
+    g_free (name);
+
+    if (cached == NULL)
+        return FALSE;
+
+    *attrs = *cached;
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Forget cached attributes of file or directory after it was changed.
+ *
+ * @param super connection data
+ * @param path  path to file or directory (as sent to server)
+ */
+
+void
+sftpfs_attr_cache_invalidate (sftpfs_super_t *super, const char *path)
+{
+    char *dir_key, *name;
+
+    if (super->attr_cache == NULL)
+        return;
+
+    dir_key = sftpfs_attr_cache_split (path, &name);
+    g_hash_table_remove (super->attr_cache, dir_key);
+    g_free (dir_key);
+    g_free (name);
+
+    // path can be a directory itself
+    dir_key = sftpfs_attr_cache_dir_key (path, strlen (path));
+    g_hash_table_remove (super->attr_cache, dir_key);
+    g_free (dir_key);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Forget cached attributes of file or directory and of everything below it.
+ * Used when an entry is renamed or removed: cached listings of its subdirectories
+ * would stay valid under the old path otherwise.
+ *
+ * @param super connection data
+ * @param path  path to file or directory (as sent to server)
+ */
+
+void
+sftpfs_attr_cache_invalidate_tree (sftpfs_super_t *super, const char *path)
+{
+    char *prefix;
+
+    if (super->attr_cache == NULL)
+        return;
+
+    sftpfs_attr_cache_invalidate (super, path);
+
+    prefix = sftpfs_attr_cache_dir_key (path, strlen (path));
+    g_hash_table_foreach_remove (super->attr_cache, sftpfs_attr_cache_is_below, prefix);
+    g_free (prefix);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+void
+sftpfs_attr_cache_free (sftpfs_super_t *super)
+{
+    if (super->attr_cache != NULL)
+    {
+        g_hash_table_destroy (super->attr_cache);
+        super->attr_cache = NULL;
+    }
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /**
  * Getting information about a symbolic link.
@@ -400,6 +690,8 @@ sftpfs_symlink (const vfs_path_t *vpath1, const vfs_path_t *vpath2, GError **mce
     path1 = vfs_path_get_last_path_str (vpath1);
     path1_len = strlen (path1);
 
+    sftpfs_attr_cache_invalidate (super, tmp_path);
+
     do
     {
         res = libssh2_sftp_symlink_ex (super->sftp_session, path1, path1_len, tmp_path,
@@ -448,6 +740,7 @@ sftpfs_utime (const vfs_path_t *vpath, time_t atime, time_t mtime, GError **mcer
     attrs.mtime = mtime;
 
     fixfname = sftpfs_fix_filename (path_element->path);
+    sftpfs_attr_cache_invalidate (super, fixfname->str);
 
     do
     {
@@ -500,6 +793,7 @@ sftpfs_chmod (const vfs_path_t *vpath, mode_t mode, GError **mcerror)
     attrs.permissions = mode;
 
     fixfname = sftpfs_fix_filename (path_element->path);
+    sftpfs_attr_cache_invalidate (super, fixfname->str);
 
     do
     {
@@ -546,6 +840,7 @@ sftpfs_unlink (const vfs_path_t *vpath, GError **mcerror)
         return -1;
 
     fixfname = sftpfs_fix_filename (path_element->path);
+    sftpfs_attr_cache_invalidate_tree (super, fixfname->str);
 
     do
     {
@@ -593,6 +888,9 @@ sftpfs_rename (const vfs_path_t *vpath1, const vfs_path_t *vpath2, GError **mcer
     path1 = vfs_path_get_last_path_str (vpath1);
     fixfname = sftpfs_fix_filename (path1);
 
+    sftpfs_attr_cache_invalidate_tree (super, fixfname->str);
+    sftpfs_attr_cache_invalidate_tree (super, tmp_path);
+
     do
     {
         res = libssh2_sftp_rename_ex (super->sftp_session, fixfname->str, fixfname->len, tmp_path,
@@ -56,6 +56,8 @@ typedef struct
     int socket_handle;
     const char *ip_address;
     vfs_path_element_t *original_connection_info;
+
+    GHashTable *attr_cache;  // directory path -> attributes of entries got by readdir
 } sftpfs_super_t;
 
 /*** global variables defined in .c file *********************************************************/
@@ -79,6 +81,17 @@ gboolean sftpfs_op_init (sftpfs_super_t **super, const vfs_path_element_t **path
                          const vfs_path_t *vpath, GError **mcerror);
 
 void sftpfs_attr_to_stat (const LIBSSH2_SFTP_ATTRIBUTES *attrs, struct stat *s);
+GHashTable *sftpfs_attr_cache_new_dir (void);
+void sftpfs_attr_cache_add (GHashTable *dir, const char *name,
+                            const LIBSSH2_SFTP_ATTRIBUTES *attrs);
+void sftpfs_attr_cache_store (sftpfs_super_t *super, const char *path, GHashTable *dir,
+                              gint64 timestamp);
+gboolean sftpfs_attr_cache_lookup (sftpfs_super_t *super, const char *path,
+                                   LIBSSH2_SFTP_ATTRIBUTES *attrs);
+void sftpfs_attr_cache_invalidate (sftpfs_super_t *super, const char *path);
+void sftpfs_attr_cache_invalidate_tree (sftpfs_super_t *super, const char *path);
+void sftpfs_attr_cache_free (sftpfs_super_t *super);
+
 int sftpfs_lstat (const vfs_path_t *vpath, struct stat *buf, GError **mcerror);
 int sftpfs_stat (const vfs_path_t *vpath, struct stat *buf, GError **mcerror);
 int sftpfs_readlink (const vfs_path_t *vpath, char *buf, size_t size, GError **mcerror);
@@ -96,7 +109,7 @@ void sftpfs_close_connection (struct vfs_s_super *super, const char *shutdown_me
 vfs_file_handler_t *sftpfs_fh_new (struct vfs_s_inode *ino, gboolean changed);
 
 void *sftpfs_opendir (const vfs_path_t *vpath, GError **mcerror);
-struct vfs_dirent *sftpfs_readdir (void *data, GError **mcerror);
+struct vfs_dirent *sftpfs_readdir (void *data, struct stat *buf, GError **mcerror);
 int sftpfs_closedir (void *data, GError **mcerror);
 int sftpfs_mkdir (const vfs_path_t *vpath, mode_t mode, GError **mcerror);
 int sftpfs_rmdir (const vfs_path_t *vpath, GError **mcerror);
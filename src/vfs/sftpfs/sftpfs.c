@@ -192,14 +192,15 @@ sftpfs_cb_opendir (const vfs_path_t *vpath)
 
 /* --------------------------------------------------------------------------------------------- */
 /**
- * Callback for reading directory entry.
+ * Read directory entry and print progress message.
  *
  * @param data directory data handler
+ * @param buf  buffer for store stat-info of direntry (may be NULL)
  * @return information about direntry if success, NULL otherwise
  */
 
 static struct vfs_dirent *
-sftpfs_cb_readdir (void *data)
+sftpfs_do_readdir (void *data, struct stat *buf)
 {
     GError *mcerror = NULL;
     struct vfs_dirent *sftpfs_dirent;
@@ -210,7 +211,7 @@ sftpfs_cb_readdir (void *data)
         return NULL;
     }
 
-    sftpfs_dirent = sftpfs_readdir (data, &mcerror);
+    sftpfs_dirent = sftpfs_readdir (data, buf, &mcerror);
     if (!mc_error_message (&mcerror, NULL))
     {
         if (sftpfs_dirent != NULL)
@@ -222,6 +223,38 @@ sftpfs_cb_readdir (void *data)
     return sftpfs_dirent;
 }
 
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Callback for reading directory entry.
+ *
+ * @param data directory data handler
+ * @return information about direntry if success, NULL otherwise
+ */
+
+static struct vfs_dirent *
+sftpfs_cb_readdir (void *data)
+{
+    return sftpfs_do_readdir (data, NULL);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Callback for reading directory entry together with its attributes.
+ *
+ * @param data     directory data handler
+ * @param buf      buffer for store stat-info of direntry
+ * @param link_buf unused
+ * @return information about direntry if success, NULL otherwise
+ */
+
+static struct vfs_dirent *
+sftpfs_cb_readdir_plus (void *data, struct stat *buf, struct stat *link_buf)
+{
+    (void) link_buf;
+
+    return sftpfs_do_readdir (data, buf);
+}
+
 /* --------------------------------------------------------------------------------------------- */
 /**
  * Callback for closing directory.
@@ -823,6 +856,7 @@ vfs_init_sftpfs (void)
 
     vfs_sftpfs_ops->opendir = sftpfs_cb_opendir;
     vfs_sftpfs_ops->readdir = sftpfs_cb_readdir;
+    vfs_sftpfs_ops->readdir_plus = sftpfs_cb_readdir_plus;
     vfs_sftpfs_ops->closedir = sftpfs_cb_closedir;
     vfs_sftpfs_ops->mkdir = sftpfs_cb_mkdir;
     vfs_sftpfs_ops->rmdir = sftpfs_cb_rmdir;
@@ -0,0 +1,1166 @@
+/*
+   Virtual File System: ZIP file system.
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/** \file
+ *  \brief Source: Virtual File System: ZIP file system.
+ *
+ *  Read-only access to ZIP archives (and JAR, APK, etc) without external programs.
+ *
+ *  The directory tree is built from the central directory at the end of archive, members
+ *  themselves are not read when archive is opened. ZIP64 archives and archives with data
+ *  prepended (self-extracting ones) are supported.
+ *
+ *  Stored and deflated members are read directly from the archive. To seek in deflated member
+ *  without inflating it from the start every time, state of inflater (position and 32K window)
+ *  is saved at block boundaries every ZIP_SPAN_MIN bytes or more. Seek starts inflating from
+ *  the nearest saved state before the requested position.
+ *
+ *  Encrypted members and other compression methods are not supported, use the extfs uzip helper
+ *  for them.
+ */
+
+#include <config.h>
+
+#include <errno.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#include <zlib.h>
+
+#include "lib/global.h"
+#include "lib/widget.h"  // message()
+
+#include "lib/vfs/vfs.h"
+#include "lib/vfs/utilvfs.h"
+#include "lib/vfs/xdirentry.h"
+#include "lib/vfs/gc.h"  // vfs_rmstamp
+
+#include "zip.h"
+
+/*** global variables ****************************************************************************/
+
+/*** file scope macro definitions ****************************************************************/
+
+#define ZIP_SUPER(super)           ((zip_super_t *) (super))
+#define ZIP_FH(fh)                 ((zip_fh_t *) (fh))
+#define ZIP_MEMBER(ino)            ((zip_member_t *) (ino)->user_data)
+
+#define ZIP_EOCD_SIG               0x06054b50
+#define ZIP_EOCD_SIZE              22
+#define ZIP_COMMENT_MAX            65535
+#define ZIP64_LOCATOR_SIG          0x07064b50
+#define ZIP64_LOCATOR_SIZE         20
+#define ZIP64_EOCD_SIG             0x06064b50
+#define ZIP64_EOCD_SIZE            56
+#define ZIP_CENTRAL_SIG            0x02014b50
+#define ZIP_CENTRAL_SIZE           46
+#define ZIP_LOCAL_SIG              0x04034b50
+#define ZIP_LOCAL_SIZE             30
+
+#define ZIP_EXTRA_ZIP64            0x0001
+#define ZIP_EXTRA_TIMESTAMP        0x5455
+#define ZIP_EXTRA_UNIX             0x7875
+
+#define ZIP_FLAG_ENCRYPTED         0x0001
+#define ZIP_FLAG_STRONG_ENCRYPTION 0x0040
+
+#define ZIP_METHOD_STORED          0
+#define ZIP_METHOD_DEFLATED        8
+
+#define ZIP_HOST_UNIX              3
+#define ZIP_HOST_DARWIN            19
+
+#define ZIP_ATTR_READONLY          0x01
+#define ZIP_ATTR_DIRECTORY         0x10
+
+// sizes and offsets in ZIP64 extra field if they are 0xffffffff in header
+#define ZIP64_MARK                 0xffffffff
+
+#define ZIP_WINDOW_SIZE            32768
+#define ZIP_BUFSIZE                16384
+// minimal distance between saved states of inflater
+#define ZIP_SPAN_MIN               (1024 * 1024)
+// maximal number of saved states per member
+#define ZIP_POINTS_MAX             128
+
+/*** file scope type declarations ****************************************************************/
+
+typedef struct
+{
+    struct vfs_s_super base;  // base class
+
+    int fd;
+    struct stat st;
+} zip_super_t;
+
+/* state of inflater saved at block boundary */
+typedef struct
+{
+    off_t out;               // offset in uncompressed data
+    off_t in;                // offset in compressed data
+    int bits;                // number of bits of byte before @in not consumed yet
+    unsigned char *window;   // uncompressed data before @out
+    unsigned int window_len;
+} zip_point_t;
+
+/* data of file member, stored in inode */
+typedef struct
+{
+    off_t header_offset;  // offset of local header
+    off_t data_offset;    // offset of data or -1 if local header is not read yet
+    off_t csize;          // compressed size
+    guint16 method;
+    gboolean encrypted;
+    off_t span;     // minimal distance between saved states of inflater
+    GArray *points;  // saved states of inflater ordered by offset, zip_point_t
+} zip_member_t;
+
+typedef struct
+{
+    vfs_file_handler_t base;  // base class
+
+    z_stream zs;
+    gboolean inflating;  // zs is initialized
+    off_t out;           // offset of the next uncompressed byte
+    off_t in;            // offset of the next compressed byte to read from archive
+    unsigned char buf[ZIP_BUFSIZE];
+} zip_fh_t;
+
+/* entry of central directory */
+typedef struct
+{
+    guint8 host;
+    guint16 flags;
+    guint16 method;
+    guint16 dos_time;
+    guint16 dos_date;
+    guint64 csize;
+    guint64 usize;
+    guint32 attr;
+    guint64 header_offset;
+    const unsigned char *name;
+    guint16 name_len;
+    const unsigned char *extra;
+    guint16 extra_len;
+    gboolean have_mtime;
+    time_t mtime;
+    gboolean have_owner;
+    uid_t uid;
+    gid_t gid;
+} zip_central_t;
+
+/*** forward declarations (file scope functions) *************************************************/
+
+/*** file scope variables ************************************************************************/
+
+static struct vfs_s_subclass zip_subclass;
+static struct vfs_class *vfs_zipfs_ops = VFS_CLASS (&zip_subclass);
+
+/* --------------------------------------------------------------------------------------------- */
+/*** file scope functions ************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+static inline guint16
+zip_get16 (const unsigned char *p)
+{
+    return (guint16) (p[0] | (p[1] << 8));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static inline guint32
+zip_get32 (const unsigned char *p)
+{
+    return (guint32) zip_get16 (p) | ((guint32) zip_get16 (p + 2) << 16);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static inline guint64
+zip_get64 (const unsigned char *p)
+{
+    return (guint64) zip_get32 (p) | ((guint64) zip_get32 (p + 4) << 32);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Read exactly @len bytes at @offset of archive */
+
+static gboolean
+zip_read_at (int fd, off_t offset, void *buf, size_t len)
+{
+    char *p = (char *) buf;
+
+    if (mc_lseek (fd, offset, SEEK_SET) != offset)
+        return FALSE;
+
+    while (len != 0)
+    {
+        ssize_t n;
+
+        n = mc_read (fd, p, len);
+        if (n <= 0)
+            return FALSE;
+
+        p += n;
+        len -= (size_t) n;
+    }
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static time_t
+zip_dos_time (guint16 dos_date, guint16 dos_time)
+{
+    struct tm tm;
+
+    memset (&tm, 0, sizeof (tm));
+    tm.tm_year = ((dos_date >> 9) & 0x7f) + 80;
+    tm.tm_mon = ((dos_date >> 5) & 0x0f) - 1;
+    tm.tm_mday = dos_date & 0x1f;
+    tm.tm_hour = (dos_time >> 11) & 0x1f;
+    tm.tm_min = (dos_time >> 5) & 0x3f;
+    tm.tm_sec = (dos_time & 0x1f) * 2;
+    tm.tm_isdst = -1;
+
+    return mktime (&tm);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static guint64
+zip_get_uint (const unsigned char *p, size_t len)
+{
+    switch (len)
+    {
+    case 1:
+        return p[0];
+    case 2:
+        return zip_get16 (p);
+    case 4:
+        return zip_get32 (p);
+    case 8:
+        return zip_get64 (p);
+    default:
+        return 0;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Take 64-bit sizes and offset, modification time and owner from extra fields */
+
+static void
+zip_parse_extra (zip_central_t *c)
+{
+    const unsigned char *p = c->extra;
+    const unsigned char *end = c->extra + c->extra_len;
+
+    while (p + 4 <= end)
+    {
+        const guint16 id = zip_get16 (p);
+        const guint16 size = zip_get16 (p + 2);
+        const unsigned char *data = p + 4;
+        const unsigned char *data_end = data + size;
+
+        if (data_end > end)
+            break;
+
+        switch (id)
+        {
+        case ZIP_EXTRA_ZIP64:
+            // only fields that don't fit to the header are present, in this order
+            if (c->usize == ZIP64_MARK && data + 8 <= data_end)
+            {
+                c->usize = zip_get64 (data);
+                data += 8;
+            }
+            if (c->csize == ZIP64_MARK && data + 8 <= data_end)
+            {
+                c->csize = zip_get64 (data);
+                data += 8;
+            }
+            if (c->header_offset == ZIP64_MARK && data + 8 <= data_end)
+                c->header_offset = zip_get64 (data);
+            break;
+
+        case ZIP_EXTRA_TIMESTAMP:
+            // central directory keeps modification time only
+            if (size >= 5 && (data[0] & 1) != 0)
+            {
+                c->mtime = (time_t) (gint32) zip_get32 (data + 1);
+                c->have_mtime = TRUE;
+            }
+            break;
+
+        case ZIP_EXTRA_UNIX:
+            if (size >= 3 && data[0] == 1)
+            {
+                const size_t uid_len = data[1];
+                const unsigned char *q = data + 2 + uid_len;
+
+                if (q < data_end && q + 1 + q[0] <= data_end)
+                {
+                    c->uid = (uid_t) zip_get_uint (data + 2, uid_len);
+                    c->gid = (gid_t) zip_get_uint (q + 1, q[0]);
+                    c->have_owner = TRUE;
+                }
+            }
+            break;
+
+        default:
+            break;
+        }
+
+        p = data_end;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static mode_t
+zip_get_mode (const zip_central_t *c, gboolean is_dir)
+{
+    mode_t mode = 0;
+
+    if (c->host == ZIP_HOST_UNIX || c->host == ZIP_HOST_DARWIN)
+        mode = (mode_t) (c->attr >> 16);
+
+    if (mode == 0)
+    {
+        // MS-DOS attributes
+        if (is_dir || (c->attr & ZIP_ATTR_DIRECTORY) != 0)
+            mode = S_IFDIR | 0755;
+        else
+            mode = S_IFREG | 0644;
+
+        if ((c->attr & ZIP_ATTR_READONLY) != 0)
+            mode &= ~0222;
+    }
+    else if (is_dir)
+        mode = (mode & 07777) | S_IFDIR;
+    else if (!S_ISDIR (mode) && !S_ISLNK (mode))
+        mode = (mode & 07777) | S_IFREG;  // devices, fifos, etc have no sense in archive
+
+    // some writers don't store eXec for directories
+    if (S_ISDIR (mode))
+        mode |= (mode & 0444) >> 2;
+
+    return mode;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+zip_free_points (zip_member_t *m)
+{
+    guint i;
+
+    if (m->points == NULL)
+        return;
+
+    for (i = 0; i < m->points->len; i++)
+        g_free (g_array_index (m->points, zip_point_t, i).window);
+
+    g_array_free (m->points, TRUE);
+    m->points = NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+zip_free_inode (struct vfs_class *me, struct vfs_s_inode *ino)
+{
+    (void) me;
+
+    if (ino->user_data != NULL)
+    {
+        zip_free_points (ZIP_MEMBER (ino));
+        g_free (ino->user_data);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Find offset of member data */
+
+static gboolean
+zip_member_locate (int fd, zip_member_t *m)
+{
+    unsigned char h[ZIP_LOCAL_SIZE];
+
+    if (m->data_offset != -1)
+        return TRUE;
+
+    if (!zip_read_at (fd, m->header_offset, h, sizeof (h)) || zip_get32 (h) != ZIP_LOCAL_SIG)
+        return FALSE;
+
+    // name and extra field in local header can differ from ones in central directory
+    m->data_offset = m->header_offset + ZIP_LOCAL_SIZE + zip_get16 (h + 26) + zip_get16 (h + 28);
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Find the last saved state of inflater before @pos */
+
+static const zip_point_t *
+zip_find_point (const zip_member_t *m, off_t pos)
+{
+    const zip_point_t *points;
+    guint lo = 0, hi;
+
+    if (m->points == NULL || m->points->len == 0)
+        return NULL;
+
+    points = (const zip_point_t *) m->points->data;
+    hi = m->points->len;
+
+    while (lo < hi)
+    {
+        const guint mid = lo + (hi - lo) / 2;
+
+        if (points[mid].out <= pos)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo == 0 ? NULL : &points[lo - 1];
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+zip_save_point (zip_fh_t *zfh, zip_member_t *m)
+{
+    zip_point_t p;
+    unsigned char window[ZIP_WINDOW_SIZE];
+    uInt len = sizeof (window);
+
+    if (m->points == NULL)
+        m->points = g_array_new (FALSE, FALSE, sizeof (zip_point_t));
+    else if (m->points->len >= ZIP_POINTS_MAX)
+        return;
+
+    // states are shared by all handlers of member, keep them ordered
+    if (m->points->len != 0
+        && zfh->out < g_array_index (m->points, zip_point_t, m->points->len - 1).out + m->span)
+        return;
+
+    if (inflateGetDictionary (&zfh->zs, window, &len) != Z_OK)
+        return;
+
+    p.out = zfh->out;
+    p.in = zfh->in - zfh->zs.avail_in;
+    p.bits = zfh->zs.data_type & 7;
+    p.window = g_malloc (len);
+    memcpy (p.window, window, len);
+    p.window_len = len;
+    g_array_append_val (m->points, p);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Start inflating from saved state @p or from the beginning of member if @p is NULL */
+
+static gboolean
+zip_inflate_start (zip_fh_t *zfh, int fd, const zip_member_t *m, const zip_point_t *p)
+{
+    if (!zfh->inflating)
+    {
+        memset (&zfh->zs, 0, sizeof (zfh->zs));
+        // raw deflate data without zlib header
+        if (inflateInit2 (&zfh->zs, -MAX_WBITS) != Z_OK)
+            return FALSE;
+        zfh->inflating = TRUE;
+    }
+    else if (inflateReset (&zfh->zs) != Z_OK)
+        return FALSE;
+
+    zfh->zs.avail_in = 0;
+
+    if (p == NULL)
+    {
+        zfh->out = 0;
+        zfh->in = 0;
+        return TRUE;
+    }
+
+    zfh->out = p->out;
+    zfh->in = p->in;
+
+    if (p->bits != 0)
+    {
+        unsigned char c;
+
+        if (!zip_read_at (fd, m->data_offset + p->in - 1, &c, 1))
+            return FALSE;
+        inflatePrime (&zfh->zs, p->bits, c >> (8 - p->bits));
+    }
+
+    return (inflateSetDictionary (&zfh->zs, p->window, p->window_len) == Z_OK);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Inflate up to @count bytes to @buf.
+ *
+ * @return number of bytes inflated or -1 on error
+ */
+
+static ssize_t
+zip_inflate (zip_fh_t *zfh, int fd, zip_member_t *m, unsigned char *buf, size_t count)
+{
+    zfh->zs.next_out = buf;
+    zfh->zs.avail_out = (uInt) count;
+
+    while (zfh->zs.avail_out != 0)
+    {
+        const uInt avail_out = zfh->zs.avail_out;
+        int ret;
+
+        if (zfh->zs.avail_in == 0)
+        {
+            const size_t len = (size_t) MIN ((off_t) sizeof (zfh->buf), m->csize - zfh->in);
+
+            if (len == 0 || !zip_read_at (fd, m->data_offset + zfh->in, zfh->buf, len))
+                return -1;
+
+            zfh->in += (off_t) len;
+            zfh->zs.next_in = zfh->buf;
+            zfh->zs.avail_in = (uInt) len;
+        }
+
+        // stop at every block boundary to save states
+        ret = inflate (&zfh->zs, Z_BLOCK);
+        zfh->out += avail_out - zfh->zs.avail_out;
+
+        if (ret == Z_STREAM_END)
+            break;
+        if (ret != Z_OK && ret != Z_BUF_ERROR)
+            return -1;
+
+        // 128: end of block header, 64: last block
+        if ((zfh->zs.data_type & 128) != 0 && (zfh->zs.data_type & 64) == 0
+            && zfh->out >= m->span)
+            zip_save_point (zfh, m);
+    }
+
+    return (ssize_t) (count - zfh->zs.avail_out);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Read member data from the current position of file handler.
+ *
+ * @return number of bytes read or -1 on error
+ */
+
+static ssize_t
+zip_read_member (zip_fh_t *zfh, char *buffer, size_t count)
+{
+    vfs_file_handler_t *fh = VFS_FILE_HANDLER (zfh);
+    const int fd = ZIP_SUPER (VFS_FILE_HANDLER_SUPER (fh))->fd;
+    zip_member_t *m = ZIP_MEMBER (fh->ino);
+    const off_t pos = fh->pos;
+    const zip_point_t *p;
+    ssize_t res;
+
+    count = (size_t) MIN ((off_t) count, fh->ino->st.st_size - pos);
+    if (count == 0)
+        return 0;
+
+    if (!zip_member_locate (fd, m))
+        return -1;
+
+    if (m->method == ZIP_METHOD_STORED)
+    {
+        const off_t begin = m->data_offset + pos;
+
+        if (mc_lseek (fd, begin, SEEK_SET) != begin)
+            return -1;
+        return mc_read (fd, buffer, count);
+    }
+
+    // restart from the nearest saved state if it is closer than the current position
+    p = zip_find_point (m, pos);
+    if (!zfh->inflating || pos < zfh->out || (p != NULL && p->out > zfh->out))
+        if (!zip_inflate_start (zfh, fd, m, p))
+            return -1;
+
+    while (zfh->out < pos)
+    {
+        unsigned char skip[BUF_8K];
+
+        res = zip_inflate (zfh, fd, m, skip, (size_t) MIN ((off_t) sizeof (skip), pos - zfh->out));
+        if (res <= 0)
+            return -1;
+    }
+
+    res = zip_inflate (zfh, fd, m, (unsigned char *) buffer, count);
+
+    // data is shorter than size in directory
+    return (res == 0 ? -1 : res);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static vfs_file_handler_t *
+zip_fh_new (struct vfs_s_inode *ino, gboolean changed)
+{
+    zip_fh_t *fh;
+
+    fh = g_new0 (zip_fh_t, 1);
+    vfs_s_init_fh (VFS_FILE_HANDLER (fh), ino, changed);
+
+    return VFS_FILE_HANDLER (fh);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+zip_fh_free (vfs_file_handler_t *fh)
+{
+    zip_fh_t *zfh = ZIP_FH (fh);
+
+    if (zfh->inflating)
+        inflateEnd (&zfh->zs);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+zip_member_is_supported (const zip_member_t *m)
+{
+    return (!m->encrypted
+            && (m->method == ZIP_METHOD_STORED || m->method == ZIP_METHOD_DEFLATED));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Read target of symbolic link stored as content of member */
+
+static gboolean
+zip_read_link (struct vfs_s_inode *inode)
+{
+    vfs_file_handler_t *fh;
+    char *link;
+    off_t size = inode->st.st_size;
+    gboolean ok = TRUE;
+
+    if (size <= 0 || size >= MC_MAXPATHLEN || !zip_member_is_supported (ZIP_MEMBER (inode)))
+        return FALSE;
+
+    link = g_malloc (size + 1);
+    fh = zip_fh_new (inode, FALSE);
+
+    while (ok && fh->pos < size)
+    {
+        ssize_t res;
+
+        res = zip_read_member (ZIP_FH (fh), link + fh->pos, (size_t) (size - fh->pos));
+        ok = res > 0;
+        if (ok)
+            fh->pos += res;
+    }
+
+    zip_fh_free (fh);
+    g_free (fh);
+
+    if (!ok)
+    {
+        g_free (link);
+        return FALSE;
+    }
+
+    link[size] = '\0';
+    inode->linkname = link;
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/** Check that name doesn't go out of archive: it has no ".." components */
+
+static gboolean
+zip_name_is_safe (const char *name)
+{
+    const char *p = name;
+
+    while (*p != '\0')
+    {
+        const char *q;
+
+        q = strchr (p, PATH_SEP);
+        if (q == NULL)
+            q = p + strlen (p);
+
+        if (q - p == 2 && p[0] == '.' && p[1] == '.')
+            return FALSE;
+
+        p = *q == '\0' ? q : q + 1;
+    }
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+zip_insert_entry (struct vfs_class *me, struct vfs_s_super *super, const zip_central_t *c,
+                  GString *last_dir, struct vfs_s_inode **last_parent)
+{
+    zip_super_t *arch = ZIP_SUPER (super);
+    char *name, *p, *q;
+    gboolean is_dir;
+    struct stat st;
+    struct vfs_s_inode *parent, *inode;
+    struct vfs_s_entry *entry;
+    size_t len;
+
+    name = g_strndup ((const char *) c->name, c->name_len);
+
+    // strip leading and trailing separators
+    for (p = name; IS_PATH_SEP (*p); p++)
+        ;
+    len = strlen (p);
+    is_dir = len != 0 && IS_PATH_SEP (p[len - 1]);
+    while (len != 0 && IS_PATH_SEP (p[len - 1]))
+        p[--len] = '\0';
+
+    if (len == 0 || !zip_name_is_safe (p))
+    {
+        g_free (name);
+        return;
+    }
+
+    memset (&st, 0, sizeof (st));
+    st.st_mode = zip_get_mode (c, is_dir);
+    st.st_size = S_ISDIR (st.st_mode) ? 0 : (off_t) c->usize;
+    st.st_uid = c->have_owner ? c->uid : arch->st.st_uid;
+    st.st_gid = c->have_owner ? c->gid : arch->st.st_gid;
+    vfs_zero_stat_times (&st);
+    st.st_mtime = c->have_mtime ? c->mtime : zip_dos_time (c->dos_date, c->dos_time);
+    st.st_atime = st.st_ctime = st.st_mtime;
+#ifdef HAVE_STRUCT_STAT_ST_BLKSIZE
+    st.st_blksize = arch->st.st_blksize;
+#endif
+    vfs_adjust_stat (&st);
+
+    // p is directory, q is name
+    q = strrchr (p, PATH_SEP);
+    if (q == NULL)
+    {
+        q = p;
+        p = p + len;  // ""
+    }
+    else
+        *q++ = '\0';
+
+    // members of the same directory usually go one by one
+    if (*last_parent != NULL && strcmp (last_dir->str, p) == 0)
+        parent = *last_parent;
+    else
+    {
+        parent = vfs_s_find_inode (me, super, p, LINK_NO_FOLLOW, FL_MKDIR);
+        if (parent == NULL)
+        {
+            g_free (name);
+            return;
+        }
+
+        g_string_assign (last_dir, p);
+        *last_parent = parent;
+    }
+
+    entry = VFS_SUBCLASS (me)->find_entry (me, parent, q, LINK_NO_FOLLOW, FL_NONE);
+    if (entry != NULL)
+    {
+        // directory could be created already as parent of previous members
+        if (S_ISDIR (entry->ino->st.st_mode) && S_ISDIR (st.st_mode))
+        {
+            entry->ino->st.st_mode = st.st_mode;
+            entry->ino->st.st_uid = st.st_uid;
+            entry->ino->st.st_gid = st.st_gid;
+            vfs_copy_stat_times (&st, &entry->ino->st);
+        }
+
+        g_free (name);
+        return;
+    }
+
+    inode = vfs_s_new_inode (me, super, &st);
+
+    if (!S_ISDIR (st.st_mode))
+    {
+        zip_member_t *m;
+
+        m = g_new0 (zip_member_t, 1);
+        m->header_offset = (off_t) c->header_offset;
+        m->data_offset = -1;
+        m->csize = (off_t) c->csize;
+        m->method = c->method;
+        m->encrypted = (c->flags & (ZIP_FLAG_ENCRYPTED | ZIP_FLAG_STRONG_ENCRYPTION)) != 0;
+        m->span = MAX ((off_t) ZIP_SPAN_MIN, st.st_size / ZIP_POINTS_MAX);
+        inode->user_data = m;
+
+        if (S_ISLNK (st.st_mode) && !zip_read_link (inode))
+        {
+            // show unreadable link as regular file
+            inode->st.st_mode = (inode->st.st_mode & 07777) | S_IFREG;
+        }
+    }
+
+    entry = vfs_s_new_entry (me, q, inode);
+    vfs_s_insert_entry (me, parent, entry);
+
+    g_free (name);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Find central directory.
+ *
+ * @param cd_offset buffer to store offset of central directory in archive
+ * @param cd_size buffer to store size of central directory
+ * @param shift buffer to store size of data prepended to archive, offsets in archive
+ *              should be shifted by it
+ *
+ * @return TRUE on success, FALSE if central directory is not found
+ */
+
+static gboolean
+zip_find_central_dir (zip_super_t *arch, off_t *cd_offset, off_t *cd_size, off_t *shift)
+{
+    const off_t size = arch->st.st_size;
+    unsigned char *tail;
+    size_t tail_len;
+    off_t tail_offset, eocd_offset, cd_end;
+    const unsigned char *p;
+    unsigned char locator[ZIP64_LOCATOR_SIZE];
+    unsigned char eocd64[ZIP64_EOCD_SIZE];
+    guint64 offset, len;
+    gboolean found = FALSE;
+
+    if (size < ZIP_EOCD_SIZE)
+        return FALSE;
+
+    // end of central directory record is followed by comment up to 64K
+    tail_len = (size_t) MIN (size, (off_t) (ZIP_EOCD_SIZE + ZIP_COMMENT_MAX));
+    tail_offset = size - (off_t) tail_len;
+    tail = g_malloc (tail_len);
+
+    if (!zip_read_at (arch->fd, tail_offset, tail, tail_len))
+    {
+        g_free (tail);
+        return FALSE;
+    }
+
+    // search backward: comment can contain anything
+    for (p = tail + tail_len - ZIP_EOCD_SIZE; !found; p--)
+    {
+        found = zip_get32 (p) == ZIP_EOCD_SIG;
+        if (!found && p == tail)
+        {
+            g_free (tail);
+            return FALSE;
+        }
+    }
+
+    p++;
+    eocd_offset = tail_offset + (p - tail);
+    len = zip_get32 (p + 12);
+    offset = zip_get32 (p + 16);
+    cd_end = eocd_offset;
+
+    g_free (tail);
+
+    /* ZIP64 end record and its locator precede the end record. Writers can add them even if
+       all values fit to the end record, so don't rely on 0xffffffff marks */
+    if (eocd_offset >= ZIP64_LOCATOR_SIZE + ZIP64_EOCD_SIZE
+        && zip_read_at (arch->fd, eocd_offset - ZIP64_LOCATOR_SIZE, locator, sizeof (locator))
+        && zip_get32 (locator) == ZIP64_LOCATOR_SIG)
+    {
+        off_t eocd64_offset;
+
+        eocd64_offset = (off_t) zip_get64 (locator + 8);
+
+        // with prepended data the record is not where the locator says
+        if (eocd64_offset < 0 || eocd64_offset > size - ZIP64_EOCD_SIZE
+            || !zip_read_at (arch->fd, eocd64_offset, eocd64, sizeof (eocd64))
+            || zip_get32 (eocd64) != ZIP64_EOCD_SIG)
+        {
+            eocd64_offset = eocd_offset - ZIP64_LOCATOR_SIZE - ZIP64_EOCD_SIZE;
+            if (!zip_read_at (arch->fd, eocd64_offset, eocd64, sizeof (eocd64))
+                || zip_get32 (eocd64) != ZIP64_EOCD_SIG)
+                return FALSE;
+        }
+
+        len = zip_get64 (eocd64 + 40);
+        offset = zip_get64 (eocd64 + 48);
+        cd_end = eocd64_offset;
+    }
+
+    if (len > (guint64) cd_end || offset > (guint64) cd_end - len)
+        return FALSE;
+
+    *cd_offset = (off_t) offset;
+    *cd_size = (off_t) len;
+    *shift = cd_end - (off_t) (offset + len);
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static gboolean
+zip_read_central_dir (struct vfs_class *me, struct vfs_s_super *super)
+{
+    zip_super_t *arch = ZIP_SUPER (super);
+    off_t cd_offset, cd_size, shift;
+    unsigned char *cd;
+    const unsigned char *p, *end;
+    GString *last_dir;
+    struct vfs_s_inode *last_parent = NULL;
+
+    if (!zip_find_central_dir (arch, &cd_offset, &cd_size, &shift))
+        return FALSE;
+
+    cd = g_try_malloc (cd_size + 1);
+    if (cd == NULL || !zip_read_at (arch->fd, cd_offset + shift, cd, (size_t) cd_size))
+    {
+        g_free (cd);
+        return FALSE;
+    }
+
+    last_dir = g_string_new ("");
+    end = cd + cd_size;
+
+    // don't trust number of entries: it is 16-bit in old archives
+    for (p = cd; p + ZIP_CENTRAL_SIZE <= end && zip_get32 (p) == ZIP_CENTRAL_SIG;)
+    {
+        zip_central_t c;
+        const unsigned char *next;
+
+        memset (&c, 0, sizeof (c));
+        c.host = p[5];
+        c.flags = zip_get16 (p + 8);
+        c.method = zip_get16 (p + 10);
+        c.dos_time = zip_get16 (p + 12);
+        c.dos_date = zip_get16 (p + 14);
+        c.csize = zip_get32 (p + 20);
+        c.usize = zip_get32 (p + 24);
+        c.name_len = zip_get16 (p + 28);
+        c.extra_len = zip_get16 (p + 30);
+        c.attr = zip_get32 (p + 38);
+        c.header_offset = zip_get32 (p + 42);
+        c.name = p + ZIP_CENTRAL_SIZE;
+        c.extra = c.name + c.name_len;
+
+        next = c.extra + c.extra_len + zip_get16 (p + 32);
+        if (next > end)
+            break;
+
+        zip_parse_extra (&c);
+        c.header_offset += (guint64) shift;
+
+        zip_insert_entry (me, super, &c, last_dir, &last_parent);
+
+        p = next;
+    }
+
+    g_string_free (last_dir, TRUE);
+    g_free (cd);
+
+    return TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static struct vfs_s_super *
+zip_new_archive (struct vfs_class *me)
+{
+    zip_super_t *arch;
+
+    arch = g_new0 (zip_super_t, 1);
+    arch->base.me = me;
+    arch->fd = -1;
+
+    return VFS_SUPER (arch);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+zip_free_archive (struct vfs_class *me, struct vfs_s_super *super)
+{
+    zip_super_t *arch = ZIP_SUPER (super);
+
+    (void) me;
+
+    if (arch->fd != -1)
+    {
+        mc_close (arch->fd);
+        arch->fd = -1;
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static int
+zip_open_archive (struct vfs_s_super *super, const vfs_path_t *vpath,
+                  const vfs_path_element_t *vpath_element)
+{
+    struct vfs_class *me = vpath_element->class;
+    zip_super_t *arch = ZIP_SUPER (super);
+    mode_t mode;
+    struct vfs_s_inode *root;
+
+    arch->fd = mc_open (vpath, O_RDONLY);
+    if (arch->fd == -1)
+    {
+        message (D_ERROR, MSG_ERROR, _ ("Cannot open zip archive\n%s"), vfs_path_as_str (vpath));
+        ERRNOR (ENOENT, -1);
+    }
+
+    super->name = g_strdup (vfs_path_as_str (vpath));
+    mc_stat (vpath, &arch->st);
+
+    mode = arch->st.st_mode & 07777;
+    mode |= (mode & 0444) >> 2;  // set eXec where Read is
+    mode |= S_IFDIR;
+
+    root = vfs_s_new_inode (me, super, &arch->st);
+    root->st.st_mode = mode;
+    root->data_offset = -1;
+    root->st.st_nlink++;
+    root->st.st_dev = VFS_SUBCLASS (me)->rdev++;
+
+    super->root = root;
+
+    if (!zip_read_central_dir (me, super))
+    {
+        message (D_ERROR, MSG_ERROR, _ ("%s\ndoesn't look like a zip archive"),
+                 vfs_path_as_str (vpath));
+        return -1;
+    }
+
+    return 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void *
+zip_super_check (const vfs_path_t *vpath)
+{
+    static struct stat stat_buf;
+    int stat_result;
+
+    stat_result = mc_stat (vpath, &stat_buf);
+
+    return (stat_result != 0) ? NULL : &stat_buf;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static int
+zip_super_same (const vfs_path_element_t *vpath_element, struct vfs_s_super *parc,
+                const vfs_path_t *vpath, void *cookie)
+{
+    struct stat *archive_stat = cookie;  // stat of main archive
+
+    (void) vpath_element;
+
+    if (strcmp (parc->name, vfs_path_as_str (vpath)) != 0)
+        return 0;
+
+    // Has the cached archive been changed on the disk?
+    if (ZIP_SUPER (parc)->st.st_mtime < archive_stat->st_mtime
+        || ZIP_SUPER (parc)->st.st_size != archive_stat->st_size)
+    {
+        // Yes, reload!
+        vfs_zipfs_ops->free ((vfsid) parc);
+        vfs_rmstamp (vfs_zipfs_ops, (vfsid) parc);
+        return 2;
+    }
+    // Hasn't been modified, give it a new timeout
+    vfs_stamp (vfs_zipfs_ops, (vfsid) parc);
+    return 1;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static ssize_t
+zip_read (void *fh, char *buffer, size_t count)
+{
+    struct vfs_class *me = VFS_FILE_HANDLER_SUPER (fh)->me;
+    vfs_file_handler_t *file = VFS_FILE_HANDLER (fh);
+    ssize_t res;
+
+    if (!zip_member_is_supported (ZIP_MEMBER (file->ino)))
+        ERRNOR (ENOTSUP, -1);
+
+    res = zip_read_member (ZIP_FH (fh), buffer, count);
+    if (res == -1)
+        ERRNOR (EIO, -1);
+
+    file->pos += res;
+    return res;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static int
+zip_fh_open (struct vfs_class *me, vfs_file_handler_t *fh, int flags, mode_t mode)
+{
+    (void) mode;
+
+    if ((flags & O_ACCMODE) != O_RDONLY)
+        ERRNOR (EROFS, -1);
+    if (!zip_member_is_supported (ZIP_MEMBER (fh->ino)))
+        ERRNOR (ENOTSUP, -1);
+    return 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/*** public functions ****************************************************************************/
+/* --------------------------------------------------------------------------------------------- */
+
+void
+vfs_init_zipfs (void)
+{
+    vfs_init_subclass (&zip_subclass, "zipfs", VFSF_READONLY, "zip");
+    vfs_zipfs_ops->read = zip_read;
+    vfs_zipfs_ops->setctl = NULL;
+    zip_subclass.archive_check = zip_super_check;
+    zip_subclass.archive_same = zip_super_same;
+    zip_subclass.new_archive = zip_new_archive;
+    zip_subclass.open_archive = zip_open_archive;
+    zip_subclass.free_archive = zip_free_archive;
+    zip_subclass.free_inode = zip_free_inode;
+    zip_subclass.fh_new = zip_fh_new;
+    zip_subclass.fh_open = zip_fh_open;
+    zip_subclass.fh_free = zip_fh_free;
+    vfs_register_class (vfs_zipfs_ops);
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -46,6 +46,12 @@
    saving its changes. Inspect the source before you want to use it for
    other purposes.
 
+   Local files are mapped into memory if possible, so that reading them is
+   plain pointer arithmetic. Files that don't fit into the address space are
+   mapped by large windows. Other files are read by pages which are kept
+   in the LRU cache, so that scrolling back and forth doesn't read the same
+   data from remote file systems again and again.
+
    The mcview_get_filesize() function returns the current size of the
    data source. If the growing buffer is used, this size may increase
    later on. Use the mcview_may_still_grow() function when you want to
@@ -54,6 +60,13 @@
 
 #include <config.h>
 
+#include <fcntl.h>
+#include <signal.h>
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+#include <unistd.h>
+
 #include "lib/global.h"
 #include "lib/vfs/vfs.h"
 #include "lib/util.h"
@@ -65,16 +78,276 @@
 
 /*** file scope macro definitions ****************************************************************/
 
+/* size of mapped window if the whole file can't be mapped */
+#define MMAP_WINDOW_SIZE ((off_t) 64 * 1024 * 1024)
+
+/* number of pages read at once in the direction of scrolling */
+#define FILE_READAHEAD_PAGES 8
+
 /*** file scope type declarations ****************************************************************/
 
+/* cached page of the file */
+typedef struct
+{
+    gint64 pageno;  // page number, the key in the page hash table
+    byte *data;     // page data
+    size_t len;     // number of valid bytes in data
+    GList link;     // link in the LRU list, data points to the page itself
+} mcview_file_page_t;
+
 /*** forward declarations (file scope functions) *************************************************/
 
 /*** file scope variables ************************************************************************/
 
+#ifdef HAVE_MMAP
+/* viewers with memory-mapped files, checked by SIGBUS handler */
+static GSList *mcview_mmap_views = NULL;
+static struct sigaction mcview_mmap_old_sigbus;
+#endif
+
 /* --------------------------------------------------------------------------------------------- */
 /*** file scope functions ************************************************************************/
 /* --------------------------------------------------------------------------------------------- */
 
+static void
+mcview_file_page_free (gpointer data)
+{
+    mcview_file_page_t *page = (mcview_file_page_t *) data;
+
+    g_free (page->data);
+    g_free (page);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static inline mcview_file_page_t *
+mcview_file_cache_lookup (WView *view, off_t pageno)
+{
+    const gint64 key = (gint64) pageno;
+
+    return (mcview_file_page_t *) g_hash_table_lookup (view->ds_file_pages, &key);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Add the empty page to the cache. If the cache is full, the least recently used page is reused:
+ * its memory is kept allocated until the data source is closed.
+ */
+
+static mcview_file_page_t *
+mcview_file_cache_add (WView *view, off_t pageno)
+{
+    mcview_file_page_t *page;
+
+    if (g_queue_get_length (view->ds_file_lru) < view->ds_file_maxpages)
+    {
+        page = g_new (mcview_file_page_t, 1);
+        page->data = g_malloc (view->ds_file_datasize);
+        page->link.data = page;
+        page->link.prev = page->link.next = NULL;
+    }
+    else
+    {
+        page = (mcview_file_page_t *) g_queue_peek_tail (view->ds_file_lru);
+        g_queue_unlink (view->ds_file_lru, &page->link);
+        g_hash_table_steal (view->ds_file_pages, &page->pageno);
+    }
+
+    page->pageno = (gint64) pageno;
+    page->len = 0;
+    g_queue_push_head_link (view->ds_file_lru, &page->link);
+    g_hash_table_insert (view->ds_file_pages, &page->pageno, page);
+
+    return page;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+mcview_file_cache_remove (WView *view, mcview_file_page_t *page)
+{
+    g_queue_unlink (view->ds_file_lru, &page->link);
+    // frees the page
+    g_hash_table_remove (view->ds_file_pages, &page->pageno);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Read the page from the current position of the file.
+ *
+ * @return FALSE on read error or end of file, TRUE otherwise
+ */
+
+static gboolean
+mcview_file_read_page (WView *view, mcview_file_page_t *page)
+{
+    const off_t offset = (off_t) page->pageno * (off_t) view->ds_file_datasize;
+    size_t bytes_read = 0;
+
+    while (bytes_read < view->ds_file_datasize)
+    {
+        ssize_t res;
+
+        res = mc_read (view->ds_file_fd, page->data + bytes_read,
+                       view->ds_file_datasize - bytes_read);
+        if (res == -1)
+            return FALSE;
+        if (res == 0)
+            break;
+        bytes_read += (size_t) res;
+    }
+
+    if ((off_t) bytes_read > view->ds_file_filesize - offset)
+    {
+        // the file has grown in the meantime -- stick to the old size
+        page->len = view->ds_file_filesize - offset;
+    }
+    else
+    {
+        page->len = bytes_read;
+    }
+
+    return page->len != 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Read the page and some pages after or before it (read ahead in the direction of scrolling)
+ * by one request.
+ *
+ * @return the page or NULL on error
+ */
+
+static mcview_file_page_t *
+mcview_file_read_pages (WView *view, off_t pageno, gboolean backwards)
+{
+    const off_t last_page = (view->ds_file_filesize - 1) / (off_t) view->ds_file_datasize;
+    const off_t count = (off_t) MIN (FILE_READAHEAD_PAGES, view->ds_file_maxpages / 2);
+    off_t first = pageno;
+    off_t last = pageno;
+    off_t p;
+
+    if (backwards)
+        while (first > 0 && pageno - first + 1 < count
+               && mcview_file_cache_lookup (view, first - 1) == NULL)
+            first--;
+    else
+        while (last < last_page && last - pageno + 1 < count
+               && mcview_file_cache_lookup (view, last + 1) == NULL)
+            last++;
+
+    if (mc_lseek (view->ds_file_fd, first * (off_t) view->ds_file_datasize, SEEK_SET) == -1)
+        return NULL;
+
+    for (p = first; p <= last; p++)
+    {
+        mcview_file_page_t *page;
+
+        page = mcview_file_cache_lookup (view, p);
+        if (page == NULL)
+            page = mcview_file_cache_add (view, p);
+
+        if (!mcview_file_read_page (view, page))
+        {
+            mcview_file_cache_remove (view, page);
+            break;
+        }
+    }
+
+    return mcview_file_cache_lookup (view, pageno);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+#ifdef HAVE_MMAP
+/**
+ * Access to the mapped pages beyond the end of file truncated by another process raises SIGBUS.
+ * Replace the rest of the mapping with zero pages to let the access complete, and mark the view
+ * to check the file size and map the file again on the next access.
+ */
+
+static void
+mcview_mmap_sigbus_handler (int sig, siginfo_t *info, void *context)
+{
+    const long pagesize = sysconf (_SC_PAGESIZE);
+    GSList *i;
+
+    (void) sig;
+    (void) context;
+
+    for (i = mcview_mmap_views; i != NULL; i = g_slist_next (i))
+    {
+        WView *view = (WView *) i->data;
+        byte *addr = (byte *) info->si_addr;
+
+        if (view->ds_mmap_data != NULL && addr >= view->ds_mmap_data
+            && addr < view->ds_mmap_data + view->ds_mmap_datalen)
+        {
+            byte *page;
+
+            page = view->ds_mmap_data + ((addr - view->ds_mmap_data) / pagesize) * pagesize;
+            if (mmap (page, (size_t) (view->ds_mmap_data + view->ds_mmap_datalen - page),
+                      PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0)
+                == MAP_FAILED)
+                break;
+
+            view->ds_mmap_truncated = 1;
+            return;
+        }
+    }
+
+    // not our fault: restore the previous action, it is taken when the access is restarted
+    (void) sigaction (SIGBUS, &mcview_mmap_old_sigbus, NULL);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+mcview_mmap_guard_add (WView *view)
+{
+    if (mcview_mmap_views == NULL)
+    {
+        struct sigaction sa;
+
+        memset (&sa, 0, sizeof (sa));
+        sa.sa_sigaction = mcview_mmap_sigbus_handler;
+        sa.sa_flags = SA_SIGINFO;
+        sigemptyset (&sa.sa_mask);
+        (void) sigaction (SIGBUS, &sa, &mcview_mmap_old_sigbus);
+    }
+
+    mcview_mmap_views = g_slist_prepend (mcview_mmap_views, view);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+mcview_mmap_guard_remove (WView *view)
+{
+    mcview_mmap_views = g_slist_remove (mcview_mmap_views, view);
+
+    if (mcview_mmap_views == NULL)
+        (void) sigaction (SIGBUS, &mcview_mmap_old_sigbus, NULL);
+}
+#endif
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+mcview_mmap_unload_data (WView *view)
+{
+#ifdef HAVE_MMAP
+    if (view->ds_mmap_data != NULL)
+        (void) munmap (view->ds_mmap_data, view->ds_mmap_datalen);
+#endif
+
+    view->ds_mmap_data = NULL;
+    view->ds_mmap_offset = 0;
+    view->ds_mmap_datalen = 0;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static void
 mcview_set_datasource_stdio_pipe (WView *view, mc_pipe_t *p)
 {
@@ -111,6 +384,8 @@ mcview_get_filesize (WView *view)
         return mcview_growbuf_filesize (view);
     case DS_FILE:
         return view->ds_file_filesize;
+    case DS_MMAP:
+        return view->ds_mmap_filesize;
     case DS_STRING:
         return view->ds_string_len;
     default:
@@ -129,6 +404,21 @@ mcview_update_filesize (WView *view)
         if (mc_fstat (view->ds_file_fd, &st) != -1)
             view->ds_file_filesize = st.st_size;
     }
+    else if (view->datasource == DS_MMAP)
+    {
+        struct stat st;
+        const gboolean truncated = view->ds_mmap_truncated != 0;
+
+        view->ds_mmap_truncated = 0;
+
+        // pages beyond the new end of file were replaced with zero pages: map the file again
+        if (fstat (view->ds_mmap_fd, &st) != -1
+            && (truncated || st.st_size != view->ds_mmap_filesize))
+        {
+            mcview_mmap_unload_data (view);
+            view->ds_mmap_filesize = st.st_size;
+        }
+    }
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -145,39 +435,82 @@ mcview_get_ptr_file (WView *view, off_t byte_index)
 }
 
 /* --------------------------------------------------------------------------------------------- */
+/**
+ * Get pointer to the data at the given offset and the number of bytes that can be read
+ * from there in one go. The data is valid until the next access to the data source.
+ *
+ * @return pointer to the data or NULL if offset is out of range
+ */
 
-/* Invalid UTF-8 is reported as negative integers (one for each byte),
- * see ticket 3783. */
-gboolean
-mcview_get_utf (WView *view, off_t byte_index, int *ch, int *ch_len)
+char *
+mcview_get_block (WView *view, off_t byte_index, size_t *len)
 {
-    gchar *str = NULL;
-    int res;
-    gchar utf8buf[MB_LEN_MAX + 1];
+    char *p;
 
     switch (view->datasource)
     {
     case DS_STDIO_PIPE:
     case DS_VFS_PIPE:
-        str = mcview_get_ptr_growing_buffer (view, byte_index);
-        break;
+        return mcview_get_block_growing_buffer (view, byte_index, len);
     case DS_FILE:
-        str = mcview_get_ptr_file (view, byte_index);
-        break;
+        p = mcview_get_ptr_file (view, byte_index);
+        if (p != NULL)
+            *len = view->ds_file_datalen - (size_t) (byte_index - view->ds_file_offset);
+        return p;
+    case DS_MMAP:
+        p = mcview_get_ptr_mmap (view, byte_index);
+        if (p != NULL)
+            *len = view->ds_mmap_datalen - (size_t) (byte_index - view->ds_mmap_offset);
+        return p;
     case DS_STRING:
-        str = mcview_get_ptr_string (view, byte_index);
-        break;
+        p = mcview_get_ptr_string (view, byte_index);
+        if (p != NULL)
+            *len = view->ds_string_len - (size_t) byte_index;
+        return p;
     case DS_NONE:
     default:
-        break;
+        return NULL;
     }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+char *
+mcview_get_ptr_mmap (WView *view, off_t byte_index)
+{
+    g_assert (view->datasource == DS_MMAP);
+
+    if (view->ds_mmap_truncated)
+        mcview_update_filesize (view);
+
+    mcview_mmap_load_data (view, byte_index);
+    if (mcview_already_loaded (view->ds_mmap_offset, byte_index, view->ds_mmap_datalen))
+        return (char *) (view->ds_mmap_data + (byte_index - view->ds_mmap_offset));
+    return NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* Invalid UTF-8 is reported as negative integers (one for each byte),
+ * see ticket 3783. */
+gboolean
+mcview_get_utf (WView *view, off_t byte_index, int *ch, int *ch_len)
+{
+    gchar *str;
+    size_t len = 0;
+    int res = -1;
+    gchar utf8buf[MB_LEN_MAX + 1];
+
+    str = mcview_get_block (view, byte_index, &len);
 
     *ch = 0;
 
     if (str == NULL)
         return FALSE;
 
-    res = g_utf8_get_char_validated (str, -1);
+    // don't read beyond the end of data: mapped file isn't null-terminated
+    if (len >= MB_LEN_MAX)
+        res = g_utf8_get_char_validated (str, -1);
 
     if (res < 0)
     {
@@ -273,9 +606,19 @@ mcview_set_byte (WView *view, off_t offset, byte b)
     (void) offset;
 
     g_assert (offset < mcview_get_filesize (view));
-    g_assert (view->datasource == DS_FILE);
+    g_assert (view->datasource == DS_FILE || view->datasource == DS_MMAP);
 
-    view->ds_file_datalen = 0;  // just force reloading
+    // the shared mapping already reflects the changes
+    if (view->datasource == DS_FILE)
+    {
+        mcview_file_page_t *page;
+
+        page = mcview_file_cache_lookup (view, offset / (off_t) view->ds_file_datasize);
+        if (page != NULL)
+            mcview_file_cache_remove (view, page);
+
+        view->ds_file_datalen = 0;  // just force reloading
+    }
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -284,47 +627,108 @@ mcview_set_byte (WView *view, off_t offset, byte b)
 void
 mcview_file_load_data (WView *view, off_t byte_index)
 {
-    off_t blockoffset;
-    ssize_t res;
-    size_t bytes_read;
+    off_t pageno;
+    mcview_file_page_t *page;
 
     g_assert (view->datasource == DS_FILE);
 
     if (mcview_already_loaded (view->ds_file_offset, byte_index, view->ds_file_datalen))
         return;
 
-    if (byte_index >= view->ds_file_filesize)
+    if (byte_index < 0 || byte_index >= view->ds_file_filesize)
         return;
 
-    blockoffset = mcview_offset_rounddown (byte_index, view->ds_file_datasize);
-    if (mc_lseek (view->ds_file_fd, blockoffset, SEEK_SET) == -1)
-        goto error;
+    pageno = byte_index / (off_t) view->ds_file_datasize;
 
-    bytes_read = 0;
-    while (bytes_read < view->ds_file_datasize)
+    page = mcview_file_cache_lookup (view, pageno);
+    // the last page is read again if the file has grown
+    if (page == NULL || byte_index % (off_t) view->ds_file_datasize >= (off_t) page->len)
     {
-        res = mc_read (view->ds_file_fd, view->ds_file_data + bytes_read,
-                       view->ds_file_datasize - bytes_read);
-        if (res == -1)
-            goto error;
-        if (res == 0)
-            break;
-        bytes_read += (size_t) res;
-    }
-    view->ds_file_offset = blockoffset;
-    if ((off_t) bytes_read > view->ds_file_filesize - view->ds_file_offset)
-    {
-        // the file has grown in the meantime -- stick to the old size
-        view->ds_file_datalen = view->ds_file_filesize - view->ds_file_offset;
+        const gboolean backwards = view->ds_file_datalen != 0 && byte_index < view->ds_file_offset;
+
+        page = mcview_file_read_pages (view, pageno, backwards);
+        if (page == NULL)
+        {
+            view->ds_file_datalen = 0;
+            return;
+        }
     }
-    else
+
+    // move the page to the head of the LRU list
+    g_queue_unlink (view->ds_file_lru, &page->link);
+    g_queue_push_head_link (view->ds_file_lru, &page->link);
+
+    view->ds_file_offset = (off_t) pageno * (off_t) view->ds_file_datasize;
+    view->ds_file_data = page->data;
+    view->ds_file_datalen = page->len;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+void
+mcview_mmap_load_data (WView *view, off_t byte_index)
+{
+#ifdef HAVE_MMAP
+    off_t offset = 0;
+    off_t len;
+    void *data;
+
+    g_assert (view->datasource == DS_MMAP);
+
+    if (mcview_already_loaded (view->ds_mmap_offset, byte_index, view->ds_mmap_datalen))
+        return;
+
+    if (byte_index < 0 || byte_index >= view->ds_mmap_filesize)
+        return;
+
+    len = view->ds_mmap_filesize;
+
+    // on 32-bit systems, map the huge file by windows
+    if (sizeof (void *) < 8 && len > MMAP_WINDOW_SIZE)
     {
-        view->ds_file_datalen = bytes_read;
+        offset = mcview_offset_rounddown (byte_index, MMAP_WINDOW_SIZE);
+        len = MIN (MMAP_WINDOW_SIZE, view->ds_mmap_filesize - offset);
     }
-    return;
 
-error:
-    view->ds_file_datalen = 0;
+    mcview_mmap_unload_data (view);
+
+    data = mmap (NULL, (size_t) len, PROT_READ, MAP_SHARED, view->ds_mmap_fd, offset);
+    if (data == MAP_FAILED)
+        return;
+
+    view->ds_mmap_data = (byte *) data;
+    view->ds_mmap_offset = offset;
+    view->ds_mmap_datalen = (size_t) len;
+
+#ifdef HAVE_MADVISE
+    if (view->ds_mmap_sequential)
+        (void) madvise (data, (size_t) len, MADV_SEQUENTIAL);
+#endif
+#else
+    (void) view;
+    (void) byte_index;
+#endif
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Tell the kernel how the data will be accessed: sequentially (e.g. by search) or randomly
+ * (browsing). Sequential access enables aggressive read-ahead of the mapped file.
+ */
+
+void
+mcview_advise_access (WView *view, gboolean sequential)
+{
+    if (view->datasource != DS_MMAP || view->ds_mmap_sequential == sequential)
+        return;
+
+    view->ds_mmap_sequential = sequential;
+
+#ifdef HAVE_MADVISE
+    if (view->ds_mmap_data != NULL)
+        (void) madvise (view->ds_mmap_data, view->ds_mmap_datalen,
+                        sequential ? MADV_SEQUENTIAL : MADV_NORMAL);
+#endif
 }
 
 /* --------------------------------------------------------------------------------------------- */
@@ -352,7 +756,20 @@ mcview_close_datasource (WView *view)
     case DS_FILE:
         (void) mc_close (view->ds_file_fd);
         view->ds_file_fd = -1;
-        MC_PTR_FREE (view->ds_file_data);
+        view->ds_file_data = NULL;
+        view->ds_file_datalen = 0;
+        g_queue_free (view->ds_file_lru);
+        view->ds_file_lru = NULL;
+        g_hash_table_destroy (view->ds_file_pages);
+        view->ds_file_pages = NULL;
+        break;
+    case DS_MMAP:
+        mcview_mmap_unload_data (view);
+#ifdef HAVE_MMAP
+        mcview_mmap_guard_remove (view);
+#endif
+        (void) close (view->ds_mmap_fd);
+        view->ds_mmap_fd = -1;
         break;
     case DS_STRING:
         MC_PTR_FREE (view->ds_string_data);
@@ -372,9 +789,78 @@ mcview_set_datasource_file (WView *view, int fd, const struct stat *st)
     view->ds_file_fd = fd;
     view->ds_file_filesize = st->st_size;
     view->ds_file_offset = 0;
-    view->ds_file_data = g_malloc (4096);
+    view->ds_file_data = NULL;
     view->ds_file_datalen = 0;
     view->ds_file_datasize = 4096;
+    view->ds_file_maxpages =
+        (guint) MAX (0, mcview_file_cache_size) * 1024 / view->ds_file_datasize;
+    view->ds_file_maxpages = MAX (view->ds_file_maxpages, 2 * FILE_READAHEAD_PAGES);
+    view->ds_file_pages =
+        g_hash_table_new_full (g_int64_hash, g_int64_equal, NULL, mcview_file_page_free);
+    view->ds_file_lru = g_queue_new ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Try to use memory-mapped local file as data source.
+ *
+ * @param fd VFS file handle. It is closed on success
+ *
+ * @return TRUE if file is mapped, FALSE otherwise
+ */
+
+gboolean
+mcview_set_datasource_mmap (WView *view, int fd, const vfs_path_t *vpath, const struct stat *st)
+{
+#ifdef HAVE_MMAP
+    int local_fd;
+    struct stat local_st;
+
+    if (!vfs_file_is_local (vpath))
+        return FALSE;
+
+    // VFS handle can't be mapped: open the file again and make sure it is the same file
+    local_fd = open (vfs_path_get_last_path_str (vpath), O_RDONLY | O_CLOEXEC);
+    if (local_fd == -1)
+        return FALSE;
+
+    if (fstat (local_fd, &local_st) == -1 || local_st.st_dev != st->st_dev
+        || local_st.st_ino != st->st_ino || local_st.st_size != st->st_size)
+    {
+        (void) close (local_fd);
+        return FALSE;
+    }
+
+    view->datasource = DS_MMAP;
+    view->ds_mmap_fd = local_fd;
+    view->ds_mmap_filesize = st->st_size;
+    view->ds_mmap_data = NULL;
+    view->ds_mmap_offset = 0;
+    view->ds_mmap_datalen = 0;
+    view->ds_mmap_sequential = FALSE;
+    view->ds_mmap_truncated = 0;
+
+    mcview_mmap_load_data (view, 0);
+    if (view->ds_mmap_data == NULL)
+    {
+        (void) close (local_fd);
+        view->ds_mmap_fd = -1;
+        view->datasource = DS_NONE;
+        return FALSE;
+    }
+
+    mcview_mmap_guard_add (view);
+    (void) mc_close (fd);
+
+    return TRUE;
+#else
+    (void) view;
+    (void) fd;
+    (void) vpath;
+    (void) st;
+
+    return FALSE;
+#endif
 }
 
 /* --------------------------------------------------------------------------------------------- */
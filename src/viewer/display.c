@@ -86,7 +86,7 @@ mcview_set_buttonbar (WView *view)
     {
         if (view->hexedit_mode)
             buttonbar_set_label (b, 2, Q_ ("ButtonBar|View"), keymap, w);
-        else if (view->datasource == DS_FILE)
+        else if (view->datasource == DS_FILE || view->datasource == DS_MMAP)
             buttonbar_set_label (b, 2, Q_ ("ButtonBar|Edit"), keymap, w);
         else
             buttonbar_set_label (b, 2, "", keymap, WIDGET (view));
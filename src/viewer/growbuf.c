@@ -291,3 +291,30 @@ mcview_get_ptr_growing_buffer (WView *view, off_t byte_index)
 }
 
 /* --------------------------------------------------------------------------------------------- */
+/**
+ * Get pointer to the data at the given offset and the number of bytes available there
+ * without crossing the page boundary.
+ */
+
+char *
+mcview_get_block_growing_buffer (WView *view, off_t byte_index, size_t *len)
+{
+    char *p;
+    off_t pageno, pageindex;
+
+    p = mcview_get_ptr_growing_buffer (view, byte_index);
+    if (p == NULL)
+        return NULL;
+
+    pageno = byte_index / VIEW_PAGE_SIZE;
+    pageindex = byte_index % VIEW_PAGE_SIZE;
+
+    if (pageno < (off_t) view->growbuf_blockptr->len - 1)
+        *len = (size_t) (VIEW_PAGE_SIZE - pageindex);
+    else
+        *len = (size_t) (view->growbuf_lastindex - pageindex);
+
+    return p;
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -34,6 +34,7 @@ enum view_ds
     DS_STDIO_PIPE,  // Data comes from a pipe using popen/pclose
     DS_VFS_PIPE,    // Data comes from a piped-in VFS file
     DS_FILE,        // Data comes from a VFS file
+    DS_MMAP,        // Data comes from a memory-mapped local file
     DS_STRING       // Data comes from a string in memory
 };
 
@@ -110,9 +111,21 @@ struct WView
     int ds_file_fd;           // File with random access
     off_t ds_file_filesize;   // Size of the file
     off_t ds_file_offset;     // Offset of the currently loaded data
-    byte *ds_file_data;       // Currently loaded data
+    byte *ds_file_data;       // Currently loaded data, points to the cached page
     size_t ds_file_datalen;   // Number of valid bytes in file_data
-    size_t ds_file_datasize;  // Number of allocated bytes in file_data
+    size_t ds_file_datasize;  // Size of the page
+    GHashTable *ds_file_pages;  // Cached pages, indexed by page number
+    GQueue *ds_file_lru;        // Cached pages, the most recently used first
+    guint ds_file_maxpages;     // Maximum number of cached pages
+
+    // memory-mapped file data source
+    int ds_mmap_fd;          // Local file, used to map windows if the file isn't mapped at whole
+    off_t ds_mmap_filesize;  // Size of the file
+    off_t ds_mmap_offset;    // Offset of the currently mapped window
+    byte *ds_mmap_data;      // Currently mapped window
+    size_t ds_mmap_datalen;  // Number of bytes in the mapped window
+    gboolean ds_mmap_sequential;  // Data is read sequentially, see mcview_advise_access()
+    SIG_ATOMIC_VOLATILE_T ds_mmap_truncated;  // Pages beyond the end of file were accessed
 
     // string data source
     byte *ds_string_data;  // The characters of the string
@@ -241,14 +254,20 @@ void mcview_set_datasource_none (WView *view);
 off_t mcview_get_filesize (WView *view);
 void mcview_update_filesize (WView *view);
 char *mcview_get_ptr_file (WView *view, off_t byte_index);
+char *mcview_get_ptr_mmap (WView *view, off_t byte_index);
 char *mcview_get_ptr_string (WView *view, off_t byte_index);
+char *mcview_get_block (WView *view, off_t byte_index, size_t *len);
 gboolean mcview_get_utf (WView *view, off_t byte_index, int *ch, int *ch_len);
 gboolean mcview_get_byte_string (WView *view, off_t byte_index, int *retval);
 gboolean mcview_get_byte_none (WView *view, off_t byte_index, int *retval);
 void mcview_set_byte (WView *view, off_t offset, byte b);
 void mcview_file_load_data (WView *view, off_t byte_index);
+void mcview_mmap_load_data (WView *view, off_t byte_index);
+void mcview_advise_access (WView *view, gboolean sequential);
 void mcview_close_datasource (WView *view);
 void mcview_set_datasource_file (WView *view, int fd, const struct stat *st);
+gboolean mcview_set_datasource_mmap (WView *view, int fd, const vfs_path_t *vpath,
+                                     const struct stat *st);
 gboolean mcview_load_command_output (WView *view, const char *command);
 void mcview_set_datasource_vfs_pipe (WView *view, int fd);
 void mcview_set_datasource_string (WView *view, const char *s);
@@ -275,6 +294,7 @@ off_t mcview_growbuf_filesize (WView *view);
 void mcview_growbuf_read_until (WView *view, off_t ofs);
 gboolean mcview_get_byte_growing_buffer (WView *view, off_t byte_index, int *retval);
 char *mcview_get_ptr_growing_buffer (WView *view, off_t byte_index);
+char *mcview_get_block_growing_buffer (WView *view, off_t byte_index, size_t *len);
 
 /* hex.c: */
 void mcview_display_hex (WView *view);
@@ -328,6 +348,8 @@ gboolean mcview_search_init (WView *view);
 void mcview_search_deinit (WView *view);
 mc_search_cbret_t mcview_search_cmd_callback (const void *user_data, off_t char_offset,
                                               int *current_char);
+mc_search_cbret_t mcview_search_block_cmd_callback (const void *user_data, off_t offset,
+                                                    const char **block, gsize *block_len);
 mc_search_cbret_t mcview_search_update_cmd_callback (const void *user_data, off_t char_offset);
 void mcview_search (WView *view, gboolean start_search);
 
@@ -391,6 +413,30 @@ mcview_get_byte_file (WView *view, off_t byte_index, int *retval)
 
 /* --------------------------------------------------------------------------------------------- */
 
+static inline gboolean
+mcview_get_byte_mmap (WView *view, off_t byte_index, int *retval)
+{
+    g_assert (view->datasource == DS_MMAP);
+
+    if (view->ds_mmap_truncated)
+        mcview_update_filesize (view);
+
+    // the whole file is usually mapped, so the window is loaded only if file is huge
+    if (!mcview_already_loaded (view->ds_mmap_offset, byte_index, view->ds_mmap_datalen))
+        mcview_mmap_load_data (view, byte_index);
+    if (mcview_already_loaded (view->ds_mmap_offset, byte_index, view->ds_mmap_datalen))
+    {
+        if (retval)
+            *retval = view->ds_mmap_data[byte_index - view->ds_mmap_offset];
+        return TRUE;
+    }
+    if (retval)
+        *retval = -1;
+    return FALSE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 static inline gboolean
 mcview_get_byte (WView *view, off_t offset, int *retval)
 {
@@ -401,6 +447,8 @@ mcview_get_byte (WView *view, off_t offset, int *retval)
         return mcview_get_byte_growing_buffer (view, offset, retval);
     case DS_FILE:
         return mcview_get_byte_file (view, offset, retval);
+    case DS_MMAP:
+        return mcview_get_byte_mmap (view, offset, retval);
     case DS_STRING:
         return mcview_get_byte_string (view, offset, retval);
     case DS_NONE:
@@ -62,6 +62,9 @@ gboolean mcview_remember_file_position = FALSE;
 /* Maxlimit for skipping updates */
 int mcview_max_dirt_limit = 10;
 
+/* Size of the cache of the file that can't be mapped into memory, in KiB */
+int mcview_file_cache_size = 1024;
+
 /* Scrolling is done in pages or line increments */
 gboolean mcview_mouse_move_pages = TRUE;
 
@@ -378,6 +381,8 @@ mcview_load (WView *view, const char *command, const char *file, int start_line,
         }
         else
         {
+            gboolean decompressed = FALSE;
+
             if (view->mode_flags.magic)
             {
                 int type;
@@ -406,11 +411,13 @@ mcview_load (WView *view, const char *command, const char *file, int start_line,
                         mc_close (fd);
                         fd = fd1;
                         mc_fstat (fd, &st);
+                        decompressed = TRUE;
                     }
                 }
             }
 
-            mcview_set_datasource_file (view, fd, &st);
+            if (decompressed || !mcview_set_datasource_mmap (view, fd, vpath, &st))
+                mcview_set_datasource_file (view, fd, &st);
         }
         retval = TRUE;
     }
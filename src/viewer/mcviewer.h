@@ -32,6 +32,7 @@ extern mcview_mode_flags_t mcview_altered_flags;
 
 extern gboolean mcview_remember_file_position;
 extern int mcview_max_dirt_limit;
+extern int mcview_file_cache_size;
 
 extern gboolean mcview_mouse_move_pages;
 extern char *mcview_show_eof;
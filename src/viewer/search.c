@@ -159,6 +159,9 @@ mcview_find (mcview_search_status_msg_t *ssm, off_t search_start, off_t search_e
     view->search_numNeedSkipChar = 0;
     search_cb_char_curr_index = -1;
 
+    // nroff sequences are decoded byte by byte
+    view->search->block_fn = view->mode_flags.nroff ? NULL : mcview_search_block_cmd_callback;
+
     if (mcview_search_options.backwards)
     {
         search_end = mcview_get_filesize (view);
@@ -291,6 +294,8 @@ mcview_do_search (WView *view, off_t want_search_start)
     status_msg_init (STATUS_MSG (&vsm), _ ("Search"), 1.0, simple_status_msg_init_cb,
                      mcview_search_status_update_cb, NULL);
 
+    mcview_advise_access (view, !mcview_search_options.backwards);
+
     do
     {
         off_t growbufsize;
@@ -327,6 +332,8 @@ mcview_do_search (WView *view, off_t want_search_start)
         found = TRUE;
     }
 
+    mcview_advise_access (view, FALSE);
+
     status_msg_deinit (STATUS_MSG (&vsm));
 
     if (orig_search_start != 0 && (!found && view->search->error == MC_SEARCH_E_NOTFOUND)
@@ -473,6 +480,21 @@ mcview_search_cmd_callback (const void *user_data, off_t char_offset, int *curre
 
 /* --------------------------------------------------------------------------------------------- */
 
+mc_search_cbret_t
+mcview_search_block_cmd_callback (const void *user_data, off_t offset, const char **block,
+                                  gsize *block_len)
+{
+    WView *view = ((const mcview_search_status_msg_t *) user_data)->view;
+    size_t len = 0;
+
+    *block = mcview_get_block (view, offset, &len);
+    *block_len = len;
+
+    return (*block != NULL) ? MC_SEARCH_CB_OK : MC_SEARCH_CB_NOTFOUND;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
 mc_search_cbret_t
 mcview_search_update_cmd_callback (const void *user_data, off_t char_offset)
 {
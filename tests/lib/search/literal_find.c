@@ -0,0 +1,273 @@
+/*
+   libmc - checks for literal (plain string) search
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "lib/search/literal"
+
+#include "tests/mctest.h"
+
+#include "lib/strutil.h"
+#include "lib/search.h"
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* return data by blocks of 2 bytes to check matches across block boundaries */
+static mc_search_cbret_t
+block_callback (const void *user_data, off_t offset, const char **block, gsize *block_len)
+{
+    const char *str = (const char *) user_data;
+    const gsize len = strlen (str);
+
+    if (offset >= (off_t) len)
+        return MC_SEARCH_CB_NOTFOUND;
+
+    *block = str + offset;
+    *block_len = MIN (2, len - (gsize) offset);
+
+    return MC_SEARCH_CB_OK;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    str_init_strings ("UTF-8");
+    mc_global.utf8_display = TRUE;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    str_uninit_strings ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_literal_find_ds") */
+static const struct test_literal_find_ds
+{
+    const char *pattern;
+    const char *input_value;
+    gboolean is_case_sensitive;
+    gboolean whole_words;
+    gboolean expected_result;
+    off_t expected_offset;
+    gsize expected_len;
+} test_literal_find_ds[] = {
+    {
+        // 0. simple match
+        "foo",
+        "a foo b",
+        TRUE,
+        FALSE,
+        TRUE,
+        2,
+        3,
+    },
+    {
+        // 1. case mismatch
+        "FOO",
+        "a foo b",
+        TRUE,
+        FALSE,
+        FALSE,
+        0,
+        0,
+    },
+    {
+        // 2. ASCII case folding
+        "FOO",
+        "a fOo b",
+        FALSE,
+        FALSE,
+        TRUE,
+        2,
+        3,
+    },
+    {
+        // 3. regex special characters are matched as is
+        "a.b",
+        "axb a.b",
+        TRUE,
+        FALSE,
+        TRUE,
+        4,
+        3,
+    },
+    {
+        // 4. whole words
+        "foo",
+        "foobar _foo foo",
+        TRUE,
+        TRUE,
+        TRUE,
+        12,
+        3,
+    },
+    {
+        // 5. whole words: non-ASCII letters are word characters
+        "foo",
+        "\xc3\xa9"
+        "foo",
+        TRUE,
+        TRUE,
+        FALSE,
+        0,
+        0,
+    },
+    {
+        // 6. UTF-8 case folding
+        "\xc3\x84\xc3\x96",  // "ÄÖ"
+        "x\xc3\xa4\xc3\xb6y",  // "xäöy"
+        FALSE,
+        FALSE,
+        TRUE,
+        1,
+        4,
+    },
+    {
+        // 7. Horspool shifts: partial matches of the pattern
+        "abcab",
+        "abcaabcabcab",
+        TRUE,
+        FALSE,
+        TRUE,
+        4,
+        5,
+    },
+    {
+        // 8. pattern longer than text
+        "abcdef",
+        "abc",
+        FALSE,
+        FALSE,
+        FALSE,
+        0,
+        0,
+    },
+    {
+        // 9. UTF-8 case folding: multi-byte KELVIN SIGN folds to the first 'k' of pattern
+        "k\xc3\xb6",  // "kö"
+        "x\xe2\x84\xaa\xc3\x96y",  // "xKÖy" with KELVIN SIGN
+        FALSE,
+        FALSE,
+        TRUE,
+        1,
+        5,
+    },
+    {
+        // 10. UTF-8 case folding: 's' folds to the first LATIN SMALL LETTER LONG S of pattern
+        "\xc5\xbf\xc3\xb6",  // "ſö"
+        "xs\xc3\x96y",  // "xsÖy"
+        FALSE,
+        FALSE,
+        TRUE,
+        1,
+        3,
+    },
+};
+
+/* @Test(dataSource = "test_literal_find_ds") */
+START_PARAMETRIZED_TEST (test_literal_find, test_literal_find_ds)
+{
+    // given
+    mc_search_t *s;
+    gboolean actual_result;
+    gsize actual_len = 0;
+
+    s = mc_search_new (data->pattern, "UTF-8");
+    s->search_type = MC_SEARCH_T_NORMAL;
+    s->is_case_sensitive = data->is_case_sensitive;
+    s->whole_words = data->whole_words;
+
+    // when
+    actual_result =
+        mc_search_run (s, data->input_value, 0, strlen (data->input_value), &actual_len);
+
+    // then
+    ck_assert_int_eq (actual_result, data->expected_result);
+    if (actual_result)
+    {
+        ck_assert_int_eq (s->normal_offset, data->expected_offset);
+        ck_assert_int_eq (actual_len, data->expected_len);
+    }
+
+    mc_search_free (s);
+}
+END_PARAMETRIZED_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Test(dataSource = "test_literal_find_ds") */
+START_PARAMETRIZED_TEST (test_literal_find_blocks, test_literal_find_ds)
+{
+    // given
+    mc_search_t *s;
+    gboolean actual_result;
+    gsize actual_len = 0;
+
+    s = mc_search_new (data->pattern, "UTF-8");
+    s->search_type = MC_SEARCH_T_NORMAL;
+    s->is_case_sensitive = data->is_case_sensitive;
+    s->whole_words = data->whole_words;
+    s->block_fn = block_callback;
+
+    // when
+    actual_result =
+        mc_search_run (s, data->input_value, 0, strlen (data->input_value) - 1, &actual_len);
+
+    // then
+    ck_assert_int_eq (actual_result, data->expected_result);
+    if (actual_result)
+    {
+        ck_assert_int_eq (s->normal_offset, data->expected_offset);
+        ck_assert_int_eq (actual_len, data->expected_len);
+    }
+
+    mc_search_free (s);
+}
+END_PARAMETRIZED_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    TCase *tc_core;
+
+    tc_core = tcase_create ("Core");
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    // Add new tests here: ***************
+    mctest_add_parameterized_test (tc_core, test_literal_find, test_literal_find_ds);
+    mctest_add_parameterized_test (tc_core, test_literal_find_blocks, test_literal_find_ds);
+    // ***********************************
+
+    return mctest_run_all (tc_core);
+}
+
+/* --------------------------------------------------------------------------------------------- */
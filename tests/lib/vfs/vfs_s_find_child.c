@@ -0,0 +1,175 @@
+/*
+   lib/vfs - test vfs_s_find_child() function
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/lib/vfs"
+
+#include "tests/mctest.h"
+
+#include "lib/vfs/xdirentry.h"
+
+static struct vfs_s_subclass test_subclass;
+static struct vfs_class *vfs_test_ops = VFS_CLASS (&test_subclass);
+
+static struct vfs_s_super super;
+static struct vfs_s_inode *root;
+
+/* --------------------------------------------------------------------------------------------- */
+
+static struct vfs_s_entry *
+add_child (const char *name)
+{
+    struct vfs_s_entry *ent;
+
+    ent = vfs_s_new_entry (vfs_test_ops, name, vfs_s_new_inode (vfs_test_ops, &super, NULL));
+    vfs_s_insert_entry (vfs_test_ops, root, ent);
+
+    return ent;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    vfs_init_subclass (&test_subclass, "testfs", VFSF_UNKNOWN, "test");
+
+    memset (&super, 0, sizeof (super));
+    super.me = vfs_test_ops;
+    root = vfs_s_new_inode (vfs_test_ops, &super, NULL);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    vfs_s_free_inode (vfs_test_ops, root);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_vfs_s_find_child_ds") */
+static const struct test_vfs_s_find_child_ds
+{
+    int count;
+} test_vfs_s_find_child_ds[] = {
+    {
+        // 0. small directory is searched linearly
+        10,
+    },
+    {
+        // 1. large directory is indexed
+        1000,
+    },
+};
+
+/* @Test(dataSource = "test_vfs_s_find_child_ds") */
+START_PARAMETRIZED_TEST (test_vfs_s_find_child, test_vfs_s_find_child_ds)
+{
+    // given
+    struct vfs_s_entry **entries;
+    int i;
+
+    entries = g_new (struct vfs_s_entry *, data->count);
+    for (i = 0; i < data->count; i++)
+    {
+        char name[32];
+
+        g_snprintf (name, sizeof (name), "file%d", i);
+        entries[i] = add_child (name);
+    }
+
+    // when
+    for (i = 0; i < data->count; i += 2)
+        vfs_s_free_entry (vfs_test_ops, entries[i]);
+
+    // then
+    for (i = 0; i < data->count; i++)
+    {
+        char name[32];
+
+        g_snprintf (name, sizeof (name), "file%d", i);
+        if (i % 2 == 0)
+            ck_assert_ptr_null (vfs_s_find_child (root, name));
+        else
+            ck_assert_ptr_eq (vfs_s_find_child (root, name), entries[i]);
+    }
+    ck_assert_ptr_null (vfs_s_find_child (root, "file"));
+
+    g_free (entries);
+}
+END_PARAMETRIZED_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* Entries with the same name: the first one is found */
+START_TEST (test_vfs_s_find_child_duplicates)
+{
+    // given
+    struct vfs_s_entry *first, *second;
+    int i;
+
+    for (i = 0; i < 100; i++)
+    {
+        char name[32];
+
+        g_snprintf (name, sizeof (name), "file%d", i);
+        add_child (name);
+    }
+
+    first = add_child ("dup");
+    second = add_child ("dup");
+
+    // when
+    ck_assert_ptr_eq (vfs_s_find_child (root, "dup"), first);
+    vfs_s_free_entry (vfs_test_ops, first);
+
+    // then
+    ck_assert_ptr_eq (vfs_s_find_child (root, "dup"), second);
+    vfs_s_free_entry (vfs_test_ops, second);
+    ck_assert_ptr_null (vfs_s_find_child (root, "dup"));
+    ck_assert_ptr_nonnull (vfs_s_find_child (root, "file99"));
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    TCase *tc_core;
+
+    tc_core = tcase_create ("Core");
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    // Add new tests here: ***************
+    mctest_add_parameterized_test (tc_core, test_vfs_s_find_child, test_vfs_s_find_child_ds);
+    tcase_add_test (tc_core, test_vfs_s_find_child_duplicates);
+    // ***********************************
+
+    return mctest_run_all (tc_core);
+}
+
+/* --------------------------------------------------------------------------------------------- */
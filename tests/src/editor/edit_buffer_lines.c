@@ -0,0 +1,247 @@
+/*
+   src/editor - tests for line index of editor buffer
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/editor"
+
+#include "tests/mctest.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "lib/strutil.h"
+#include "lib/vfs/vfs.h"
+#include "lib/widget.h"  // simple_status_msg_t
+
+#include "src/vfs/local/local.h"
+
+#include "src/editor/editbuffer.h"
+
+/* all lines have the same length to calculate line offsets easily */
+#define LINE_LEN   10
+#define LINE_COUNT 20000
+
+/* lines of the file have different lengths: line N has N % FILE_LINE_MOD characters */
+#define FILE_LINE_MOD   97
+#define FILE_LINE_COUNT 30000
+
+static edit_buffer_t buf;
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    long i;
+
+    edit_buffer_init (&buf, 0);
+
+    // the text spans several buffers
+    for (i = 0; i < LINE_COUNT; i++)
+    {
+        char line[LINE_LEN + 1];
+        int j;
+
+        g_snprintf (line, sizeof (line), "%09ld\n", i);
+        for (j = 0; j < LINE_LEN; j++)
+            edit_buffer_insert (&buf, line[j]);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    edit_buffer_clean (&buf);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_edit_buffer_lines_ds") */
+static const struct test_edit_buffer_lines_ds
+{
+    off_t cursor;
+    off_t current;
+    long lines;
+    off_t expected_forward;
+    off_t expected_backward;
+} test_edit_buffer_lines_ds[] = {
+    {
+        // 0. cursor at the end, move from the beginning of line
+        LINE_COUNT * LINE_LEN,
+        100 * LINE_LEN,
+        1000,
+        1100 * LINE_LEN,
+        0,
+    },
+    {
+        // 1. cursor at the beginning, move from the middle of line
+        0,
+        15000 * LINE_LEN + 5,
+        2000,
+        17000 * LINE_LEN,
+        13000 * LINE_LEN,
+    },
+    {
+        // 2. cursor in the middle, move across the cursor
+        10000 * LINE_LEN + 3,
+        7000 * LINE_LEN,
+        6000,
+        13000 * LINE_LEN,
+        1000 * LINE_LEN,
+    },
+    {
+        // 3. move beyond the end of text
+        12345,
+        19000 * LINE_LEN,
+        5000,
+        LINE_COUNT * LINE_LEN,
+        14000 * LINE_LEN,
+    },
+};
+
+/* @Test(dataSource = "test_edit_buffer_lines_ds") */
+START_PARAMETRIZED_TEST (test_edit_buffer_lines, test_edit_buffer_lines_ds)
+{
+    // given
+    off_t actual_forward, actual_backward;
+    long actual_count;
+
+    while (buf.curs1 > data->cursor)
+        edit_buffer_insert_ahead (&buf, edit_buffer_backspace (&buf));
+
+    // when
+    actual_forward = edit_buffer_get_forward_offset (&buf, data->current, data->lines, 0);
+    actual_backward = edit_buffer_get_backward_offset (&buf, data->current, data->lines);
+    actual_count = edit_buffer_count_lines (&buf, 0, data->current);
+
+    // then
+    ck_assert_int_eq (actual_forward, data->expected_forward);
+    ck_assert_int_eq (actual_backward, data->expected_backward);
+    ck_assert_int_eq (actual_count, data->current / LINE_LEN);
+}
+END_PARAMETRIZED_TEST
+
+/* @DataSource("test_edit_buffer_read_file_ds") */
+static const struct test_edit_buffer_read_file_ds
+{
+    long line;
+} test_edit_buffer_read_file_ds[] = {
+    { 0 },                    // 0. the first line
+    { 1 },                    // 1. the second line
+    { 1337 },                 // 2. a line inside of the first buffer
+    { 12345 },                // 3. a line in the middle of the file
+    { FILE_LINE_COUNT - 1 },  // 4. the last complete line
+    { FILE_LINE_COUNT },      // 5. the last line without newline
+};
+
+/* @Test(dataSource = "test_edit_buffer_read_file_ds") */
+START_PARAMETRIZED_TEST (test_edit_buffer_read_file, test_edit_buffer_read_file_ds)
+{
+    // given
+    char name[] = "edit_buffer_lines_XXXXXX";
+    edit_buffer_t file_buf;
+    off_t *offsets;
+    GString *text;
+    vfs_path_t *vpath;
+    int fd;
+    long i;
+    off_t size, actual_forward, actual_backward;
+    long actual_count;
+    gboolean aborted;
+
+    str_init_strings (NULL);
+    vfs_init ();
+    vfs_init_localfs ();
+    vfs_setup_work_dir ();
+
+    offsets = g_new (off_t, FILE_LINE_COUNT + 1);
+    text = g_string_new ("");
+    for (i = 0; i < FILE_LINE_COUNT; i++)
+    {
+        offsets[i] = (off_t) text->len;
+        g_string_append_printf (text, "%.*s\n", (int) (i % FILE_LINE_MOD),
+                                "abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyz"
+                                "abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvwxyz");
+    }
+    offsets[i] = (off_t) text->len;
+    g_string_append (text, "tail");
+
+    fd = g_mkstemp (name);
+    ck_assert_int_ne (fd, -1);
+    ck_assert_int_eq (write (fd, text->str, text->len), text->len);
+    close (fd);
+
+    vpath = vfs_path_from_str (name);
+    fd = mc_open (vpath, O_RDONLY);
+    ck_assert_int_ne (fd, -1);
+    size = (off_t) text->len;
+
+    edit_buffer_init (&file_buf, size);
+
+    // when
+    ck_assert_int_eq (edit_buffer_read_file (&file_buf, fd, size, NULL, &aborted), size);
+    actual_forward = edit_buffer_get_forward_offset (&file_buf, 0, data->line, 0);
+    actual_backward =
+        edit_buffer_get_backward_offset (&file_buf, size, FILE_LINE_COUNT - data->line);
+    actual_count = edit_buffer_count_lines (&file_buf, 0, offsets[data->line]);
+
+    // then
+    ck_assert_int_eq (file_buf.lines, FILE_LINE_COUNT);
+    ck_assert_int_eq (actual_forward, offsets[data->line]);
+    ck_assert_int_eq (actual_backward, offsets[data->line]);
+    ck_assert_int_eq (actual_count, data->line);
+
+    mc_close (fd);
+    unlink (name);
+    vfs_path_free (vpath, TRUE);
+    edit_buffer_clean (&file_buf);
+    g_string_free (text, TRUE);
+    g_free (offsets);
+    vfs_shut ();
+    str_uninit_strings ();
+}
+END_PARAMETRIZED_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    TCase *tc_core;
+
+    tc_core = tcase_create ("Core");
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    // Add new tests here: ***************
+    mctest_add_parameterized_test (tc_core, test_edit_buffer_lines, test_edit_buffer_lines_ds);
+    mctest_add_parameterized_test (tc_core, test_edit_buffer_read_file,
+                                   test_edit_buffer_read_file_ds);
+    // ***********************************
+
+    return mctest_run_all (tc_core);
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -353,6 +353,108 @@ END_PARAMETRIZED_TEST
 
 /* --------------------------------------------------------------------------------------------- */
 
+/* Words typed after the first completion are completed too */
+START_TEST (test_autocomplete_after_edit)
+{
+    // given
+    static const char inserted[] = "\xD1\x8D\xD1\x8Axyz\n";  // эъxyz
+    const char *p;
+
+    mc_global.source_codepage = 1;
+    mc_global.display_codepage = 1;
+    cp_source = "UTF-8";
+    cp_display = "UTF-8";
+
+    do_set_codepage (0);
+    edit_set_codeset (test_edit);
+
+    edit_cursor_move (test_edit, 102);
+    edit_complete_word_cmd (test_edit);
+    ck_assert_int_eq (g_queue_get_length (edit_completion_dialog_show__compl), 2);
+    edit_completion_dialog_show__deinit ();
+    edit_completion_dialog_show__init ();
+
+    // when
+    edit_cursor_move (test_edit, -102);
+    for (p = inserted; *p != '\0'; p++)
+        edit_insert (test_edit, (unsigned char) *p);
+    edit_cursor_move (test_edit, 102);
+    edit_complete_word_cmd (test_edit);
+
+    // then
+    ck_assert_int_eq (g_queue_get_length (edit_completion_dialog_show__compl), 3);
+    // word at the beginning of file is the farthest one
+    mctest_assert_str_eq (((GString *) g_queue_peek_tail (edit_completion_dialog_show__compl))->str,
+                          "\xD1\x8D\xD1\x8Axyz");
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_autocomplete_entire_file_ds") */
+static const struct test_autocomplete_entire_file_ds
+{
+    gboolean input_entire_file;
+
+    guint expected_compl_word_count;
+    const char *expected_compl_words[3];
+} test_autocomplete_entire_file_ds[] = {
+    {
+        // 0. words after the cursor are not collected
+        FALSE,
+
+        2,
+        { "эъфывапр", "эъйцукен", NULL },
+    },
+    {
+        // 1. words after the cursor are collected, nearest word first
+        TRUE,
+
+        3,
+        { "эъфывапр", "эъzzz", "эъйцукен" },
+    },
+};
+
+/* @Test(dataSource = "test_autocomplete_entire_file_ds") */
+START_PARAMETRIZED_TEST (test_autocomplete_entire_file, test_autocomplete_entire_file_ds)
+{
+    // given
+    static const char inserted[] = "эъzzz\n";
+    const char *p;
+    guint i;
+
+    mc_config_set_bool (mc_global.main_config, CONFIG_APP_SECTION,
+                        "editor_wordcompletion_collect_entire_file", data->input_entire_file);
+
+    mc_global.source_codepage = 1;
+    mc_global.display_codepage = 1;
+    cp_source = "UTF-8";
+    cp_display = "UTF-8";
+
+    do_set_codepage (0);
+    edit_set_codeset (test_edit);
+
+    // insert word after the cursor
+    edit_cursor_move (test_edit, 103);
+    for (p = inserted; *p != '\0'; p++)
+        edit_insert (test_edit, (unsigned char) *p);
+
+    // when
+    edit_cursor_move (test_edit, -(off_t) (sizeof (inserted) - 1) - 1);
+    edit_complete_word_cmd (test_edit);
+
+    // then
+    ck_assert_int_eq (g_queue_get_length (edit_completion_dialog_show__compl),
+                      data->expected_compl_word_count);
+    for (i = 0; i < data->expected_compl_word_count; i++)
+        mctest_assert_str_eq (
+            ((GString *) g_queue_peek_nth (edit_completion_dialog_show__compl, i))->str,
+            data->expected_compl_words[i]);
+}
+END_PARAMETRIZED_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
 int
 main (void)
 {
@@ -365,6 +467,9 @@ main (void)
     // Add new tests here: ***************
     mctest_add_parameterized_test (tc_core, test_autocomplete, test_autocomplete_ds);
     mctest_add_parameterized_test (tc_core, test_autocomplete_single, test_autocomplete_single_ds);
+    tcase_add_test (tc_core, test_autocomplete_after_edit);
+    mctest_add_parameterized_test (tc_core, test_autocomplete_entire_file,
+                                   test_autocomplete_entire_file_ds);
     // ***********************************
 
     return mctest_run_all (tc_core);
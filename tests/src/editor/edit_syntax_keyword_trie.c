@@ -0,0 +1,225 @@
+/*
+   src/editor - tests for keyword trie of syntax highlighting
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/editor"
+
+#include "tests/mctest.h"
+
+#include "src/editor/syntax.c"
+
+static WEdit *test_edit;
+
+/* --------------------------------------------------------------------------------------------- */
+/* @Mock */
+int
+tty_try_alloc_color_pair (const tty_color_pair_t *color, gboolean is_temp)
+{
+    static int pair = 0;
+
+    (void) color;
+    (void) is_temp;
+
+    // every keyword gets its own color
+    return ++pair;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/* @Mock */
+void
+tty_color_free_temp (void)
+{
+}
+
+/* --------------------------------------------------------------------------------------------- */
+/**
+ * Make keyword list which tries all keywords of context one by one in order of definition,
+ * as highlighting did before keywords were indexed in trie.
+ */
+
+static syntax_trie_t *
+test_linear_trie_new (const GPtrArray *keywords)
+{
+    syntax_trie_t *t;
+    int *link;
+    guint j;
+
+    t = g_new (syntax_trie_t, 1);
+    memset (t->first, -1, sizeof (t->first));
+    t->nodes = g_array_new (FALSE, FALSE, sizeof (syntax_trie_node_t));
+    t->next = g_new0 (int, keywords->len);
+    t->wild = 0;
+
+    link = &t->wild;
+    for (j = 1; j < keywords->len; j++)
+    {
+        // empty keyword ends the list of keywords
+        if (SYNTAX_KEYWORD (g_ptr_array_index (keywords, j))->keyword->len == 0)
+            break;
+
+        *link = (int) j;
+        link = &t->next[j];
+    }
+
+    return t;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    // don't read skin to get default colors
+    mc_global.tty.ugly_line_drawing = TRUE;
+
+    test_edit = g_new0 (WEdit, 1);
+    edit_buffer_init (&test_edit->buffer, 0);
+    test_edit->syntax_changed = -1;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    edit_free_syntax_rules (test_edit);
+    edit_buffer_clean (&test_edit->buffer);
+    g_free (test_edit);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_keyword_trie_ds") */
+static const struct test_keyword_trie_ds
+{
+    const char *syntax_file;
+    const char *text_file;
+} test_keyword_trie_ds[] = {
+    {
+        // 0. keywords with wildcards and defines
+        "misc/syntax/c.syntax",
+        "src/editor/syntax.c",
+    },
+    {
+        // 1. hundreds of keywords per context
+        "misc/syntax/sh.syntax",
+        "misc/ext.d/archive.sh",
+    },
+};
+
+/* @Test(dataSource = "test_keyword_trie_ds") */
+START_PARAMETRIZED_TEST (test_keyword_trie, test_keyword_trie_ds)
+{
+    // given
+    char *path;
+    char *text;
+    gsize len, i;
+    FILE *f;
+    char *args[ARGS_LEN];
+    edit_syntax_rule_t *rules;
+    int *colors;
+    gboolean ok;
+    int result;
+
+    path = g_build_filename (TEST_TOP_SRCDIR, data->text_file, (char *) NULL);
+    ok = g_file_get_contents (path, &text, &len, NULL);
+    g_free (path);
+    ck_assert_msg (ok, "cannot read %s", data->text_file);
+
+    for (i = 0; i < len; i++)
+        edit_buffer_insert (&test_edit->buffer, text[i]);
+    g_free (text);
+
+    path = g_build_filename (TEST_TOP_SRCDIR, data->syntax_file, (char *) NULL);
+    f = fopen (path, "r");
+    g_free (path);
+    ck_assert_msg (f != NULL, "cannot open %s", data->syntax_file);
+    result = edit_read_syntax_rules (test_edit, f, args, ARGS_LEN - 1);
+    fclose (f);
+    ck_assert_int_eq (result, 0);
+
+    // highlight the text with keyword tries
+    rules = g_new (edit_syntax_rule_t, len);
+    colors = g_new (int, len);
+
+    edit_get_rule (test_edit, -1);
+    for (i = 0; i < len; i++)
+    {
+        edit_get_rule (test_edit, (off_t) i);
+        rules[i] = test_edit->rule;
+        colors[i] = translate_rule_to_color (test_edit, &test_edit->rule);
+    }
+
+    // when
+    for (i = 0; i < test_edit->rules->len; i++)
+    {
+        context_rule_t *c = CONTEXT_RULE (g_ptr_array_index (test_edit->rules, i));
+
+        if (c->keyword_trie != NULL)
+        {
+            syntax_trie_free (c->keyword_trie);
+            c->keyword_trie = test_linear_trie_new (c->keyword);
+        }
+    }
+
+    // forget saved states to highlight the text from the beginning
+    g_array_set_size (test_edit->syntax_marker, 0);
+    edit_get_rule (test_edit, -1);
+
+    // then
+    for (i = 0; i < len; i++)
+    {
+        const edit_syntax_rule_t *r = &test_edit->rule;
+
+        edit_get_rule (test_edit, (off_t) i);
+        ck_assert_msg (r->context == rules[i].context && r->_context == rules[i]._context
+                           && r->keyword == rules[i].keyword && r->end == rules[i].end
+                           && r->border == rules[i].border,
+                       "rule differs at offset %" G_GSIZE_FORMAT, i);
+        ck_assert_int_eq (translate_rule_to_color (test_edit, r), colors[i]);
+    }
+
+    g_free (rules);
+    g_free (colors);
+}
+END_PARAMETRIZED_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    TCase *tc_core;
+
+    tc_core = tcase_create ("Core");
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    // Add new tests here: ***************
+    mctest_add_parameterized_test (tc_core, test_keyword_trie, test_keyword_trie_ds);
+    // ***********************************
+
+    return mctest_run_all (tc_core);
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,223 @@
+/*
+   src/editor - tests for undo stack of editor
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/editor"
+
+#include "tests/mctest.h"
+
+#include "src/editor/edit-impl.h"
+#include "src/editor/editundo.h"
+
+#define UNLIMITED (1024 * 1024 * 1024)
+
+static edit_undo_stack_t stack;
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    edit_undo_stack_init (&stack);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    edit_undo_stack_clean (&stack);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* Actions are popped in reverse order, repeated key presses are merged */
+START_TEST (test_edit_undo_stack_order)
+{
+    // given
+    static const long pushed[] = {
+        KEY_PRESS + 10, MARK_1 + 5, 'a', 'b', 'b', 'b', 256 + 'c', KEY_PRESS + 10, KEY_PRESS + 10,
+        BACKSPACE,      BACKSPACE,  BACKSPACE, CURS_LEFT, MARK_2 - 1, MARK_CURS + 1234567, 255,
+        511,            KEY_PRESS,  KEY_PRESS + 123456789012L,
+    };
+    static const long expected[] = {
+        KEY_PRESS + 123456789012L,
+        KEY_PRESS,
+        511,
+        255,
+        MARK_CURS + 1234567,
+        MARK_2 - 1,
+        CURS_LEFT,
+        BACKSPACE,
+        BACKSPACE,
+        BACKSPACE,
+        KEY_PRESS + 10,
+        256 + 'c',
+        'b',
+        'b',
+        'b',
+        'a',
+        MARK_1 + 5,
+        KEY_PRESS + 10,
+        STACK_BOTTOM,
+    };
+    size_t i;
+
+    // when
+    for (i = 0; i < G_N_ELEMENTS (pushed); i++)
+        edit_undo_stack_push (&stack, pushed[i], UNLIMITED);
+
+    // then
+    for (i = 0; i < G_N_ELEMENTS (expected); i++)
+    {
+        ck_assert_int_eq (edit_undo_stack_get_top (&stack), expected[i]);
+        ck_assert_int_eq (edit_undo_stack_pop (&stack), expected[i]);
+    }
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* Actions without preceding key press are not recorded */
+START_TEST (test_edit_undo_stack_no_key_press)
+{
+    // when
+    edit_undo_stack_push (&stack, 'a', UNLIMITED);
+    edit_undo_stack_push (&stack, CURS_RIGHT, UNLIMITED);
+
+    // then
+    ck_assert_int_eq (edit_undo_stack_pop (&stack), STACK_BOTTOM);
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* Deleted text takes about one byte per byte, inserted text is merged */
+START_TEST (test_edit_undo_stack_compact)
+{
+    // given
+    const long len = 100000;
+    long i;
+
+    // when
+    edit_undo_stack_push (&stack, KEY_PRESS, UNLIMITED);
+    for (i = 0; i < len; i++)
+        edit_undo_stack_push (&stack, 256 + 'a' + i % 26, UNLIMITED);
+    edit_undo_stack_push (&stack, KEY_PRESS + 1, UNLIMITED);
+    for (i = 0; i < len; i++)
+        edit_undo_stack_push (&stack, BACKSPACE, UNLIMITED);
+
+    // then
+    ck_assert_int_le ((stack.pointer - stack.bottom) & stack.size_mask, len + 16);
+    for (i = 0; i < len; i++)
+        ck_assert_int_eq (edit_undo_stack_pop (&stack), BACKSPACE);
+    ck_assert_int_eq (edit_undo_stack_pop (&stack), KEY_PRESS + 1);
+    for (i = len - 1; i >= 0; i--)
+        ck_assert_int_eq (edit_undo_stack_pop (&stack), 256 + 'a' + i % 26);
+    ck_assert_int_eq (edit_undo_stack_pop (&stack), KEY_PRESS);
+    ck_assert_int_eq (edit_undo_stack_pop (&stack), STACK_BOTTOM);
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* Full stack drops the oldest key presses */
+START_TEST (test_edit_undo_stack_limit)
+{
+    // given
+    const unsigned long max_size = 4096;
+    long k, last_key;
+    long c;
+
+    // when
+    for (k = 0; k < 1000; k++)
+    {
+        int j;
+
+        edit_undo_stack_push (&stack, KEY_PRESS + k, max_size);
+        for (j = 0; j < 20; j++)
+            edit_undo_stack_push (&stack, 256 + 'a' + j, max_size);
+    }
+
+    // then
+    ck_assert_int_le (stack.size, max_size);
+
+    last_key = 1000;
+    while ((c = edit_undo_stack_pop (&stack)) != STACK_BOTTOM)
+        if (c >= KEY_PRESS)
+        {
+            ck_assert_int_eq (c, KEY_PRESS + last_key - 1);
+            last_key--;
+        }
+
+    ck_assert_int_gt (last_key, 0);
+    ck_assert_int_lt (last_key, 1000);
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* Key press larger than the stack cannot be undone */
+START_TEST (test_edit_undo_stack_overflow)
+{
+    // given
+    const unsigned long max_size = 4096;
+    int i;
+
+    // when
+    edit_undo_stack_push (&stack, KEY_PRESS, max_size);
+    for (i = 0; i < 10000; i++)
+        edit_undo_stack_push (&stack, 256 + 'a' + i % 26, max_size);
+    edit_undo_stack_push (&stack, KEY_PRESS + 1, max_size);
+    edit_undo_stack_push (&stack, CURS_LEFT, max_size);
+
+    // then
+    ck_assert_int_eq (edit_undo_stack_pop (&stack), CURS_LEFT);
+    ck_assert_int_eq (edit_undo_stack_pop (&stack), KEY_PRESS + 1);
+    ck_assert_int_eq (edit_undo_stack_pop (&stack), STACK_BOTTOM);
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    TCase *tc_core;
+
+    tc_core = tcase_create ("Core");
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    // Add new tests here: ***************
+    tcase_add_test (tc_core, test_edit_undo_stack_order);
+    tcase_add_test (tc_core, test_edit_undo_stack_no_key_press);
+    tcase_add_test (tc_core, test_edit_undo_stack_compact);
+    tcase_add_test (tc_core, test_edit_undo_stack_limit);
+    tcase_add_test (tc_core, test_edit_undo_stack_overflow);
+    // ***********************************
+
+    return mctest_run_all (tc_core);
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,178 @@
+/*
+   src/editor - tests for lookup of definitions in index of TAGS file
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/editor"
+
+#include "tests/mctest.h"
+
+#include <unistd.h>
+
+#include "src/editor/etags.c"
+
+/* TAGS file: "pattern DEL [name SOH] line,offset" lines after "FF\nfile,size" headers */
+#define TEST_TAGS                                                                                  \
+    "\f\n"                                                                                         \
+    "src/first.c,120\n"                                                                            \
+    "static int first_helper (void)\x7f" "first_helper\x01" "12,200\n"                             \
+    "int common_func (int a)\x7f" "common_func\x01" "30,500\n"                                     \
+    "#define FIRST_MAX \x7f" "FIRST_MAX\x01" "5,60\n"                                              \
+    "\f\n"                                                                                         \
+    "src/second.cpp,200\n"                                                                         \
+    "void Widget::draw (void)\x7f" "Widget::draw\x01" "42,900\n"                                   \
+    "int common_func (int a, int b)\x7f" "common_func\x01" "77,1800\n"                             \
+    "void Canvas::draw (void)\x7f" "Canvas::draw\x01" "90,2100\n"
+
+static char *tagfile = NULL;
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    int fd;
+
+    fd = g_file_open_tmp ("mc-test-TAGS-XXXXXX", &tagfile, NULL);
+    ck_assert_int_ne (fd, -1);
+    close (fd);
+
+    ck_assert (g_file_set_contents (tagfile, TEST_TAGS, -1, NULL));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    etags_cache_free ();
+    unlink (tagfile);
+    g_free (tagfile);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_etags_lookup_ds") */
+static const struct test_etags_lookup_ds
+{
+    const char *name;
+    guint count;
+    const char *filename[2];
+    long line[2];
+} test_etags_lookup_ds[] = {
+    {
+        // 0. the only definition
+        "first_helper",
+        1,
+        { "src/first.c" },
+        { 12 },
+    },
+    {
+        // 1. definitions in several files in file order
+        "common_func",
+        2,
+        { "src/first.c", "src/second.cpp" },
+        { 30, 77 },
+    },
+    {
+        // 2. qualified name
+        "Widget::draw",
+        1,
+        { "src/second.cpp" },
+        { 42 },
+    },
+    {
+        // 3. unqualified name of several qualified ones, every line once
+        "draw",
+        2,
+        { "src/second.cpp", "src/second.cpp" },
+        { 42, 90 },
+    },
+    {
+        // 4. unknown name
+        "common",
+        0,
+        { NULL },
+        { 0 },
+    },
+};
+
+/* @Test(dataSource = "test_etags_lookup_ds") */
+START_PARAMETRIZED_TEST (test_etags_lookup, test_etags_lookup_ds)
+{
+    // given
+    GPtrArray *defs;
+    guint i;
+
+    // when
+    defs = etags_set_definition_hash (tagfile, "/prj", data->name);
+
+    // then
+    if (data->count == 0)
+    {
+        mctest_assert_null (defs);
+    }
+    else
+    {
+        mctest_assert_not_null (defs);
+        ck_assert_int_eq (defs->len, data->count);
+
+        for (i = 0; i < data->count; i++)
+        {
+            const etags_hash_t *def = (const etags_hash_t *) g_ptr_array_index (defs, i);
+            char *fullpath;
+
+            fullpath = g_strconcat ("/prj/", data->filename[i], (char *) NULL);
+            mctest_assert_str_eq (def->filename, data->filename[i]);
+            mctest_assert_str_eq (def->fullpath, fullpath);
+            ck_assert_int_eq (def->line, data->line[i]);
+            g_free (fullpath);
+        }
+
+        g_ptr_array_free (defs, TRUE);
+    }
+
+    // the index is reused by the next lookup
+    mctest_assert_not_null (etags_index);
+    mctest_assert_str_eq (etags_index->path, tagfile);
+}
+END_PARAMETRIZED_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    TCase *tc_core;
+
+    tc_core = tcase_create ("Core");
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    // Add new tests here: ***************
+    mctest_add_parameterized_test (tc_core, test_etags_lookup, test_etags_lookup_ds);
+    // ***********************************
+
+    return mctest_run_all (tc_core);
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,277 @@
+/*
+   src/filemanager - tests for concurrent copying of small local files
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/filemanager"
+
+#include "tests/mctest.h"
+
+#include <stdio.h>
+
+#include "lib/strutil.h"
+#include "lib/util.h"
+#include "src/vfs/local/local.h"
+
+#include "src/filemanager/copyqueue.c"
+
+#define TEST_FILES 40
+
+static char *test_dir = NULL;
+static file_op_context_t *test_ctx = NULL;
+static file_copy_queue_t *test_queue = NULL;
+
+/* --------------------------------------------------------------------------------------------- */
+
+static char *
+test_path (const char *prefix, int n)
+{
+    char name[32];
+
+    g_snprintf (name, sizeof (name), "%s%d", prefix, n);
+
+    return g_build_filename (test_dir, name, (char *) NULL);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+test_write_file (const char *prefix, int n, size_t size)
+{
+    char *path;
+    char *content;
+
+    path = test_path (prefix, n);
+    content = g_malloc (size);
+    memset (content, 'a' + n % 26, size);
+    ck_assert (g_file_set_contents (path, content, (gssize) size, NULL));
+    g_free (content);
+    g_free (path);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+test_push (int n)
+{
+    char *src, *dst;
+    vfs_path_t *src_vpath, *dst_vpath;
+
+    src = test_path ("src", n);
+    dst = test_path ("dst", n);
+    src_vpath = vfs_path_from_str (src);
+    dst_vpath = vfs_path_from_str (dst);
+
+    file_copy_queue_push (test_queue, src, src_vpath, dst, dst_vpath, n);
+
+    vfs_path_free (src_vpath, TRUE);
+    vfs_path_free (dst_vpath, TRUE);
+    g_free (src);
+    g_free (dst);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+test_check_copy (int n, size_t size)
+{
+    char *path;
+    char *content = NULL;
+    gsize len = 0;
+
+    path = test_path ("dst", n);
+    ck_assert (g_file_get_contents (path, &content, &len, NULL));
+    ck_assert_int_eq (len, size);
+    if (size != 0)
+        ck_assert_int_eq (content[0], 'a' + n % 26);
+    g_free (content);
+    g_free (path);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    str_init_strings (NULL);
+
+    vfs_init ();
+    vfs_init_localfs ();
+    vfs_setup_work_dir ();
+
+    test_dir = g_dir_make_tmp ("mc-test-copyqueue-XXXXXX", NULL);
+    mctest_assert_not_null (test_dir);
+
+    test_ctx = g_new0 (file_op_context_t, 1);
+    test_ctx->operation = OP_COPY;
+    test_ctx->preserve = TRUE;
+    test_ctx->umask_kill = (mode_t) (~0);
+
+    test_queue = file_copy_queue_new (test_ctx);
+    mctest_assert_not_null (test_queue);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    int i;
+
+    file_copy_queue_free (test_queue);
+    test_queue = NULL;
+    MC_PTR_FREE (test_ctx);
+
+    for (i = 0; i < TEST_FILES; i++)
+    {
+        char *path;
+
+        path = test_path ("src", i);
+        remove (path);
+        g_free (path);
+
+        path = test_path ("dst", i);
+        remove (path);
+        g_free (path);
+    }
+
+    g_rmdir (test_dir);
+    MC_PTR_FREE (test_dir);
+
+    vfs_shut ();
+    str_uninit_strings ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Test */
+START_TEST (test_copy_queue_order)
+{
+    // given
+    int i;
+
+    // first file is copied longer than the rest ones
+    test_write_file ("src", 0, FILE_COPY_QUEUE_MAX_SIZE);
+    for (i = 1; i < TEST_FILES; i++)
+        test_write_file ("src", i, (size_t) i);
+
+    // when
+    for (i = 0; i < TEST_FILES; i++)
+        test_push (i);
+
+    // then
+    ck_assert (file_copy_queue_is_full (test_queue));
+
+    // jobs are got in the order of pushing
+    for (i = 0; i < TEST_FILES; i++)
+    {
+        file_copy_job_t *job;
+
+        job = file_copy_queue_pop (test_queue, TRUE);
+        mctest_assert_not_null (job);
+        ck_assert_int_eq (job->entry, i);
+        ck_assert_int_eq (job->result, FILE_COPY_JOB_OK);
+        ck_assert_int_eq (job->size, i == 0 ? FILE_COPY_QUEUE_MAX_SIZE : i);
+        file_copy_job_free (job);
+
+        test_check_copy (i, i == 0 ? FILE_COPY_QUEUE_MAX_SIZE : (size_t) i);
+    }
+
+    mctest_assert_null (file_copy_queue_pop (test_queue, TRUE));
+    ck_assert (!file_copy_queue_is_full (test_queue));
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Test */
+START_TEST (test_copy_queue_fallback)
+{
+    // given
+    int i;
+
+    for (i = 0; i < 4; i++)
+        test_write_file ("src", i, 10);
+
+    // existing destination must not be overwritten
+    test_write_file ("dst", 1, 3);
+    // source is not found
+    {
+        char *path;
+
+        path = test_path ("src", 2);
+        ck_assert_int_eq (remove (path), 0);
+        g_free (path);
+    }
+
+    // when
+    for (i = 0; i < 4; i++)
+        test_push (i);
+
+    // then
+    // failed jobs are returned to the caller with their entries
+    for (i = 0; i < 4; i++)
+    {
+        file_copy_job_t *job;
+
+        job = file_copy_queue_pop (test_queue, TRUE);
+        mctest_assert_not_null (job);
+        ck_assert_int_eq (job->entry, i);
+        ck_assert_int_eq (job->result,
+                          i == 1 || i == 2 ? FILE_COPY_JOB_FALLBACK : FILE_COPY_JOB_OK);
+        file_copy_job_free (job);
+    }
+
+    test_check_copy (0, 10);
+    test_check_copy (1, 3);
+    test_check_copy (3, 10);
+
+    {
+        char *path;
+
+        path = test_path ("dst", 2);
+        ck_assert (!g_file_test (path, G_FILE_TEST_EXISTS));
+        g_free (path);
+    }
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    TCase *tc_core;
+
+    tc_core = tcase_create ("Core");
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    // Add new tests here: ***************
+    tcase_add_test (tc_core, test_copy_queue_order);
+    tcase_add_test (tc_core, test_copy_queue_fallback);
+    // ***********************************
+
+    return mctest_run_all (tc_core);
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,259 @@
+/*
+   src/filemanager - tests for update of directory list
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/filemanager"
+
+#include "tests/mctest.h"
+
+#include <unistd.h>
+
+#include "lib/strutil.h"
+#include "lib/util.h"
+#include "lib/vfs/vfs.h"
+#include "src/vfs/local/local.h"
+
+#include "src/filemanager/dir.h"
+
+#define TEST_ENTRIES_MAX 8
+
+static char *test_dir = NULL;
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+test_write_file (const char *name, const char *content)
+{
+    char *path;
+
+    path = g_build_filename (test_dir, name, (char *) NULL);
+    ck_assert (g_file_set_contents (path, content, -1, NULL));
+    g_free (path);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+test_remove_file (const char *name)
+{
+    char *path;
+
+    path = g_build_filename (test_dir, name, (char *) NULL);
+    remove (path);
+    g_free (path);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static file_entry_t *
+test_find_entry (dir_list *list, const char *name)
+{
+    int i;
+
+    for (i = 0; i < list->len; i++)
+        if (strcmp (list->list[i].fname->str, name) == 0)
+            return &list->list[i];
+
+    return NULL;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    vfs_path_t *vpath;
+
+    str_init_strings (NULL);
+
+    vfs_init ();
+    vfs_init_localfs ();
+    vfs_setup_work_dir ();
+
+    test_dir = g_dir_make_tmp ("mc-test-dir-XXXXXX", NULL);
+    mctest_assert_not_null (test_dir);
+
+    // sizes differ from name order
+    test_write_file ("a", "a");
+    test_write_file ("c", "ccccccc");
+    test_write_file ("e", "eee");
+    test_write_file ("g", "ggggg");
+
+    vpath = vfs_path_build_filename (test_dir, "dir", (char *) NULL);
+    ck_assert_int_eq (mc_mkdir (vpath, 0700), 0);
+    vfs_path_free (vpath, TRUE);
+
+    // names of changed entries are relative to the current directory
+    vpath = vfs_path_from_str (test_dir);
+    ck_assert_int_eq (mc_chdir (vpath), 0);
+    vfs_path_free (vpath, TRUE);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    const char *names[] = { "a", "b", "c", "e", "f", "g", "dir" };
+    size_t i;
+
+    for (i = 0; i < G_N_ELEMENTS (names); i++)
+        test_remove_file (names[i]);
+    g_rmdir (test_dir);
+    MC_PTR_FREE (test_dir);
+
+    vfs_shut ();
+    str_uninit_strings ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_dir_list_update_ds") */
+static const struct test_dir_list_update_ds
+{
+    GCompareFunc sort;
+    gboolean reverse;
+    const char *before[TEST_ENTRIES_MAX];
+    const char *after[TEST_ENTRIES_MAX];
+} test_dir_list_update_ds[] = {
+    {
+        // 0. by name
+        (GCompareFunc) sort_name,
+        FALSE,
+        { "..", "dir", "a", "c", "e", "g", NULL },
+        { "..", "dir", "a", "b", "e", "f", "g", NULL },
+    },
+    {
+        // 1. by size: changed entry moves, new entries of the same size are sorted by name
+        (GCompareFunc) sort_size,
+        FALSE,
+        { "..", "dir", "a", "e", "g", "c", NULL },
+        { "..", "dir", "a", "b", "f", "g", "e", NULL },
+    },
+    {
+        // 2. by size in reverse order: directories and ".." stay first
+        (GCompareFunc) sort_size,
+        TRUE,
+        { "..", "dir", "c", "g", "e", "a", NULL },
+        { "..", "dir", "e", "g", "f", "b", "a", NULL },
+    },
+};
+
+/* @Test(dataSource = "test_dir_list_update_ds") */
+START_PARAMETRIZED_TEST (test_dir_list_update, test_dir_list_update_ds)
+{
+    // given
+    dir_list list = { NULL, 0, 0, NULL, FALSE };
+    dir_sort_options_t sort_op = { FALSE, TRUE, FALSE };
+    vfs_path_t *vpath;
+    GHashTable *names;
+    file_entry_t *fentry;
+    const char *name_key, *ext_key;
+    gboolean ok;
+    int i;
+
+    sort_op.reverse = data->reverse;
+
+    vpath = vfs_path_from_str (test_dir);
+    ok = dir_list_load (&list, vpath, data->sort, &sort_op, NULL);
+    vfs_path_free (vpath, TRUE);
+    ck_assert (ok);
+
+    for (i = 0; data->before[i] != NULL; i++)
+        mctest_assert_str_eq (list.list[i].fname->str, data->before[i]);
+    ck_assert_int_eq (list.len, i);
+
+    // marked files: "c" is deleted, "e" is changed, "g" is not changed
+    test_find_entry (&list, "c")->f.marked = 1;
+    test_find_entry (&list, "g")->f.marked = 1;
+    fentry = test_find_entry (&list, "e");
+    fentry->f.marked = 1;
+
+    // sort keys are created on demand: make sure the changed entry has them
+    if (fentry->name_sort_key == NULL)
+        fentry->name_sort_key = str_create_key_for_filename (fentry->fname->str, TRUE);
+    if (fentry->extension_sort_key == NULL)
+        fentry->extension_sort_key = str_create_key ("", TRUE);
+    name_key = fentry->name_sort_key;
+    ext_key = fentry->extension_sort_key;
+
+    test_remove_file ("c");
+    test_write_file ("b", "bbbb");
+    test_write_file ("e", "eeeeeeeeee");
+    test_write_file ("f", "ffff");
+
+    names = g_hash_table_new (g_str_hash, g_str_equal);
+    g_hash_table_add (names, (gpointer) "b");
+    g_hash_table_add (names, (gpointer) "c");
+    g_hash_table_add (names, (gpointer) "e");
+    g_hash_table_add (names, (gpointer) "f");
+    // created and deleted before it was read
+    g_hash_table_add (names, (gpointer) "x");
+
+    // when
+    ok = dir_list_update (&list, names, data->sort, &sort_op, NULL);
+
+    // then
+    ck_assert (ok);
+
+    for (i = 0; data->after[i] != NULL; i++)
+        mctest_assert_str_eq (list.list[i].fname->str, data->after[i]);
+    ck_assert_int_eq (list.len, i);
+
+    for (i = 0; i < list.len; i++)
+    {
+        const char *name = list.list[i].fname->str;
+        const gboolean marked = strcmp (name, "e") == 0 || strcmp (name, "g") == 0;
+
+        ck_assert_msg (list.list[i].f.marked == (marked ? 1 : 0), "wrong mark of %s", name);
+    }
+
+    fentry = test_find_entry (&list, "e");
+    ck_assert_int_eq (fentry->st.st_size, 10);
+    ck_assert (fentry->name_sort_key == name_key);
+    ck_assert (fentry->extension_sort_key == ext_key);
+
+    g_hash_table_destroy (names);
+    dir_list_free_list (&list);
+}
+END_PARAMETRIZED_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    TCase *tc_core;
+
+    tc_core = tcase_create ("Core");
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    // Add new tests here: ***************
+    mctest_add_parameterized_test (tc_core, test_dir_list_update, test_dir_list_update_ds);
+    // ***********************************
+
+    return mctest_run_all (tc_core);
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,199 @@
+/*
+   src/filemanager - tests for computing of local directory size
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/filemanager"
+
+#include "tests/mctest.h"
+
+#include <stdio.h>
+#include <unistd.h>  // sleep()
+
+#include "lib/strutil.h"
+#include "lib/util.h"
+#include "src/vfs/local/local.h"
+
+#include "src/filemanager/dirsize.c"
+
+static char *test_dir = NULL;
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+test_write_file (const char *name, const char *content, const char *mode)
+{
+    char *path;
+    FILE *f;
+
+    path = g_build_filename (test_dir, name, (char *) NULL);
+    f = fopen (path, mode);
+    mctest_assert_not_null (f);
+    ck_assert_int_ge (fputs (content, f), 0);
+    fclose (f);
+    g_free (path);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    char *path;
+
+    str_init_strings (NULL);
+
+    vfs_init ();
+    vfs_init_localfs ();
+    vfs_setup_work_dir ();
+
+    test_dir = g_dir_make_tmp ("mc-test-dirsize-XXXXXX", NULL);
+    mctest_assert_not_null (test_dir);
+
+    path = g_build_filename (test_dir, "a", "b", "c", (char *) NULL);
+    ck_assert_int_eq (g_mkdir_with_parents (path, 0700), 0);
+    g_free (path);
+
+    test_write_file ("top", "12345", "w");
+    test_write_file ("a/b/file", "123", "w");
+    test_write_file ("a/b/c/deep", "1234567", "w");
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    const char *names[] = { "a/b/c/deep", "a/b/file", "top", "a/b/c", "a/b", "a" };
+    size_t i;
+
+    for (i = 0; i < G_N_ELEMENTS (names); i++)
+    {
+        char *path;
+
+        path = g_build_filename (test_dir, names[i], (char *) NULL);
+        remove (path);
+        g_free (path);
+    }
+
+    g_rmdir (test_dir);
+    MC_PTR_FREE (test_dir);
+
+    vfs_shut ();
+    str_uninit_strings ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+#ifdef DIRSIZE_LOCAL_WALK
+static void
+test_compute (size_t *dir_count, size_t *count, uintmax_t *size)
+{
+    dirsize_status_msg_t dsm;
+    vfs_path_t *vpath;
+    FileProgressStatus status = FILE_ABORT;
+    gboolean ok;
+
+    memset (&dsm, 0, sizeof (dsm));
+
+    *dir_count = 0;
+    *count = 0;
+    *size = 0;
+
+    vpath = vfs_path_from_str (test_dir);
+    ok = dirsize_compute_local (vpath, &dsm, dir_count, count, size, FALSE, &status);
+    vfs_path_free (vpath, TRUE);
+    dirsize_local_done (&dsm);
+
+    ck_assert (ok);
+    ck_assert_int_eq (status, FILE_CONT);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Test */
+START_TEST (test_dirsize_compute_local)
+{
+    // given
+    size_t dir_count, count;
+    uintmax_t size;
+
+    // when
+    test_compute (&dir_count, &count, &size);
+
+    // then
+    ck_assert_int_eq (dir_count, 4);
+    ck_assert_int_eq (count, 3);
+    ck_assert_int_eq (size, 5 + 3 + 7);
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Test */
+START_TEST (test_dirsize_compute_local_nested_change)
+{
+    // given
+    size_t dir_count, count;
+    uintmax_t size;
+
+    // let times of directories settle, so a result validated by them would be reused
+    sleep (2);
+
+    test_compute (&dir_count, &count, &size);
+    ck_assert_int_eq (size, 5 + 3 + 7);
+
+    // when
+    // file deep in the tree grows in place: times of directories are not changed
+    test_write_file ("a/b/c/deep", "890", "a");
+    test_compute (&dir_count, &count, &size);
+
+    // then
+    ck_assert_int_eq (dir_count, 4);
+    ck_assert_int_eq (count, 3);
+    ck_assert_int_eq (size, 5 + 3 + 10);
+}
+END_TEST
+#endif
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    TCase *tc_core;
+
+    tc_core = tcase_create ("Core");
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    // Add new tests here: ***************
+#ifdef DIRSIZE_LOCAL_WALK
+    tcase_add_test (tc_core, test_dirsize_compute_local);
+    tcase_add_test (tc_core, test_dirsize_compute_local_nested_change);
+#endif
+    // ***********************************
+
+    return mctest_run_all (tc_core);
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,225 @@
+/*
+   src/filemanager - tests for tree store
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/filemanager"
+
+#include "tests/mctest.h"
+
+#include "lib/strutil.h"
+#include "lib/vfs/vfs.h"
+#include "src/vfs/local/local.h"
+
+#include "src/filemanager/treestore.c"
+
+/* --------------------------------------------------------------------------------------------- */
+
+static tree_entry *
+test_add (const char *name)
+{
+    vfs_path_t *vpath;
+    tree_entry *entry;
+
+    vpath = vfs_path_from_str (name);
+    entry = tree_store_add_entry (vpath);
+    vfs_path_free (vpath, TRUE);
+
+    return entry;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static tree_entry *
+test_whereis (const char *name)
+{
+    vfs_path_t *vpath;
+    tree_entry *entry;
+
+    vpath = vfs_path_from_str (name);
+    entry = tree_store_whereis (vpath);
+    vfs_path_free (vpath, TRUE);
+
+    return entry;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+test_remove (const char *name)
+{
+    vfs_path_t *vpath;
+
+    vpath = vfs_path_from_str (name);
+    tree_store_remove_entry (vpath);
+    vfs_path_free (vpath, TRUE);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    str_init_strings (NULL);
+
+    vfs_init ();
+    vfs_init_localfs ();
+    vfs_setup_work_dir ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    tree_store_done ();
+
+    vfs_shut ();
+    str_uninit_strings ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Test */
+START_TEST (test_tree_store_index)
+{
+    // given
+    const char *names[] = { "/usr/share", "/usr", "/tmp", "/usr/lib", "/usr/share/doc", "/usr.old" };
+    const char *order[] = { "/tmp", "/usr", "/usr/lib", "/usr/share", "/usr/share/doc", "/usr.old" };
+    tree_entry *entries[G_N_ELEMENTS (names)];
+    tree_entry *current;
+    size_t i;
+
+    // when
+    for (i = 0; i < G_N_ELEMENTS (names); i++)
+        entries[i] = test_add (names[i]);
+
+    // then
+    // existing entry is found and not added again
+    mctest_assert_ptr_eq (test_add ("/usr"), entries[1]);
+
+    for (i = 0; i < G_N_ELEMENTS (names); i++)
+        mctest_assert_ptr_eq (test_whereis (names[i]), entries[i]);
+    mctest_assert_null (test_whereis ("/usr/share/man"));
+    mctest_assert_null (test_whereis ("/us"));
+
+    // index and list are in the same order
+    for (i = 0, current = ts.tree_first; current != NULL; i++, current = current->next)
+    {
+        ck_assert_int_lt (i, G_N_ELEMENTS (order));
+        mctest_assert_str_eq (vfs_path_as_str (current->name), order[i]);
+        mctest_assert_ptr_eq (g_sequence_get (current->index), current);
+    }
+    ck_assert_int_eq (i, G_N_ELEMENTS (order));
+    ck_assert_int_eq (g_sequence_get_length (ts.index), G_N_ELEMENTS (order));
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Test */
+START_TEST (test_tree_store_index_remove)
+{
+    // given
+    const char *names[] = { "/tmp", "/usr", "/usr/lib", "/usr/share", "/usr/share/doc", "/usr.old" };
+    size_t i;
+
+    for (i = 0; i < G_N_ELEMENTS (names); i++)
+        test_add (names[i]);
+
+    // when
+    // subdirectories are removed with their parent, "/usr.old" is not a subdirectory of "/usr"
+    test_remove ("/usr/share");
+
+    // then
+    mctest_assert_null (test_whereis ("/usr/share"));
+    mctest_assert_null (test_whereis ("/usr/share/doc"));
+    mctest_assert_not_null (test_whereis ("/usr/lib"));
+    mctest_assert_not_null (test_whereis ("/usr.old"));
+    ck_assert_int_eq (g_sequence_get_length (ts.index), 4);
+
+    // when
+    test_remove ("/usr");
+
+    // then
+    mctest_assert_null (test_whereis ("/usr"));
+    mctest_assert_null (test_whereis ("/usr/lib"));
+    mctest_assert_not_null (test_whereis ("/tmp"));
+    mctest_assert_not_null (test_whereis ("/usr.old"));
+    ck_assert_int_eq (g_sequence_get_length (ts.index), 2);
+
+    // when
+    // removed entry can be added again at its place
+    test_add ("/usr/lib");
+
+    // then
+    mctest_assert_str_eq (vfs_path_as_str (ts.tree_first->next->name), "/usr/lib");
+    mctest_assert_ptr_eq (test_whereis ("/usr/lib"), ts.tree_first->next);
+    ck_assert_int_eq (g_sequence_get_length (ts.index), 3);
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Test */
+START_TEST (test_tree_store_done)
+{
+    // given
+    test_add ("/tmp");
+    test_add ("/usr");
+
+    // when
+    tree_store_done ();
+
+    // then
+    mctest_assert_null (ts.tree_first);
+    mctest_assert_null (ts.tree_last);
+    mctest_assert_null (ts.index);
+    mctest_assert_null (test_whereis ("/tmp"));
+
+    // store can be filled again
+    mctest_assert_not_null (test_add ("/usr"));
+    mctest_assert_not_null (test_whereis ("/usr"));
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    TCase *tc_core;
+
+    tc_core = tcase_create ("Core");
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    // Add new tests here: ***************
+    tcase_add_test (tc_core, test_tree_store_index);
+    tcase_add_test (tc_core, test_tree_store_index_remove);
+    tcase_add_test (tc_core, test_tree_store_done);
+    // ***********************************
+
+    return mctest_run_all (tc_core);
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,468 @@
+/*
+   src/vfs/extfs - tests for cache of archive listings
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/vfs/extfs"
+
+#include "tests/mctest.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "lib/strutil.h"
+#include "lib/util.h"
+#include "src/vfs/local/local.h"
+
+#include "src/vfs/extfs/extfs.c"
+
+#define TEST_PREFIX "mctest"
+
+/* listing depends on time of archive and helper: it must be older than one second to be cached */
+#define TEST_MTIME  (time (NULL) - 100)
+
+/* what is changed in archive or helper after listing is cached */
+typedef enum
+{
+    TEST_CHANGE_ARCHIVE_SIZE,
+    TEST_CHANGE_ARCHIVE_MTIME,
+    TEST_CHANGE_HELPER_SIZE,
+    TEST_CHANGE_HELPER_MTIME
+} test_change_t;
+
+static char *test_dir = NULL;
+static char *test_archive = NULL;
+static char *test_helper = NULL;
+static char *test_runs = NULL;
+static int test_fstype = -1;
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* file is rewritten in place: i-node of archive is a part of cache key too */
+static void
+test_write_file (const char *path, const char *content, time_t mtime)
+{
+    FILE *f;
+    struct utimbuf times;
+
+    f = fopen (path, "w");
+    mctest_assert_not_null (f);
+    ck_assert_int_ge (fputs (content, f), 0);
+    fclose (f);
+
+    times.actime = mtime;
+    times.modtime = mtime;
+    ck_assert_int_eq (utime (path, &times), 0);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* helper counts its runs and exits with the status taken from environment */
+static void
+test_write_helper (const char *comment, time_t mtime)
+{
+    char *script;
+
+    script = g_strdup_printf ("#!/bin/sh\n"
+                              "# %s\n"
+                              "echo run >> '%s'\n"
+                              "echo '-rw-r--r-- 1 user group 5 Jan  2  2024 file.txt'\n"
+                              "echo 'drwxr-xr-x 1 user group 0 Jan  2  2024 dir'\n"
+                              "exit ${MCTEST_EXTFS_STATUS:-0}\n",
+                              comment, test_runs);
+    test_write_file (test_helper, script, mtime);
+    g_free (script);
+
+    ck_assert_int_eq (chmod (test_helper, 0700), 0);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static int
+test_get_runs (void)
+{
+    char *contents;
+    int runs = 0;
+    char *p;
+
+    if (!g_file_get_contents (test_runs, &contents, NULL, NULL))
+        return 0;
+
+    for (p = contents; *p != '\0'; p++)
+        if (*p == '\n')
+            runs++;
+
+    g_free (contents);
+
+    return runs;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static char *
+test_get_cache_path (void)
+{
+    const extfs_plugin_info_t *info;
+
+    info = &g_array_index (extfs_plugins, extfs_plugin_info_t, test_fstype);
+
+    return extfs_cache_get_path (info, test_archive);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* read the archive and check its contents */
+static void
+test_read_archive (void)
+{
+    struct extfs_super_t *archive = NULL;
+    struct vfs_s_entry *entry;
+    // names are changed temporarily during the search
+    char file_name[] = "file.txt";
+    char dir_name[] = "dir";
+
+    ck_assert_int_eq (extfs_open_and_read_archive (test_fstype, test_archive, &archive), 0);
+    mctest_assert_not_null (archive);
+
+    entry = extfs_find_entry (VFS_SUPER (archive)->root, file_name, FL_NONE);
+    mctest_assert_not_null (entry);
+    ck_assert (S_ISREG (entry->ino->st.st_mode));
+    ck_assert_int_eq (entry->ino->st.st_size, 5);
+
+    entry = extfs_find_entry (VFS_SUPER (archive)->root, dir_name, FL_NONE);
+    mctest_assert_not_null (entry);
+    ck_assert (S_ISDIR (entry->ino->st.st_mode));
+
+    VFS_SUPER (archive)->me->free (VFS_SUPER (archive));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+test_remove_tree (const char *path)
+{
+    GDir *dir;
+
+    dir = g_dir_open (path, 0, NULL);
+    if (dir != NULL)
+    {
+        const char *name;
+
+        while ((name = g_dir_read_name (dir)) != NULL)
+        {
+            char *p;
+
+            p = g_build_filename (path, name, (char *) NULL);
+            test_remove_tree (p);
+            g_free (p);
+        }
+
+        g_dir_close (dir);
+    }
+
+    remove (path);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    char *dir;
+
+    test_dir = g_dir_make_tmp ("mc-test-extfs-XXXXXX", NULL);
+    mctest_assert_not_null (test_dir);
+
+    // helper is found in user data directory, listings are cached in user cache directory
+    dir = g_build_filename (test_dir, "data", (char *) NULL);
+    g_setenv ("XDG_DATA_HOME", dir, TRUE);
+    g_free (dir);
+    dir = g_build_filename (test_dir, "cache", (char *) NULL);
+    g_setenv ("XDG_CACHE_HOME", dir, TRUE);
+    g_free (dir);
+    g_unsetenv ("MC_PROFILE_ROOT");
+    g_unsetenv ("MCTEST_EXTFS_STATUS");
+
+    dir = g_build_filename (test_dir, "data", MC_USERCONF_DIR, MC_EXTFS_DIR, (char *) NULL);
+    ck_assert_int_eq (g_mkdir_with_parents (dir, 0700), 0);
+    test_helper = g_build_filename (dir, TEST_PREFIX, (char *) NULL);
+    g_free (dir);
+
+    test_runs = g_build_filename (test_dir, "runs", (char *) NULL);
+    test_write_helper ("helper", TEST_MTIME);
+
+    test_archive = g_build_filename (test_dir, "archive." TEST_PREFIX, (char *) NULL);
+    test_write_file (test_archive, "archive", TEST_MTIME);
+
+    str_init_strings (NULL);
+
+    vfs_init ();
+    vfs_init_localfs ();
+    vfs_init_extfs ();
+    vfs_setup_work_dir ();
+
+    test_fstype = extfs_which (vfs_extfs_ops, TEST_PREFIX);
+    ck_assert_int_ge (test_fstype, 0);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    vfs_shut ();
+    str_uninit_strings ();
+    mc_config_deinit_config_paths ();
+
+    test_remove_tree (test_dir);
+    MC_PTR_FREE (test_dir);
+    MC_PTR_FREE (test_archive);
+    MC_PTR_FREE (test_helper);
+    MC_PTR_FREE (test_runs);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Test */
+START_TEST (test_extfs_cache_hit)
+{
+    // given
+    char *cache_path;
+
+    test_read_archive ();
+    ck_assert_int_eq (test_get_runs (), 1);
+
+    cache_path = test_get_cache_path ();
+    ck_assert (g_file_test (cache_path, G_FILE_TEST_IS_REGULAR));
+
+    // when
+    test_read_archive ();
+
+    // then
+    // listing is taken from cache: helper is not run again
+    ck_assert_int_eq (test_get_runs (), 1);
+    ck_assert (g_file_test (cache_path, G_FILE_TEST_IS_REGULAR));
+
+    g_free (cache_path);
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_extfs_cache_invalidate_ds") */
+static const struct test_extfs_cache_invalidate_ds
+{
+    test_change_t change;
+} test_extfs_cache_invalidate_ds[] = {
+    { TEST_CHANGE_ARCHIVE_SIZE },
+    { TEST_CHANGE_ARCHIVE_MTIME },
+    { TEST_CHANGE_HELPER_SIZE },
+    { TEST_CHANGE_HELPER_MTIME },
+};
+
+/* @Test(dataSource = "test_extfs_cache_invalidate_ds") */
+START_PARAMETRIZED_TEST (test_extfs_cache_invalidate, test_extfs_cache_invalidate_ds)
+{
+    // given
+    struct stat st;
+
+    test_read_archive ();
+    test_read_archive ();
+    ck_assert_int_eq (test_get_runs (), 1);
+
+    // changed file keeps its other attributes
+    if (data->change == TEST_CHANGE_ARCHIVE_SIZE || data->change == TEST_CHANGE_ARCHIVE_MTIME)
+        ck_assert_int_eq (stat (test_archive, &st), 0);
+    else
+        ck_assert_int_eq (stat (test_helper, &st), 0);
+
+    switch (data->change)
+    {
+    case TEST_CHANGE_ARCHIVE_SIZE:
+        test_write_file (test_archive, "changed archive", st.st_mtime);
+        break;
+    case TEST_CHANGE_ARCHIVE_MTIME:
+        test_write_file (test_archive, "archive", st.st_mtime - 10);
+        break;
+    case TEST_CHANGE_HELPER_SIZE:
+        test_write_helper ("changed helper", st.st_mtime);
+        break;
+    case TEST_CHANGE_HELPER_MTIME:
+        test_write_helper ("helper", st.st_mtime - 10);
+        break;
+    default:
+        break;
+    }
+
+    // when
+    test_read_archive ();
+
+    // then
+    // changed archive or helper is read again
+    ck_assert_int_eq (test_get_runs (), 2);
+
+    // when
+    test_read_archive ();
+
+    // then
+    // and its listing replaces the old one in cache
+    ck_assert_int_eq (test_get_runs (), 2);
+}
+END_PARAMETRIZED_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Test */
+START_TEST (test_extfs_cache_helper_failed)
+{
+    // given
+    char *cache_path;
+
+    // listing is read, but helper reports an error
+    g_setenv ("MCTEST_EXTFS_STATUS", "1", TRUE);
+
+    // when
+    test_read_archive ();
+
+    // then
+    cache_path = test_get_cache_path ();
+    ck_assert (!g_file_test (cache_path, G_FILE_TEST_EXISTS));
+
+    // when
+    g_unsetenv ("MCTEST_EXTFS_STATUS");
+    test_read_archive ();
+
+    // then
+    ck_assert_int_eq (test_get_runs (), 2);
+    ck_assert (g_file_test (cache_path, G_FILE_TEST_IS_REGULAR));
+
+    g_free (cache_path);
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_extfs_cache_trim_ds") */
+static const struct test_extfs_cache_trim_ds
+{
+    int files;
+    off_t size;
+    int expected_files;
+} test_extfs_cache_trim_ds[] = {
+    {
+        // 0. nothing to remove
+        EXTFS_CACHE_MAX_FILES,
+        1,
+        EXTFS_CACHE_MAX_FILES,
+    },
+    {
+        // 1. too many files
+        EXTFS_CACHE_MAX_FILES + 44,
+        1,
+        EXTFS_CACHE_MAX_FILES,
+    },
+    {
+        // 2. too big files: sparse files don't take disk space
+        5,
+        EXTFS_CACHE_MAX_SIZE / 3,
+        3,
+    },
+};
+
+/* @Test(dataSource = "test_extfs_cache_trim_ds") */
+START_PARAMETRIZED_TEST (test_extfs_cache_trim, test_extfs_cache_trim_ds)
+{
+    // given
+    char *dir;
+    const time_t now = time (NULL);
+    int i;
+
+    dir = g_build_filename (test_dir, "trim", (char *) NULL);
+    ck_assert_int_eq (g_mkdir_with_parents (dir, 0700), 0);
+
+    // file i was used i seconds ago
+    for (i = 0; i < data->files; i++)
+    {
+        char name[32];
+        char *path;
+        struct utimbuf times;
+        int fd;
+
+        g_snprintf (name, sizeof (name), "%d", i);
+        path = g_build_filename (dir, name, (char *) NULL);
+
+        fd = open (path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+        ck_assert_int_ge (fd, 0);
+        ck_assert_int_eq (ftruncate (fd, data->size), 0);
+        close (fd);
+
+        times.actime = now - i;
+        times.modtime = now - i;
+        ck_assert_int_eq (utime (path, &times), 0);
+
+        g_free (path);
+    }
+
+    // when
+    extfs_cache_trim (dir);
+
+    // then
+    // least recently used files are removed
+    for (i = 0; i < data->files; i++)
+    {
+        char name[32];
+        char *path;
+
+        g_snprintf (name, sizeof (name), "%d", i);
+        path = g_build_filename (dir, name, (char *) NULL);
+        ck_assert_msg (g_file_test (path, G_FILE_TEST_EXISTS) == (i < data->expected_files),
+                       "wrong state of file %d", i);
+        g_free (path);
+    }
+
+    g_free (dir);
+}
+END_PARAMETRIZED_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    TCase *tc_core;
+
+    tc_core = tcase_create ("Core");
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    // Add new tests here: ***************
+    tcase_add_test (tc_core, test_extfs_cache_hit);
+    mctest_add_parameterized_test (tc_core, test_extfs_cache_invalidate,
+                                   test_extfs_cache_invalidate_ds);
+    tcase_add_test (tc_core, test_extfs_cache_helper_failed);
+    mctest_add_parameterized_test (tc_core, test_extfs_cache_trim, test_extfs_cache_trim_ds);
+    // ***********************************
+
+    return mctest_run_all (tc_core);
+}
+
+/* --------------------------------------------------------------------------------------------- */
@@ -0,0 +1,597 @@
+/*
+   src/vfs/zip - tests for reading of zip archives
+
+   Copyright (C) 2026
+   Free Software Foundation, Inc.
+
+   This file is part of the Midnight Commander.
+
+   The Midnight Commander is free software: you can redistribute it
+   and/or modify it under the terms of the GNU General Public License as
+   published by the Free Software Foundation, either version 3 of the License,
+   or (at your option) any later version.
+
+   The Midnight Commander is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define TEST_SUITE_NAME "/src/vfs/zip"
+
+#include "tests/mctest.h"
+
+#include <fcntl.h>
+#include <inttypes.h>  // PRIdMAX
+#include <unistd.h>
+
+#include "lib/strutil.h"
+#include "lib/util.h"
+#include "src/vfs/local/local.h"
+
+#include "src/vfs/zip/zip.c"
+
+/* archives are written by test: one zip writer is simpler than binary fixtures for each case */
+#define TEST_ZIP64    (1 << 0)  // ZIP64 end records and extra fields
+#define TEST_PREPEND  (1 << 1)  // data before archive, offsets are relative to archive itself
+#define TEST_BIG_SIZE (3 * ZIP_SPAN_MIN + 12345)
+
+#define TEST_MTIME    1700000000
+
+/* member of test archive */
+typedef struct
+{
+    const char *name;
+    guint16 method;
+    mode_t mode;  // 0 for MS-DOS attributes
+    const char *data;
+    gboolean timestamp;  // add modification time in extra field
+} test_member_t;
+
+static char *test_dir = NULL;
+static char *test_deflated_data = NULL;
+static char *test_big_data = NULL;
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+test_put16 (GByteArray *a, guint16 v)
+{
+    const guint8 b[2] = { v & 0xff, v >> 8 };
+
+    g_byte_array_append (a, b, sizeof (b));
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+test_put32 (GByteArray *a, guint32 v)
+{
+    test_put16 (a, v & 0xffff);
+    test_put16 (a, v >> 16);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+test_put64 (GByteArray *a, guint64 v)
+{
+    test_put32 (a, v & 0xffffffff);
+    test_put32 (a, v >> 32);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static GByteArray *
+test_deflate (const char *data, size_t len)
+{
+    GByteArray *out;
+    z_stream zs;
+    int ret;
+
+    memset (&zs, 0, sizeof (zs));
+    ret = deflateInit2 (&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+    ck_assert_int_eq (ret, Z_OK);
+
+    out = g_byte_array_sized_new (deflateBound (&zs, len));
+    g_byte_array_set_size (out, deflateBound (&zs, len));
+
+    zs.next_in = (Bytef *) data;
+    zs.avail_in = len;
+    zs.next_out = out->data;
+    zs.avail_out = out->len;
+    ret = deflate (&zs, Z_FINISH);
+    ck_assert_int_eq (ret, Z_STREAM_END);
+
+    g_byte_array_set_size (out, zs.total_out);
+    deflateEnd (&zs);
+
+    return out;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+test_put_header (GByteArray *a, const test_member_t *m, guint32 crc, guint64 csize, guint64 usize,
+                 guint64 offset, int flags, gboolean central)
+{
+    const gboolean zip64 = (flags & TEST_ZIP64) != 0;
+    const size_t name_len = strlen (m->name);
+    guint16 extra_len = 0;
+
+    if (zip64)
+        extra_len += 4 + (central ? 24 : 16);
+    if (m->timestamp)
+        extra_len += 4 + 5;
+
+    test_put32 (a, central ? ZIP_CENTRAL_SIG : ZIP_LOCAL_SIG);
+    if (central)
+        test_put16 (a, (ZIP_HOST_UNIX << 8) | 45);  // version made by
+    test_put16 (a, zip64 ? 45 : 20);                // version needed to extract
+    test_put16 (a, 0);                              // flags
+    test_put16 (a, m->method);
+    // 2024-02-03 04:05:06
+    test_put16 (a, (4 << 11) | (5 << 5) | 3);
+    test_put16 (a, ((2024 - 1980) << 9) | (2 << 5) | 3);
+    test_put32 (a, crc);
+    test_put32 (a, zip64 ? ZIP64_MARK : (guint32) csize);
+    test_put32 (a, zip64 ? ZIP64_MARK : (guint32) usize);
+    test_put16 (a, (guint16) name_len);
+    test_put16 (a, extra_len);
+
+    if (central)
+    {
+        test_put16 (a, 0);  // comment length
+        test_put16 (a, 0);  // disk number
+        test_put16 (a, 0);  // internal attributes
+        test_put32 (a, (guint32) m->mode << 16);
+        test_put32 (a, zip64 ? ZIP64_MARK : (guint32) offset);
+    }
+
+    g_byte_array_append (a, (const guint8 *) m->name, name_len);
+
+    if (zip64)
+    {
+        test_put16 (a, ZIP_EXTRA_ZIP64);
+        test_put16 (a, central ? 24 : 16);
+        test_put64 (a, usize);
+        test_put64 (a, csize);
+        if (central)
+            test_put64 (a, offset);
+    }
+
+    if (m->timestamp)
+    {
+        test_put16 (a, ZIP_EXTRA_TIMESTAMP);
+        test_put16 (a, 5);
+        g_byte_array_append (a, (const guint8 *) "\x01", 1);
+        test_put32 (a, TEST_MTIME);
+    }
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+test_put_end (GByteArray *a, guint n, guint64 cd_offset, guint64 cd_size, int flags)
+{
+    const gboolean zip64 = (flags & TEST_ZIP64) != 0;
+
+    if (zip64)
+    {
+        const guint64 eocd64_offset = a->len;
+
+        test_put32 (a, ZIP64_EOCD_SIG);
+        test_put64 (a, ZIP64_EOCD_SIZE - 12);
+        test_put16 (a, (ZIP_HOST_UNIX << 8) | 45);
+        test_put16 (a, 45);
+        test_put32 (a, 0);  // number of this disk
+        test_put32 (a, 0);  // disk with central directory
+        test_put64 (a, n);
+        test_put64 (a, n);
+        test_put64 (a, cd_size);
+        test_put64 (a, cd_offset);
+
+        test_put32 (a, ZIP64_LOCATOR_SIG);
+        test_put32 (a, 0);
+        test_put64 (a, eocd64_offset);
+        test_put32 (a, 1);  // total number of disks
+    }
+
+    test_put32 (a, ZIP_EOCD_SIG);
+    test_put16 (a, 0);
+    test_put16 (a, 0);
+    test_put16 (a, zip64 ? 0xffff : n);
+    test_put16 (a, zip64 ? 0xffff : n);
+    test_put32 (a, zip64 ? ZIP64_MARK : (guint32) cd_size);
+    test_put32 (a, zip64 ? ZIP64_MARK : (guint32) cd_offset);
+    // end record is searched before comment
+    test_put16 (a, 15);
+    g_byte_array_append (a, (const guint8 *) "archive comment", 15);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+test_write_zip (const char *name, const test_member_t *members, guint n, int flags)
+{
+    GByteArray *a, *cd;
+    guint64 *offsets, *csizes;
+    guint32 *crcs;
+    guint i;
+    char *path;
+    GByteArray *file;
+
+    a = g_byte_array_new ();
+    cd = g_byte_array_new ();
+    offsets = g_new (guint64, n);
+    csizes = g_new (guint64, n);
+    crcs = g_new (guint32, n);
+
+    for (i = 0; i < n; i++)
+    {
+        const test_member_t *m = &members[i];
+        const size_t len = strlen (m->data);
+        GByteArray *data;
+
+        if (m->method == ZIP_METHOD_DEFLATED)
+            data = test_deflate (m->data, len);
+        else
+        {
+            data = g_byte_array_new ();
+            g_byte_array_append (data, (const guint8 *) m->data, len);
+        }
+
+        offsets[i] = a->len;
+        csizes[i] = data->len;
+        crcs[i] = crc32 (0, (const Bytef *) m->data, len);
+
+        test_put_header (a, m, crcs[i], csizes[i], len, offsets[i], flags, FALSE);
+        g_byte_array_append (a, data->data, data->len);
+        g_byte_array_free (data, TRUE);
+    }
+
+    for (i = 0; i < n; i++)
+        test_put_header (cd, &members[i], crcs[i], csizes[i], strlen (members[i].data), offsets[i],
+                         flags, TRUE);
+
+    file = g_byte_array_new ();
+    if ((flags & TEST_PREPEND) != 0)
+    {
+        // self-extracting archive: stub is not counted in offsets
+        for (i = 0; i < 1000; i++)
+            g_byte_array_append (file, (const guint8 *) "#!/bin/sh\n", 10);
+    }
+
+    g_byte_array_append (a, cd->data, cd->len);
+    test_put_end (a, n, a->len - cd->len, cd->len, flags);
+    g_byte_array_append (file, a->data, a->len);
+
+    path = g_build_filename (test_dir, name, (char *) NULL);
+    ck_assert (g_file_set_contents (path, (const char *) file->data, file->len, NULL));
+
+    g_byte_array_free (file, TRUE);
+    g_byte_array_free (a, TRUE);
+    g_byte_array_free (cd, TRUE);
+    g_free (offsets);
+    g_free (csizes);
+    g_free (crcs);
+    g_free (path);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static vfs_path_t *
+test_vpath (const char *archive, const char *member)
+{
+    vfs_path_t *vpath;
+    char *path;
+
+    path = g_strconcat (test_dir, PATH_SEP_STR, archive, PATH_SEP_STR "zip://", member,
+                        (char *) NULL);
+    vpath = vfs_path_from_str (path);
+    g_free (path);
+
+    return vpath;
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static void
+test_write_archives (void)
+{
+    const test_member_t members[] = {
+        { "dir/", ZIP_METHOD_STORED, S_IFDIR | 0755, "", FALSE },
+        { "dir/stored.txt", ZIP_METHOD_STORED, S_IFREG | 0644, "stored member\n", TRUE },
+        // parent directory has no own entry
+        { "dir/sub/deflated.txt", ZIP_METHOD_DEFLATED, 0, test_deflated_data, FALSE },
+        { "link", ZIP_METHOD_STORED, S_IFLNK | 0777, "dir/stored.txt", FALSE },
+        { "big.bin", ZIP_METHOD_DEFLATED, S_IFREG | 0600, test_big_data, FALSE },
+    };
+
+    test_write_zip ("plain.zip", members, G_N_ELEMENTS (members), 0);
+    test_write_zip ("zip64.zip", members, G_N_ELEMENTS (members), TEST_ZIP64);
+    test_write_zip ("sfx.zip", members, G_N_ELEMENTS (members), TEST_PREPEND);
+    test_write_zip ("sfx64.zip", members, G_N_ELEMENTS (members), TEST_ZIP64 | TEST_PREPEND);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @Before */
+static void
+setup (void)
+{
+    GString *s;
+    guint32 seed = 1;
+    int i;
+
+    str_init_strings (NULL);
+
+    vfs_init ();
+    vfs_init_localfs ();
+    vfs_init_zipfs ();
+    vfs_setup_work_dir ();
+
+    test_dir = g_dir_make_tmp ("mc-test-zip-XXXXXX", NULL);
+    mctest_assert_not_null (test_dir);
+
+    s = g_string_new ("");
+    for (i = 0; i < 1000; i++)
+        g_string_append_printf (s, "line %d of deflated member\n", i);
+    test_deflated_data = g_string_free (s, FALSE);
+
+    // compressible, but not too much to have many deflate blocks
+    s = g_string_sized_new (TEST_BIG_SIZE);
+    while (s->len < TEST_BIG_SIZE)
+    {
+        static const char *words[] = { "zip ", "vfs ", "inflate ", "window ", "block ",
+                                       "seek ", "member ", "archive\n" };
+
+        seed = seed * 1103515245 + 12345;
+        g_string_append (s, words[(seed >> 16) % G_N_ELEMENTS (words)]);
+    }
+    g_string_truncate (s, TEST_BIG_SIZE);
+    test_big_data = g_string_free (s, FALSE);
+
+    test_write_archives ();
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @After */
+static void
+teardown (void)
+{
+    const char *names[] = { "plain.zip", "zip64.zip", "sfx.zip", "sfx64.zip" };
+    size_t i;
+
+    vfs_shut ();
+    str_uninit_strings ();
+
+    for (i = 0; i < G_N_ELEMENTS (names); i++)
+    {
+        char *path;
+
+        path = g_build_filename (test_dir, names[i], (char *) NULL);
+        unlink (path);
+        g_free (path);
+    }
+
+    g_rmdir (test_dir);
+    MC_PTR_FREE (test_dir);
+    MC_PTR_FREE (test_deflated_data);
+    MC_PTR_FREE (test_big_data);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+static char *
+test_read_member (const char *archive, const char *member, off_t *size)
+{
+    vfs_path_t *vpath;
+    GString *s;
+    int fd;
+    char buf[BUF_8K];
+    ssize_t n;
+
+    vpath = test_vpath (archive, member);
+    fd = mc_open (vpath, O_RDONLY);
+    vfs_path_free (vpath, TRUE);
+    ck_assert_int_ne (fd, -1);
+
+    s = g_string_new ("");
+    while ((n = mc_read (fd, buf, sizeof (buf))) > 0)
+        g_string_append_len (s, buf, n);
+    ck_assert_int_eq (n, 0);
+    mc_close (fd);
+
+    *size = (off_t) s->len;
+    return g_string_free (s, FALSE);
+}
+
+/* --------------------------------------------------------------------------------------------- */
+
+/* @DataSource("test_zip_read_ds") */
+static const struct test_zip_read_ds
+{
+    const char *archive;
+} test_zip_read_ds[] = {
+    {
+        // 0. offsets and sizes in the end record
+        "plain.zip",
+    },
+    {
+        // 1. offsets and sizes in ZIP64 end record and extra fields
+        "zip64.zip",
+    },
+    {
+        // 2. data prepended to archive
+        "sfx.zip",
+    },
+    {
+        // 3. ZIP64 locator points to wrong offset because of prepended data
+        "sfx64.zip",
+    },
+};
+
+/* @Test(dataSource = "test_zip_read_ds") */
+START_PARAMETRIZED_TEST (test_zip_read, test_zip_read_ds)
+{
+    // given
+    vfs_path_t *vpath;
+    struct stat st;
+    char link[MC_MAXPATHLEN];
+    char *content;
+    off_t size;
+    int fd;
+
+    // when
+    vpath = test_vpath (data->archive, "dir");
+
+    // then
+    ck_assert_int_eq (mc_stat (vpath, &st), 0);
+    ck_assert (S_ISDIR (st.st_mode));
+    vfs_path_free (vpath, TRUE);
+
+    // directory without own entry
+    vpath = test_vpath (data->archive, "dir/sub");
+    ck_assert_int_eq (mc_stat (vpath, &st), 0);
+    ck_assert (S_ISDIR (st.st_mode));
+    vfs_path_free (vpath, TRUE);
+
+    // stored member
+    vpath = test_vpath (data->archive, "dir/stored.txt");
+    ck_assert_int_eq (mc_stat (vpath, &st), 0);
+    ck_assert (S_ISREG (st.st_mode));
+    ck_assert_int_eq (st.st_mode & 07777, 0644);
+    ck_assert_int_eq (st.st_size, 14);
+    ck_assert_int_eq (st.st_mtime, TEST_MTIME);
+    vfs_path_free (vpath, TRUE);
+
+    content = test_read_member (data->archive, "dir/stored.txt", &size);
+    ck_assert_int_eq (size, 14);
+    mctest_assert_str_eq (content, "stored member\n");
+    g_free (content);
+
+    // deflated member with MS-DOS attributes
+    vpath = test_vpath (data->archive, "dir/sub/deflated.txt");
+    ck_assert_int_eq (mc_stat (vpath, &st), 0);
+    ck_assert (S_ISREG (st.st_mode));
+    ck_assert_int_eq (st.st_size, (off_t) strlen (test_deflated_data));
+    vfs_path_free (vpath, TRUE);
+
+    content = test_read_member (data->archive, "dir/sub/deflated.txt", &size);
+    ck_assert_int_eq (size, (off_t) strlen (test_deflated_data));
+    mctest_assert_str_eq (content, test_deflated_data);
+    g_free (content);
+
+    // symbolic link
+    vpath = test_vpath (data->archive, "link");
+    ck_assert_int_eq (mc_lstat (vpath, &st), 0);
+    ck_assert (S_ISLNK (st.st_mode));
+    ck_assert_int_eq (mc_readlink (vpath, link, sizeof (link)), 14);
+    ck_assert (strncmp (link, "dir/stored.txt", 14) == 0);
+    vfs_path_free (vpath, TRUE);
+
+    // archive is read-only
+    vpath = test_vpath (data->archive, "dir/stored.txt");
+    fd = mc_open (vpath, O_WRONLY);
+    ck_assert_int_eq (fd, -1);
+    vfs_path_free (vpath, TRUE);
+}
+END_PARAMETRIZED_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+START_TEST (test_zip_seek)
+{
+    // given
+    vfs_path_t *vpath;
+    struct vfs_s_super *super;
+    struct vfs_s_inode *ino;
+    const zip_member_t *m;
+    char *content;
+    off_t size;
+    guint i;
+    int fd;
+
+    // read the whole member to save states of inflater
+    content = test_read_member ("plain.zip", "big.bin", &size);
+    ck_assert_int_eq (size, TEST_BIG_SIZE);
+    ck_assert (memcmp (content, test_big_data, TEST_BIG_SIZE) == 0);
+    g_free (content);
+
+    vpath = test_vpath ("plain.zip", "big.bin");
+    fd = mc_open (vpath, O_RDONLY);
+    vfs_path_free (vpath, TRUE);
+    ck_assert_int_ne (fd, -1);
+
+    super = VFS_SUPER (VFS_SUBCLASS (vfs_zipfs_ops)->supers->data);
+    ino = vfs_s_find_inode (vfs_zipfs_ops, super, "big.bin", LINK_NO_FOLLOW, FL_NONE);
+    mctest_assert_not_null (ino);
+    m = ZIP_MEMBER (ino);
+    mctest_assert_not_null (m->points);
+    ck_assert_int_ge (m->points->len, 2);
+
+    // when
+    // read around every saved state from the end to the start: every seek goes back
+    for (i = m->points->len; i-- != 0;)
+    {
+        const zip_point_t *p = &g_array_index (m->points, zip_point_t, i);
+        const off_t offsets[] = { p->out + 100, p->out - 100, p->out };
+        size_t j;
+
+        ck_assert_int_ge (p->out, ZIP_SPAN_MIN);
+
+        for (j = 0; j < G_N_ELEMENTS (offsets); j++)
+        {
+            char buf[1000];
+
+            // then
+            ck_assert_int_eq (mc_lseek (fd, offsets[j], SEEK_SET), offsets[j]);
+            ck_assert_int_eq (mc_read (fd, buf, sizeof (buf)), sizeof (buf));
+            ck_assert_msg (memcmp (buf, test_big_data + offsets[j], sizeof (buf)) == 0,
+                           "wrong data at offset %" PRIdMAX, (intmax_t) offsets[j]);
+        }
+    }
+
+    // before the first saved state and after the end
+    {
+        char buf[1000];
+
+        ck_assert_int_eq (mc_lseek (fd, 10, SEEK_SET), 10);
+        ck_assert_int_eq (mc_read (fd, buf, sizeof (buf)), sizeof (buf));
+        ck_assert (memcmp (buf, test_big_data + 10, sizeof (buf)) == 0);
+
+        ck_assert_int_eq (mc_lseek (fd, -10, SEEK_END), TEST_BIG_SIZE - 10);
+        ck_assert_int_eq (mc_read (fd, buf, sizeof (buf)), 10);
+        ck_assert (memcmp (buf, test_big_data + TEST_BIG_SIZE - 10, 10) == 0);
+        ck_assert_int_eq (mc_read (fd, buf, sizeof (buf)), 0);
+    }
+
+    mc_close (fd);
+}
+END_TEST
+
+/* --------------------------------------------------------------------------------------------- */
+
+int
+main (void)
+{
+    TCase *tc_core;
+
+    tc_core = tcase_create ("Core");
+
+    tcase_add_checked_fixture (tc_core, setup, teardown);
+
+    // Add new tests here: ***************
+    mctest_add_parameterized_test (tc_core, test_zip_read, test_zip_read_ds);
+    tcase_add_test (tc_core, test_zip_seek);
+    // ***********************************
+
+    return mctest_run_all (tc_core);
+}
+
+/* --------------------------------------------------------------------------------------------- */